@@ -0,0 +1,165 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "a2m_compact.h"
+#include "a2m_v3.h"
+#include "mesh_bounds.h"
+
+static inline uint32_t float_bits(const float value) {
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(float));
+	return bits;
+}
+
+static inline float bits_float(const uint32_t bits) {
+	float value;
+	memcpy(&value, &bits, sizeof(float));
+	return value;
+}
+
+uint16_t float_to_half(const float value) {
+	static const uint32_t f32_infinity = 255u << 23;
+	static const uint32_t f16_max = (127u + 16u) << 23; // first value that rounds to infinity (or is larger)
+	static const uint32_t denorm_magic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+	
+	uint32_t bits = float_bits(value);
+	const uint32_t sign = bits & 0x80000000u;
+	bits ^= sign;
+	
+	uint16_t half;
+	if(bits >= f16_max) {
+		// inf or nan (all nans are mapped to a quiet nan)
+		half = (bits > f32_infinity ? 0x7E00 : 0x7C00);
+	}
+	else if(bits < (113u << 23)) {
+		// (de)normalized half: let the fpu do the rounding by adding a magic value that shifts the mantissa into place
+		half = (uint16_t)(float_bits(bits_float(bits) + bits_float(denorm_magic)) - denorm_magic);
+	}
+	else {
+		// normalized half: rebias the exponent and round the mantissa to nearest even
+		const uint32_t mantissa_odd = (bits >> 13) & 1u;
+		bits += ((uint32_t)(15 - 127) << 23) + 0xFFFu;
+		bits += mantissa_odd;
+		half = (uint16_t)(bits >> 13);
+	}
+	return half | (uint16_t)(sign >> 16);
+}
+
+float half_to_float(const uint16_t value) {
+	static const uint32_t shifted_exponent = 0x7C00u << 13;
+	uint32_t bits = ((uint32_t)value & 0x7FFFu) << 13;
+	const uint32_t exponent = bits & shifted_exponent;
+	bits += (uint32_t)(127 - 15) << 23;
+	
+	if(exponent == shifted_exponent) {
+		// inf/nan
+		bits += (uint32_t)(128 - 16) << 23;
+	}
+	else if(exponent == 0) {
+		// zero/denormal: renormalize
+		bits += 1u << 23;
+		bits = float_bits(bits_float(bits) - bits_float(113u << 23));
+	}
+	return bits_float(bits | (((uint32_t)value & 0x8000u) << 16));
+}
+
+void compute_bounds(const float3* vertices, const size_t count, const bool rotate, float3& bounds_min, float3& bounds_max) {
+	if(count == 0) {
+		bounds_min = float3(0.0f, 0.0f, 0.0f);
+		bounds_max = float3(0.0f, 0.0f, 0.0f);
+		return;
+	}
+	bounds_min = get_stored_vertex(vertices[0], rotate);
+	bounds_max = bounds_min;
+	for(size_t i = 1; i < count; i++) {
+		const float3 vertex = get_stored_vertex(vertices[i], rotate);
+		bounds_min.x = std::min(bounds_min.x, vertex.x);
+		bounds_min.y = std::min(bounds_min.y, vertex.y);
+		bounds_min.z = std::min(bounds_min.z, vertex.z);
+		bounds_max.x = std::max(bounds_max.x, vertex.x);
+		bounds_max.y = std::max(bounds_max.y, vertex.y);
+		bounds_max.z = std::max(bounds_max.z, vertex.z);
+	}
+}
+
+float put_quantized_vertices(a2m_buffer& buffer, const float3* vertices, const size_t count, const bool rotate,
+							 const float3& bounds_min, const float3& bounds_max) {
+	const float bmin[3] { bounds_min.x, bounds_min.y, bounds_min.z };
+	const float extent[3] { bounds_max.x - bounds_min.x, bounds_max.y - bounds_min.y, bounds_max.z - bounds_min.z };
+	float scale[3], step[3];
+	for(unsigned int k = 0; k < 3; k++) {
+		scale[k] = (extent[k] > 0.0f ? 65535.0f / extent[k] : 0.0f);
+		step[k] = extent[k] / 65535.0f;
+	}
+	
+	float max_error = 0.0f;
+	uint16_t quantized[3];
+	for(size_t i = 0; i < count; i++) {
+		const float3 vertex = get_stored_vertex(vertices[i], rotate);
+		const float components[3] { vertex.x, vertex.y, vertex.z };
+		for(unsigned int k = 0; k < 3; k++) {
+			const float q = std::min(std::max((components[k] - bmin[k]) * scale[k] + 0.5f, 0.0f), 65535.0f);
+			quantized[k] = (uint16_t)q;
+			// decode like a loader would
+			const float decoded = bmin[k] + (float)quantized[k] * step[k];
+			max_error = std::max(max_error, fabsf(decoded - components[k]));
+		}
+		buffer.put_block(quantized, sizeof(quantized));
+	}
+	return max_error;
+}
+
+float put_half_coords(a2m_buffer& buffer, const coord* coords, const size_t count) {
+	float max_error = 0.0f;
+	uint16_t halfs[2];
+	for(size_t i = 0; i < count; i++) {
+		halfs[0] = float_to_half(coords[i].u);
+		halfs[1] = float_to_half(coords[i].v);
+		max_error = std::max(max_error, fabsf(half_to_float(halfs[0]) - coords[i].u));
+		max_error = std::max(max_error, fabsf(half_to_float(halfs[1]) - coords[i].v));
+		buffer.put_block(halfs, sizeof(halfs));
+	}
+	return max_error;
+}
+
+void put_compact_indices(a2m_buffer& buffer, const s_index* indices, const size_t triangle_count,
+						 const unsigned int first_index, const unsigned int index_size) {
+	if(index_size == 4) {
+		for(size_t i = 0; i < triangle_count; i++) {
+			const uint32_t local[3] {
+				indices[i].indices[0] - first_index, indices[i].indices[1] - first_index, indices[i].indices[2] - first_index
+			};
+			buffer.put_block(local, sizeof(local));
+		}
+		return;
+	}
+	
+	for(size_t i = 0; i < triangle_count; i++) {
+		const uint16_t local[3] {
+			(uint16_t)(indices[i].indices[0] - first_index),
+			(uint16_t)(indices[i].indices[1] - first_index),
+			(uint16_t)(indices[i].indices[2] - first_index)
+		};
+		buffer.put_block(local, sizeof(local));
+	}
+	// keep the next index block 4 byte aligned
+	if((triangle_count & 1) != 0) {
+		static const uint16_t padding = 0;
+		buffer.put_block(&padding, sizeof(padding));
+	}
+}
@@ -0,0 +1,49 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_A2M_COMPACT_H__
+#define __OBJ2A2M_A2M_COMPACT_H__
+
+#include <a2e.h>
+#include "obj_model.h"
+#include "a2m_writer.h"
+
+// largest vertex/coord count of a sub-object whose (local) indices can be stored with 16 bits
+#define A2M_COMPACT_MAX_INDEX16_COUNT 65536u
+
+// ieee 754 half float conversion (round to nearest even, inf/nan are preserved)
+uint16_t float_to_half(const float value);
+float half_to_float(const uint16_t value);
+
+// computes the aabb of the (optionally rotated) vertices
+void compute_bounds(const float3* vertices, const size_t count, const bool rotate, float3& bounds_min, float3& bounds_max);
+
+// stores the (optionally rotated) vertices as 3 * 16 bit unsigned ints relative to the given aabb:
+// vertex = bounds_min + quantized * (bounds_max - bounds_min) / 65535
+// returns the max error of all decoded components
+float put_quantized_vertices(a2m_buffer& buffer, const float3* vertices, const size_t count, const bool rotate,
+							 const float3& bounds_min, const float3& bounds_max);
+
+// stores the texture coordinates as 2 * half float, returns the max error of all decoded components
+float put_half_coords(a2m_buffer& buffer, const coord* coords, const size_t count);
+
+// stores the triangle indices with index_size (2 or 4) bytes per index, relative to first_index
+void put_compact_indices(a2m_buffer& buffer, const s_index* indices, const size_t triangle_count,
+						 const unsigned int first_index, const unsigned int index_size);
+
+#endif
@@ -0,0 +1,68 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "a2m_interleaved.h"
+#include "mesh_bounds.h"
+#include <cstring>
+
+interleaved_builder::interleaved_builder(const float3* vertices_, const size_t vertex_count, const unsigned int first_vertex_,
+										 const coord* coords_, const float3* normals_, const unsigned int first_coord_, const bool rotate_) :
+vertices(vertices_), first_vertex(first_vertex_), coords(coords_), normals(normals_), first_coord(first_coord_), rotate(rotate_),
+vertex_heads(vertex_count, ~0u) {
+	// most vertices only have a single texture coordinate
+	interleaved_vertices.reserve(vertex_count);
+	if(normals != nullptr) interleaved_normals.reserve(vertex_count);
+	corner_entries.reserve(vertex_count);
+}
+
+unsigned int interleaved_builder::add_corner(const unsigned int vertex_index, const unsigned int coord_index) {
+	unsigned int* link = &vertex_heads[vertex_index];
+	for(unsigned int index = *link; index != ~0u; index = *link) {
+		// coordinates are only deduplicated per .obj vertex (before welding), so equal ones may have different indices
+		const unsigned int entry_coord = corner_entries[index].coord_index;
+		if(entry_coord == coord_index ||
+		   (memcmp(&coords[entry_coord], &coords[coord_index], sizeof(coord)) == 0 &&
+			(normals == nullptr || memcmp(&normals[entry_coord], &normals[coord_index], sizeof(float3)) == 0))) {
+			return index;
+		}
+		link = &corner_entries[index].next;
+	}
+	
+	const unsigned int index = (unsigned int)interleaved_vertices.size();
+	*link = index;
+	corner_entries.push_back(corner_entry { coord_index, ~0u });
+	
+	const float3 position = get_stored_vertex(vertices[vertex_index], rotate);
+	const coord& tex_coord = coords[coord_index];
+	interleaved_vertices.push_back(interleaved_vertex {
+		{ position.x, position.y, position.z },
+		{ tex_coord.u, tex_coord.v },
+	});
+	if(normals != nullptr) interleaved_normals.push_back(get_stored_vertex(normals[coord_index], rotate));
+	return index;
+}
+
+void interleaved_builder::add_triangles(const s_index* vertex_indices, const s_index* tex_indices, const size_t triangle_count,
+										s_index* interleaved_indices) {
+	for(size_t i = 0; i < triangle_count; i++) {
+		for(unsigned int k = 0; k < 3; k++) {
+			interleaved_indices[i].indices[k] = add_corner(vertex_indices[i].indices[k] - first_vertex,
+														   tex_indices[i].indices[k] - first_coord);
+		}
+	}
+}
@@ -0,0 +1,78 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_A2M_INTERLEAVED_H__
+#define __OBJ2A2M_A2M_INTERLEAVED_H__
+
+#include <a2e.h>
+#include "obj_model.h"
+
+// vertex of the v3 INTERLEAVED_VERTICES section (-interleaved): stored (optionally rotated) position and texture coordinate
+struct interleaved_vertex {
+	float position[3];
+	float tex_coord[2];
+};
+
+// size of a stored interleaved vertex in floats: the interleaved_vertex is followed by the normal (3 floats, -normals)
+// and the tangent (4 floats, see vertex_tangent, -tangents)
+inline size_t interleaved_vertex_floats(const bool normals, const bool tangents) {
+	return (sizeof(interleaved_vertex) / sizeof(float)) + (normals ? 3 : 0) + (tangents ? 4 : 0);
+}
+
+// unifies the (vertex, texture coordinate) pairs of the triangle corners of a sub-object into single-indexed
+// interleaved vertices: every distinct pair (bitwise equal coordinates are merged) becomes one vertex, in the order of
+// its first use (so that a vertex cache optimized triangle order stays cache friendly). vertices/coords are the arrays
+// of the sub-object, which start at the global indices first_vertex/first_coord. normals (-normals) are optional and
+// belong to the coordinates (see sub_object)
+class interleaved_builder {
+public:
+	interleaved_builder(const float3* vertices, const size_t vertex_count, const unsigned int first_vertex,
+						const coord* coords, const float3* normals, const unsigned int first_coord, const bool rotate);
+	
+	// adds the corners of the triangles (global indices) and stores the indices of their interleaved vertices
+	// (relative to the first interleaved vertex of the sub-object) in interleaved_indices
+	void add_triangles(const s_index* vertex_indices, const s_index* tex_indices, const size_t triangle_count,
+					   s_index* interleaved_indices);
+	
+	vector<interleaved_vertex>& get_vertices() { return interleaved_vertices; }
+	// (optionally rotated) normal of each interleaved vertex (empty without normals)
+	vector<float3>& get_normals() { return interleaved_normals; }
+	
+protected:
+	const float3* vertices;
+	const unsigned int first_vertex;
+	const coord* coords;
+	const float3* normals;
+	const unsigned int first_coord;
+	const bool rotate;
+	
+	vector<interleaved_vertex> interleaved_vertices;
+	vector<float3> interleaved_normals;
+	// interleaved vertices of each vertex, linked in the order they were added (~0u terminates a list)
+	vector<unsigned int> vertex_heads;
+	struct corner_entry {
+		unsigned int coord_index;
+		unsigned int next;
+	};
+	vector<corner_entry> corner_entries;
+	
+	unsigned int add_corner(const unsigned int vertex_index, const unsigned int coord_index);
+	
+};
+
+#endif
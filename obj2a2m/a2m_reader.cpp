@@ -0,0 +1,489 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "a2m_reader.h"
+#include "a2m_v3.h"
+#include "a2m_compact.h"
+#include "a2m_interleaved.h"
+#include "obj_parser.h"
+
+// bounds checked sequential access to the file data
+class a2m_data_cursor {
+public:
+	a2m_data_cursor(const unsigned char* data, const size_t size) : cur(data), end(data + size) {}
+	
+	bool has_failed() const { return failed; }
+	
+	// returns the next size bytes (or nullptr if there aren't enough left)
+	const unsigned char* get_block(const size_t size) {
+		if(failed || (size_t)(end - cur) < size) {
+			failed = true;
+			return nullptr;
+		}
+		const unsigned char* block = cur;
+		cur += size;
+		return block;
+	}
+	
+	unsigned char get_char() {
+		const unsigned char* block = get_block(1);
+		return (block != nullptr ? *block : 0);
+	}
+	
+	// uints are stored big endian in v2 files
+	unsigned int get_uint() {
+		const unsigned char* block = get_block(4);
+		return (block != nullptr ? load_uint(block) : 0);
+	}
+	
+	void get_uints(unsigned int* uints, const size_t count) {
+		const unsigned char* block = get_block(count * 4);
+		if(block == nullptr) return;
+		for(size_t i = 0; i < count; i++, block += 4) {
+			uints[i] = load_uint(block);
+		}
+	}
+	
+	void get_floats(float* floats, const size_t count) {
+		const unsigned char* block = get_block(count * sizeof(float));
+		if(block != nullptr) memcpy(floats, block, count * sizeof(float));
+	}
+	
+	// reads up to (excluding) the next term char
+	string get_terminated_block(const unsigned char term) {
+		const unsigned char* term_pos = (failed ? nullptr : (const unsigned char*)memchr(cur, term, (size_t)(end - cur)));
+		if(term_pos == nullptr) {
+			failed = true;
+			return "";
+		}
+		const string str((const char*)cur, (size_t)(term_pos - cur));
+		cur = term_pos + 1;
+		return str;
+	}
+	
+protected:
+	const unsigned char* cur;
+	const unsigned char* const end;
+	bool failed = false;
+	
+	static unsigned int load_uint(const unsigned char* data) {
+		return (((unsigned int)data[0] << 24u) | ((unsigned int)data[1] << 16u) | ((unsigned int)data[2] << 8u) | (unsigned int)data[3]);
+	}
+	
+};
+
+// see the v2 format specification in obj2a2m.cpp
+static bool decode_a2m_v2(const unsigned char* data, const size_t size, a2m_model& model) {
+	a2m_data_cursor cursor(data, size);
+	cursor.get_block(8 + 4); // "A2EMODEL" + version
+	model.has_collision = (cursor.get_char() == 0x02);
+	const unsigned int vertex_count = cursor.get_uint();
+	const unsigned int coord_count = cursor.get_uint();
+	// (check the counts against the file size before allocating anything)
+	if(cursor.has_failed() || (uint64_t)vertex_count * sizeof(float3) + (uint64_t)coord_count * sizeof(coord) > size) return false;
+	
+	model.vertices.resize(vertex_count);
+	cursor.get_floats((float*)model.vertices.data(), (size_t)vertex_count * 3);
+	model.tex_coords.resize(coord_count);
+	cursor.get_floats((float*)model.tex_coords.data(), (size_t)coord_count * 2);
+	
+	const unsigned int object_count = cursor.get_uint();
+	if(cursor.has_failed() || object_count > size) return false;
+	model.objects.resize(object_count);
+	for(auto& object : model.objects) {
+		object.name = cursor.get_terminated_block(0xFF);
+	}
+	for(auto& object : model.objects) {
+		const unsigned int triangle_count = cursor.get_uint();
+		if(cursor.has_failed() || (uint64_t)triangle_count * sizeof(s_index) * 2 > size) return false;
+		object.first_triangle = model.indices.size();
+		object.triangle_count = triangle_count;
+		model.indices.resize(object.first_triangle + triangle_count);
+		model.tex_indices.resize(object.first_triangle + triangle_count);
+		cursor.get_uints((unsigned int*)(model.indices.data() + object.first_triangle), (size_t)triangle_count * 3);
+		cursor.get_uints((unsigned int*)(model.tex_indices.data() + object.first_triangle), (size_t)triangle_count * 3);
+	}
+	
+	if(model.has_collision) {
+		const unsigned int collision_vertex_count = cursor.get_uint();
+		if(cursor.has_failed() || (uint64_t)collision_vertex_count * sizeof(float3) > size) return false;
+		model.collision_vertices.resize(collision_vertex_count);
+		cursor.get_floats((float*)model.collision_vertices.data(), (size_t)collision_vertex_count * 3);
+		const unsigned int collision_triangle_count = cursor.get_uint();
+		if(cursor.has_failed() || (uint64_t)collision_triangle_count * sizeof(s_index) > size) return false;
+		model.collision_indices.resize(collision_triangle_count);
+		cursor.get_uints((unsigned int*)model.collision_indices.data(), (size_t)collision_triangle_count * 3);
+	}
+	return !cursor.has_failed();
+}
+
+// (decompressed) data of an a2m v3 section
+struct a2m_v3_section_data {
+	const unsigned char* data = nullptr;
+	uint64_t size = 0;
+	uint64_t count = 0;
+	vector<unsigned char> raw_data; // only used by compressed sections
+};
+
+// copies the count elements of a section (returns false if the section is too small)
+template <typename T> static bool get_section_array(const a2m_v3_section_data& section, vector<T>& elements) {
+	if(section.count > section.size / sizeof(T)) return false;
+	elements.resize((size_t)section.count);
+	if(section.count > 0) memcpy(elements.data(), section.data, (size_t)section.count * sizeof(T));
+	return true;
+}
+
+// decodes the indices of a sub-object of a COMPACT_INDICES/COMPACT_TEX_INDICES section
+static bool get_compact_indices(const a2m_v3_section_data& section, const uint32_t offset, const unsigned int index_size,
+								const uint32_t first_index, const size_t triangle_count, s_index* indices) {
+	if(index_size != 2 && index_size != 4) return false;
+	if((uint64_t)offset + (uint64_t)triangle_count * 3 * index_size > section.size) return false;
+	const unsigned char* data = section.data + offset;
+	for(size_t i = 0; i < triangle_count; i++) {
+		for(unsigned int k = 0; k < 3; k++, data += index_size) {
+			if(index_size == 2) {
+				uint16_t index;
+				memcpy(&index, data, sizeof(uint16_t));
+				indices[i].indices[k] = first_index + index;
+			}
+			else {
+				uint32_t index;
+				memcpy(&index, data, sizeof(uint32_t));
+				indices[i].indices[k] = first_index + index;
+			}
+		}
+	}
+	return true;
+}
+
+// max number of triangles an index section of the compact or interleaved encoding can hold (the index blocks use 2 or
+// 4 bytes per index), sub-objects beyond it are rejected before the index arrays are allocated
+static uint64_t get_max_section_triangles(const a2m_v3_section_data& section) {
+	return section.size / (3 * sizeof(uint16_t));
+}
+
+// see the v3 format specification in obj2a2m.cpp
+static bool decode_a2m_v3(const unsigned char* data, const size_t size, a2m_model& model, const unsigned int thread_count) {
+	if(size < A2M_V3_HEADER_SIZE) return false;
+	uint32_t flags, section_count;
+	uint64_t table_offset;
+	memcpy(&flags, data + 12, 4);
+	memcpy(&section_count, data + 20, 4);
+	memcpy(&table_offset, data + 24, 8);
+	if(table_offset > size || (uint64_t)section_count * A2M_V3_SECTION_ENTRY_SIZE > size - table_offset) return false;
+	model.has_collision = ((flags & A2M_V3_FLAG_COLLISION) != 0);
+	model.compact = ((flags & A2M_V3_FLAG_COMPACT) != 0);
+	model.interleaved = ((flags & A2M_V3_FLAG_INTERLEAVED) != 0);
+	if(model.compact && model.interleaved) return false;
+	
+	// unknown section types are ignored
+	map<uint32_t, a2m_v3_section_data> sections;
+	for(uint32_t i = 0; i < section_count; i++) {
+		const unsigned char* entry = data + table_offset + i * A2M_V3_SECTION_ENTRY_SIZE;
+		uint32_t type, section_flags;
+		uint64_t offset, section_size, count;
+		memcpy(&type, entry, 4);
+		memcpy(&section_flags, entry + 4, 4);
+		memcpy(&offset, entry + 8, 8);
+		memcpy(&section_size, entry + 16, 8);
+		memcpy(&count, entry + 24, 8);
+		if(offset > size || section_size > size - offset) return false;
+		
+		a2m_v3_section_data& section = sections[type];
+		section.count = count;
+		if((section_flags & A2M_V3_SECTION_FLAG_ZLIB) != 0) {
+			if(!a2m_v3_decompress_section(data + offset, (size_t)section_size, section.raw_data, thread_count)) return false;
+			section.data = section.raw_data.data();
+			section.size = section.raw_data.size();
+		}
+		else {
+			section.data = data + offset;
+			section.size = section_size;
+		}
+	}
+	auto get_section = [&sections](const A2M_V3_SECTION type) -> a2m_v3_section_data& {
+		return sections[(uint32_t)type];
+	};
+	
+	// sub-objects
+	vector<a2m_v3_object> objects;
+	const a2m_v3_section_data& strings = get_section(A2M_V3_SECTION::STRINGS);
+	if(!get_section_array(get_section(A2M_V3_SECTION::OBJECTS), objects)) return false;
+	uint64_t triangle_count = 0;
+	model.objects.resize(objects.size());
+	for(size_t i = 0; i < objects.size(); i++) {
+		if((uint64_t)objects[i].name_offset + objects[i].name_length > strings.size) return false;
+		model.objects[i].name.assign((const char*)strings.data + objects[i].name_offset, objects[i].name_length);
+		model.objects[i].first_triangle = objects[i].first_triangle;
+		model.objects[i].triangle_count = objects[i].triangle_count;
+		triangle_count = std::max(triangle_count, (uint64_t)objects[i].first_triangle + objects[i].triangle_count);
+	}
+	
+	if(model.interleaved) {
+		// split the interleaved vertices, both index arrays use the interleaved indices (see put_compact_indices)
+		vector<a2m_v3_interleaved_object> interleaved_objects;
+		const bool has_normals = ((flags & A2M_V3_FLAG_NORMALS) != 0);
+		const bool has_tangents = ((flags & A2M_V3_FLAG_TANGENTS) != 0);
+		const size_t vertex_size = interleaved_vertex_floats(has_normals, has_tangents) * sizeof(float);
+		const a2m_v3_section_data& vertex_section = get_section(A2M_V3_SECTION::INTERLEAVED_VERTICES);
+		if(!get_section_array(get_section(A2M_V3_SECTION::INTERLEAVED_OBJECTS), interleaved_objects) ||
+		   interleaved_objects.size() != objects.size() ||
+		   (has_tangents && !has_normals) ||
+		   vertex_section.count > vertex_section.size / vertex_size ||
+		   triangle_count > get_max_section_triangles(get_section(A2M_V3_SECTION::INTERLEAVED_INDICES))) {
+			return false;
+		}
+		
+		const size_t vertex_count = (size_t)vertex_section.count;
+		model.vertices.resize(vertex_count);
+		model.tex_coords.resize(vertex_count);
+		if(has_normals) model.normals.resize(vertex_count);
+		if(has_tangents) model.tangents.resize(vertex_count);
+		for(size_t i = 0; i < vertex_count; i++) {
+			const unsigned char* vertex = vertex_section.data + i * vertex_size;
+			interleaved_vertex stored_vertex;
+			memcpy(&stored_vertex, vertex, sizeof(interleaved_vertex));
+			vertex += sizeof(interleaved_vertex);
+			model.vertices[i] = float3(stored_vertex.position[0], stored_vertex.position[1], stored_vertex.position[2]);
+			model.tex_coords[i].u = stored_vertex.tex_coord[0];
+			model.tex_coords[i].v = stored_vertex.tex_coord[1];
+			if(has_normals) {
+				float normal[3];
+				memcpy(normal, vertex, sizeof(normal));
+				vertex += sizeof(normal);
+				model.normals[i] = float3(normal[0], normal[1], normal[2]);
+			}
+			if(has_tangents) memcpy(&model.tangents[i], vertex, sizeof(vertex_tangent));
+		}
+		model.indices.resize((size_t)triangle_count);
+		for(size_t i = 0; i < interleaved_objects.size(); i++) {
+			const a2m_v3_interleaved_object& interleaved_object = interleaved_objects[i];
+			a2m_model::object& object = model.objects[i];
+			if((uint64_t)interleaved_object.first_vertex + interleaved_object.vertex_count > vertex_count ||
+			   !get_compact_indices(get_section(A2M_V3_SECTION::INTERLEAVED_INDICES), interleaved_object.index_offset, interleaved_object.index_size,
+									interleaved_object.first_vertex, object.triangle_count, model.indices.data() + object.first_triangle)) {
+				return false;
+			}
+			object.first_vertex = interleaved_object.first_vertex;
+			object.vertex_count = interleaved_object.vertex_count;
+		}
+		model.tex_indices = model.indices;
+	}
+	else if(!model.compact) {
+		if(!get_section_array(get_section(A2M_V3_SECTION::VERTICES), model.vertices) ||
+		   !get_section_array(get_section(A2M_V3_SECTION::TEX_COORDS), model.tex_coords) ||
+		   !get_section_array(get_section(A2M_V3_SECTION::INDICES), model.indices) ||
+		   !get_section_array(get_section(A2M_V3_SECTION::TEX_INDICES), model.tex_indices)) {
+			return false;
+		}
+	}
+	else {
+		// dequantize the vertices and indices of each sub-object (see put_quantized_vertices and put_compact_indices)
+		vector<a2m_v3_compact_object> compact_objects;
+		vector<uint16_t> quantized_vertices, half_coords;
+		const a2m_v3_section_data& vertex_section = get_section(A2M_V3_SECTION::QUANTIZED_VERTICES);
+		const a2m_v3_section_data& coord_section = get_section(A2M_V3_SECTION::HALF_TEX_COORDS);
+		if(!get_section_array(get_section(A2M_V3_SECTION::COMPACT_OBJECTS), compact_objects) ||
+		   compact_objects.size() != objects.size() ||
+		   vertex_section.count > vertex_section.size / (sizeof(uint16_t) * 3) ||
+		   coord_section.count > coord_section.size / (sizeof(uint16_t) * 2) ||
+		   triangle_count > get_max_section_triangles(get_section(A2M_V3_SECTION::COMPACT_INDICES)) ||
+		   triangle_count > get_max_section_triangles(get_section(A2M_V3_SECTION::COMPACT_TEX_INDICES))) {
+			return false;
+		}
+		
+		model.vertices.resize((size_t)vertex_section.count);
+		model.tex_coords.resize((size_t)coord_section.count);
+		model.indices.resize((size_t)triangle_count);
+		model.tex_indices.resize((size_t)triangle_count);
+		for(size_t i = 0; i < compact_objects.size(); i++) {
+			const a2m_v3_compact_object& compact_object = compact_objects[i];
+			a2m_model::object& object = model.objects[i];
+			if((uint64_t)compact_object.first_vertex + compact_object.vertex_count > vertex_section.count ||
+			   (uint64_t)compact_object.first_coord + compact_object.coord_count > coord_section.count) {
+				return false;
+			}
+			
+			object.bounds_min = float3(compact_object.bounds_min[0], compact_object.bounds_min[1], compact_object.bounds_min[2]);
+			object.bounds_max = float3(compact_object.bounds_max[0], compact_object.bounds_max[1], compact_object.bounds_max[2]);
+			float step[3];
+			for(unsigned int k = 0; k < 3; k++) {
+				step[k] = (compact_object.bounds_max[k] - compact_object.bounds_min[k]) / 65535.0f;
+			}
+			for(uint32_t j = 0; j < compact_object.vertex_count; j++) {
+				uint16_t quantized[3];
+				memcpy(quantized, vertex_section.data + (size_t)(compact_object.first_vertex + j) * sizeof(quantized), sizeof(quantized));
+				float3& vertex = model.vertices[compact_object.first_vertex + j];
+				vertex.x = compact_object.bounds_min[0] + (float)quantized[0] * step[0];
+				vertex.y = compact_object.bounds_min[1] + (float)quantized[1] * step[1];
+				vertex.z = compact_object.bounds_min[2] + (float)quantized[2] * step[2];
+			}
+			for(uint32_t j = 0; j < compact_object.coord_count; j++) {
+				uint16_t halfs[2];
+				memcpy(halfs, coord_section.data + (size_t)(compact_object.first_coord + j) * sizeof(halfs), sizeof(halfs));
+				model.tex_coords[compact_object.first_coord + j].u = half_to_float(halfs[0]);
+				model.tex_coords[compact_object.first_coord + j].v = half_to_float(halfs[1]);
+			}
+			
+			if(!get_compact_indices(get_section(A2M_V3_SECTION::COMPACT_INDICES), compact_object.index_offset, compact_object.index_size,
+									compact_object.first_vertex, object.triangle_count, model.indices.data() + object.first_triangle) ||
+			   !get_compact_indices(get_section(A2M_V3_SECTION::COMPACT_TEX_INDICES), compact_object.tex_index_offset, compact_object.tex_index_size,
+									compact_object.first_coord, object.triangle_count, model.tex_indices.data() + object.first_triangle)) {
+				return false;
+			}
+		}
+	}
+	if(model.indices.size() < triangle_count || model.tex_indices.size() < triangle_count) return false;
+	
+	// culling data
+	if(sections.count((uint32_t)A2M_V3_SECTION::OBJECT_BOUNDS) > 0) {
+		vector<a2m_v3_object_bounds> object_bounds;
+		if(!get_section_array(get_section(A2M_V3_SECTION::OBJECT_BOUNDS), object_bounds) ||
+		   object_bounds.size() != objects.size()) {
+			return false;
+		}
+		if(sections.count((uint32_t)A2M_V3_SECTION::MESHLETS) > 0 &&
+		   !get_section_array(get_section(A2M_V3_SECTION::MESHLETS), model.meshlets)) {
+			return false;
+		}
+		for(size_t i = 0; i < object_bounds.size(); i++) {
+			const a2m_v3_object_bounds& bounds = object_bounds[i];
+			a2m_model::object& object = model.objects[i];
+			object.bounds_min = float3(bounds.bounds_min[0], bounds.bounds_min[1], bounds.bounds_min[2]);
+			object.bounds_max = float3(bounds.bounds_max[0], bounds.bounds_max[1], bounds.bounds_max[2]);
+			object.sphere_center = float3(bounds.sphere_center[0], bounds.sphere_center[1], bounds.sphere_center[2]);
+			object.sphere_radius = bounds.sphere_radius;
+			object.first_meshlet = bounds.first_meshlet;
+			object.meshlet_count = bounds.meshlet_count;
+			
+			// the meshlets of a sub-object must lie within its triangles
+			if((uint64_t)bounds.first_meshlet + bounds.meshlet_count > model.meshlets.size()) return false;
+			for(uint32_t j = 0; j < bounds.meshlet_count; j++) {
+				const a2m_v3_meshlet& object_meshlet = model.meshlets[bounds.first_meshlet + j];
+				if(object_meshlet.first_triangle < object.first_triangle ||
+				   (uint64_t)object_meshlet.first_triangle + object_meshlet.triangle_count > (uint64_t)object.first_triangle + object.triangle_count) {
+					return false;
+				}
+			}
+		}
+		model.has_bounds = true;
+	}
+	
+	// lod chain
+	if(sections.count((uint32_t)A2M_V3_SECTION::LODS) > 0) {
+		if(!get_section_array(get_section(A2M_V3_SECTION::LODS), model.lods) ||
+		   !get_section_array(get_section(A2M_V3_SECTION::LOD_INDICES), model.lod_indices) ||
+		   (!model.interleaved && !get_section_array(get_section(A2M_V3_SECTION::LOD_TEX_INDICES), model.lod_tex_indices)) ||
+		   (!model.interleaved && model.lod_indices.size() != model.lod_tex_indices.size()) ||
+		   objects.empty() || model.lods.size() % objects.size() != 0) {
+			return false;
+		}
+		for(const auto& lod : model.lods) {
+			if((uint64_t)lod.first_triangle + lod.triangle_count > model.lod_indices.size()) return false;
+		}
+		if(model.interleaved) model.lod_tex_indices = model.lod_indices;
+	}
+	
+	if(model.has_collision &&
+	   (!get_section_array(get_section(A2M_V3_SECTION::COLLISION_VERTICES), model.collision_vertices) ||
+		!get_section_array(get_section(A2M_V3_SECTION::COLLISION_INDICES), model.collision_indices))) {
+		return false;
+	}
+	if(model.has_collision && sections.count((uint32_t)A2M_V3_SECTION::COLLISION_BVH) > 0 &&
+	   !get_section_array(get_section(A2M_V3_SECTION::COLLISION_BVH), model.collision_bvh)) {
+		return false;
+	}
+	return true;
+}
+
+bool decode_a2m(const unsigned char* data, const size_t size, a2m_model& model, const unsigned int thread_count) {
+	model = a2m_model();
+	if(size < 12 || memcmp(data, "A2EMODEL", 8) != 0) return false;
+	
+	// the v2 version is stored big endian, the v3 version little endian
+	const uint32_t v2_version = (((uint32_t)data[8] << 24u) | ((uint32_t)data[9] << 16u) | ((uint32_t)data[10] << 8u) | (uint32_t)data[11]);
+	uint32_t v3_version;
+	memcpy(&v3_version, data + 8, 4);
+	bool decoded = false;
+	if(v2_version == 2) {
+		model.version = 2;
+		decoded = decode_a2m_v2(data, size, model);
+	}
+	else if(v3_version == A2M_V3_VERSION) {
+		model.version = A2M_V3_VERSION;
+		decoded = decode_a2m_v3(data, size, model, thread_count);
+	}
+	if(!decoded) return false;
+	
+	// all indices must be valid
+	for(size_t i = 0; i < model.indices.size(); i++) {
+		for(unsigned int k = 0; k < 3; k++) {
+			if(model.indices[i].indices[k] >= model.vertices.size() ||
+			   model.tex_indices[i].indices[k] >= model.tex_coords.size()) {
+				return false;
+			}
+		}
+	}
+	for(size_t i = 0; i < model.lod_indices.size(); i++) {
+		for(unsigned int k = 0; k < 3; k++) {
+			if(model.lod_indices[i].indices[k] >= model.vertices.size() ||
+			   model.lod_tex_indices[i].indices[k] >= model.tex_coords.size()) {
+				return false;
+			}
+		}
+	}
+	for(const auto& triangle : model.collision_indices) {
+		for(unsigned int k = 0; k < 3; k++) {
+			if(triangle.indices[k] >= model.collision_vertices.size()) return false;
+		}
+	}
+	if(!model.collision_bvh.empty() &&
+	   !validate_collision_bvh(model.collision_bvh.data(), model.collision_bvh.size(), model.collision_vertices.data(),
+							   model.collision_indices.data(), model.collision_indices.size())) {
+		return false;
+	}
+	return true;
+}
+
+bool read_a2m(const string& filename, a2m_model& model, const A2M_READ_MODE mode, const unsigned int thread_count) {
+	bool decoded = false;
+	if(mode == A2M_READ_MODE::MMAP) {
+		mapped_file file(filename.c_str());
+		if(!file.is_open()) {
+			a2e_error("couldn't open a2m file \"%s\"!", filename);
+			return false;
+		}
+		decoded = decode_a2m((const unsigned char*)file.get_data(), file.get_size(), model, thread_count);
+	}
+	else {
+		file_io f;
+		if(!f.open(filename, file_io::OPEN_TYPE::READ_BINARY)) {
+			a2e_error("couldn't open a2m file \"%s\"!", filename);
+			return false;
+		}
+		vector<unsigned char> file_data((size_t)f.get_filesize());
+		f.get_block((char*)file_data.data(), file_data.size());
+		f.close();
+		decoded = decode_a2m(file_data.data(), file_data.size(), model, thread_count);
+	}
+	if(!decoded) {
+		a2e_error("invalid or unsupported a2m file \"%s\"!", filename);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,97 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_A2M_READER_H__
+#define __OBJ2A2M_A2M_READER_H__
+
+#include <a2e.h>
+#include "obj_model.h"
+#include "collision_bvh.h"
+#include "a2m_v3.h"
+#include "mesh_normals.h"
+
+// how read_a2m accesses the file:
+//  * BUFFERED: the whole file is read into memory with a single read
+//  * MMAP: the file is mapped and decoded from the mapping
+enum class A2M_READ_MODE : unsigned int {
+	BUFFERED,
+	MMAP,
+};
+
+// an a2m file (any version and encoding that obj2a2m writes) decoded into flat arrays
+struct a2m_model {
+	uint32_t version = 0;
+	// the vertices and texture coordinates were decoded from the compact encoding (see a2m_v3_compact_object)
+	bool compact = false;
+	// the vertices and texture coordinates were decoded from the interleaved encoding (see a2m_v3_interleaved_object):
+	// there is one texture coordinate per vertex and tex_indices/lod_tex_indices are equal to indices/lod_indices
+	bool interleaved = false;
+	
+	vector<float3> vertices;
+	vector<coord> tex_coords;
+	// optional (interleaved encoding with -normals/-tangents): one per vertex
+	vector<float3> normals;
+	vector<vertex_tangent> tangents;
+	
+	struct object {
+		string name;
+		size_t first_triangle;
+		size_t triangle_count;
+		// aabb of the vertices (from the v3 OBJECT_BOUNDS section, or the quantization aabb of the compact encoding)
+		float3 bounds_min;
+		float3 bounds_max;
+		// bounding sphere and meshlet range (OBJECT_BOUNDS section only)
+		float3 sphere_center;
+		float sphere_radius = 0.0f;
+		size_t first_meshlet = 0;
+		size_t meshlet_count = 0;
+		// vertex range of the sub-object (interleaved encoding only)
+		size_t first_vertex = 0;
+		size_t vertex_count = 0;
+	};
+	vector<object> objects;
+	// the file contains an OBJECT_BOUNDS section
+	bool has_bounds = false;
+	// optional (v3 MESHLETS section), first_triangle is a global triangle index
+	vector<a2m_v3_meshlet> meshlets;
+	
+	// optional (v3 LODS, LOD_INDICES and LOD_TEX_INDICES sections): LOD COUNT * OBJECT COUNT entries (see a2m_v3_lod)
+	// and the global vertex and texture coordinate indices of the lod triangles
+	vector<a2m_v3_lod> lods;
+	vector<s_index> lod_indices;
+	vector<s_index> lod_tex_indices;
+	
+	// global vertex and texture coordinate indices of the triangles of all sub-objects (in sub-object order)
+	vector<s_index> indices;
+	vector<s_index> tex_indices;
+	
+	bool has_collision = false;
+	vector<float3> collision_vertices;
+	vector<s_index> collision_indices;
+	// optional (v3 COLLISION_BVH section), checked with validate_collision_bvh
+	vector<collision_bvh_node> collision_bvh;
+};
+
+// reads and decodes an a2m file, compressed sections are decompressed on thread_count tasks.
+// returns false if the file can't be read or is invalid
+bool read_a2m(const string& filename, a2m_model& model, const A2M_READ_MODE mode = A2M_READ_MODE::MMAP, const unsigned int thread_count = 1);
+
+// decodes a2m file data that is already in memory (see read_a2m)
+bool decode_a2m(const unsigned char* data, const size_t size, a2m_model& model, const unsigned int thread_count = 1);
+
+#endif
@@ -0,0 +1,186 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "a2m_v3.h"
+#include "parallel.h"
+#include <zlib.h>
+
+template <typename T> static void put_le(a2m_buffer& buffer, const T value) {
+	buffer.put_block(&value, sizeof(T));
+}
+
+static size_t align_size(const size_t size) {
+	return (size + A2M_V3_ALIGNMENT - 1) & ~(size_t)(A2M_V3_ALIGNMENT - 1);
+}
+
+void a2m_v3_builder::add_section(const A2M_V3_SECTION type, a2m_buffer&& data, const uint64_t count) {
+	sections.push_back(section { type, move(data), count, 0, false, 0 });
+}
+
+void a2m_v3_builder::add_external_section(const A2M_V3_SECTION type, const uint64_t size, const uint64_t count) {
+	sections.push_back(section { type, a2m_buffer(), count, 0, true, size });
+}
+
+void a2m_v3_builder::compress(const int level, const unsigned int thread_count) {
+	// split all sections into chunks and compress all chunks in parallel
+	struct chunk {
+		size_t section;
+		size_t offset;
+		size_t size;
+		vector<unsigned char> data;
+	};
+	vector<chunk> chunks;
+	for(size_t i = 0; i < sections.size(); i++) {
+		if((sections[i].flags & A2M_V3_SECTION_FLAG_ZLIB) != 0 || sections[i].external) continue;
+		for(size_t offset = 0; offset < sections[i].data.size(); offset += A2M_V3_CHUNK_SIZE) {
+			chunks.push_back(chunk { i, offset, std::min((size_t)A2M_V3_CHUNK_SIZE, sections[i].data.size() - offset), {} });
+		}
+	}
+	parallel_for(chunks.size(), thread_count, [&](const size_t job) {
+		chunk& ch = chunks[job];
+		uLongf compressed_size = compressBound((uLong)ch.size);
+		ch.data.resize(compressed_size);
+		if(compress2(ch.data.data(), &compressed_size, (const Bytef*)sections[ch.section].data.data() + ch.offset,
+					 (uLong)ch.size, level) != Z_OK) {
+			ch.data.clear();
+			return;
+		}
+		ch.data.resize(compressed_size);
+	});
+	
+	// assemble the compressed sections:
+	// [RAW SIZE - 8 bytes] [CHUNK SIZE - 4 bytes] [CHUNK COUNT - 4 bytes] [COMPRESSED CHUNK SIZES - 4 bytes * CHUNK COUNT] [ZLIB STREAMS]
+	for(size_t i = 0, first_chunk = 0; first_chunk < chunks.size(); i++) {
+		if(chunks[first_chunk].section != i) continue;
+		size_t end_chunk = first_chunk;
+		size_t compressed_size = 0;
+		bool failed = false;
+		for(; end_chunk < chunks.size() && chunks[end_chunk].section == i; end_chunk++) {
+			compressed_size += chunks[end_chunk].data.size();
+			if(chunks[end_chunk].data.empty()) failed = true;
+		}
+		
+		const size_t chunk_count = end_chunk - first_chunk;
+		const size_t header_size = 16 + chunk_count * 4;
+		if(failed) a2e_error("failed to compress section #%u!", i);
+		else if(header_size + compressed_size < sections[i].data.size()) {
+			a2m_buffer data;
+			data.reserve(header_size + compressed_size);
+			put_le<uint64_t>(data, sections[i].data.size());
+			put_le<uint32_t>(data, A2M_V3_CHUNK_SIZE);
+			put_le<uint32_t>(data, (uint32_t)chunk_count);
+			for(size_t c = first_chunk; c < end_chunk; c++) {
+				put_le<uint32_t>(data, (uint32_t)chunks[c].data.size());
+			}
+			for(size_t c = first_chunk; c < end_chunk; c++) {
+				data.put_block(chunks[c].data.data(), chunks[c].data.size());
+			}
+			sections[i].data = move(data);
+			sections[i].flags |= A2M_V3_SECTION_FLAG_ZLIB;
+		}
+		first_chunk = end_chunk;
+	}
+}
+
+bool a2m_v3_decompress_section(const unsigned char* data, const size_t size, vector<unsigned char>& raw_data,
+							   const unsigned int thread_count) {
+	if(size < 16) return false;
+	uint64_t raw_size;
+	uint32_t chunk_size, chunk_count;
+	memcpy(&raw_size, data, 8);
+	memcpy(&chunk_size, data + 8, 4);
+	memcpy(&chunk_count, data + 12, 4);
+	if(chunk_size == 0 ||
+	   (raw_size + chunk_size - 1) / chunk_size != chunk_count ||
+	   size < 16 + (size_t)chunk_count * 4) {
+		return false;
+	}
+	
+	// compute the offsets of all zlib streams
+	vector<size_t> offsets(chunk_count + 1);
+	offsets[0] = 16 + (size_t)chunk_count * 4;
+	for(uint32_t i = 0; i < chunk_count; i++) {
+		uint32_t compressed_size;
+		memcpy(&compressed_size, data + 16 + i * 4, 4);
+		offsets[i + 1] = offsets[i] + compressed_size;
+	}
+	if(offsets[chunk_count] > size) return false;
+	
+	raw_data.resize((size_t)raw_size);
+	atomic<bool> success { true };
+	parallel_for(chunk_count, thread_count, [&](const size_t i) {
+		const size_t expected_size = std::min((size_t)chunk_size, (size_t)raw_size - i * chunk_size);
+		uLongf chunk_raw_size = (uLongf)expected_size;
+		if(uncompress(raw_data.data() + i * chunk_size, &chunk_raw_size,
+					  data + offsets[i], (uLong)(offsets[i + 1] - offsets[i])) != Z_OK ||
+		   chunk_raw_size != expected_size) {
+			success = false;
+		}
+	});
+	return success;
+}
+
+vector<a2m_buffer> a2m_v3_builder::finish(const uint32_t flags, vector<size_t>* external_buffers) {
+	// compute the aligned section offsets
+	const size_t table_size = sections.size() * A2M_V3_SECTION_ENTRY_SIZE;
+	vector<uint64_t> sizes, offsets;
+	size_t file_size = align_size(A2M_V3_HEADER_SIZE + table_size);
+	for(const auto& sec : sections) {
+		sizes.push_back(sec.external ? sec.external_size : sec.data.size());
+		offsets.push_back(file_size);
+		file_size = align_size(file_size + sizes.back());
+	}
+	
+	// header
+	vector<a2m_buffer> buffers;
+	buffers.emplace_back();
+	a2m_buffer& header = buffers.back();
+	header.reserve(align_size(A2M_V3_HEADER_SIZE + table_size));
+	header.put_block("A2EMODEL", 8);
+	put_le<uint32_t>(header, A2M_V3_VERSION);
+	put_le<uint32_t>(header, flags);
+	put_le<uint32_t>(header, A2M_V3_HEADER_SIZE);
+	put_le<uint32_t>(header, (uint32_t)sections.size());
+	put_le<uint64_t>(header, A2M_V3_HEADER_SIZE); // section table offset
+	put_le<uint64_t>(header, file_size);
+	static const unsigned char zeros[A2M_V3_ALIGNMENT * 2] {};
+	header.put_block(zeros, A2M_V3_HEADER_SIZE - header.size());
+	
+	// section table
+	for(size_t i = 0; i < sections.size(); i++) {
+		put_le<uint32_t>(header, (uint32_t)sections[i].type);
+		put_le<uint32_t>(header, sections[i].flags);
+		put_le<uint64_t>(header, offsets[i]);
+		put_le<uint64_t>(header, sizes[i]);
+		put_le<uint64_t>(header, sections[i].count);
+	}
+	header.put_block(zeros, align_size(header.size()) - header.size());
+	
+	// section data (+ padding)
+	for(size_t i = 0; i < sections.size(); i++) {
+		const size_t padding = align_size(sizes[i]) - sizes[i];
+		if(sections[i].external && external_buffers != nullptr) external_buffers->push_back(buffers.size());
+		buffers.push_back(move(sections[i].data));
+		if(padding > 0) {
+			buffers.emplace_back();
+			buffers.back().put_block(zeros, padding);
+		}
+	}
+	sections.clear();
+	return buffers;
+}
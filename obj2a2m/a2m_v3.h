@@ -0,0 +1,183 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_A2M_V3_H__
+#define __OBJ2A2M_A2M_V3_H__
+
+#include <a2e.h>
+#include "a2m_writer.h"
+
+// all supported platforms are little endian, so the v3 data (including the compact and interleaved encodings) is simply
+// stored in memory order
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#error "a2m v3 output is only supported on little endian platforms"
+#endif
+
+#define A2M_V3_VERSION 3
+#define A2M_V3_HEADER_SIZE 64
+#define A2M_V3_SECTION_ENTRY_SIZE 32
+#define A2M_V3_ALIGNMENT 16
+// compressed sections are split into independent zlib streams of this (uncompressed) size
+#define A2M_V3_CHUNK_SIZE (1024u * 1024u)
+#define A2M_V3_DEFAULT_COMPRESSION_LEVEL 6
+
+// a2m v3 section types (see the format description in obj2a2m.cpp)
+enum class A2M_V3_SECTION : uint32_t {
+	VERTICES			= 1,
+	TEX_COORDS			= 2,
+	OBJECTS				= 3,
+	INDICES				= 4,
+	TEX_INDICES			= 5,
+	STRINGS				= 6,
+	COLLISION_VERTICES	= 7,
+	COLLISION_INDICES	= 8,
+	// compact encoding (-compact), replacing VERTICES, TEX_COORDS, INDICES and TEX_INDICES
+	QUANTIZED_VERTICES	= 9,
+	HALF_TEX_COORDS		= 10,
+	COMPACT_OBJECTS		= 11,
+	COMPACT_INDICES		= 12,
+	COMPACT_TEX_INDICES	= 13,
+	// precomputed bvh over the collision triangles (-collision_bvh, see collision_bvh_node)
+	COLLISION_BVH		= 14,
+	// culling data: aabb and bounding sphere of each sub-object (always written) and its meshlets (-meshlets)
+	OBJECT_BOUNDS		= 15,
+	MESHLETS			= 16,
+	// lod chain (-lod): simplified triangles of each sub-object (see a2m_v3_lod)
+	LODS				= 17,
+	LOD_INDICES			= 18,
+	LOD_TEX_INDICES		= 19,
+	// interleaved encoding (-interleaved), replacing VERTICES, TEX_COORDS, INDICES and TEX_INDICES
+	INTERLEAVED_VERTICES	= 20,
+	INTERLEAVED_OBJECTS		= 21,
+	INTERLEAVED_INDICES		= 22,
+};
+
+// a2m v3 header flags
+#define A2M_V3_FLAG_COLLISION 0x02
+#define A2M_V3_FLAG_COMPACT 0x04
+#define A2M_V3_FLAG_INTERLEAVED 0x08
+// interleaved encoding only: the interleaved vertices contain a normal (and a tangent)
+#define A2M_V3_FLAG_NORMALS 0x10
+#define A2M_V3_FLAG_TANGENTS 0x20
+
+// a2m v3 section flags
+#define A2M_V3_SECTION_FLAG_ZLIB 0x01
+
+// per sub-object entry of the OBJECTS section
+struct a2m_v3_object {
+	uint32_t name_offset; // into the STRINGS section
+	uint32_t name_length; // excluding the terminating 0
+	uint32_t first_triangle; // into the INDICES/TEX_INDICES sections
+	uint32_t triangle_count;
+};
+
+// per sub-object entry of the COMPACT_OBJECTS section (same order as the OBJECTS section)
+struct a2m_v3_compact_object {
+	uint32_t first_vertex; // into the QUANTIZED_VERTICES section
+	uint32_t vertex_count;
+	uint32_t first_coord; // into the HALF_TEX_COORDS section
+	uint32_t coord_count;
+	uint32_t index_offset; // byte offset into the COMPACT_INDICES section
+	uint32_t tex_index_offset; // byte offset into the COMPACT_TEX_INDICES section
+	uint16_t index_size; // 2 or 4 bytes per index
+	uint16_t tex_index_size;
+	float bounds_min[3]; // quantization aabb
+	float bounds_max[3];
+};
+
+// per sub-object entry of the INTERLEAVED_OBJECTS section (same order as the OBJECTS section): the sub-object's
+// triangles index its range of the INTERLEAVED_VERTICES section (see interleaved_vertex) with a single index
+struct a2m_v3_interleaved_object {
+	uint32_t first_vertex; // into the INTERLEAVED_VERTICES section
+	uint32_t vertex_count;
+	uint32_t index_offset; // byte offset into the INTERLEAVED_INDICES section
+	uint16_t index_size; // 2 or 4 bytes per index (relative to first_vertex)
+	uint16_t reserved;
+};
+
+// per sub-object entry of the OBJECT_BOUNDS section (same order as the OBJECTS section)
+struct a2m_v3_object_bounds {
+	float bounds_min[3]; // aabb of the (stored) vertices
+	float bounds_max[3];
+	float sphere_center[3]; // bounding sphere
+	float sphere_radius;
+	uint32_t first_meshlet; // into the MESHLETS section
+	uint32_t meshlet_count; // 0 if the file contains no meshlets
+};
+
+// entry of the MESHLETS section (see meshlet): a contiguous triangle range of a sub-object with its bounding sphere
+// and normal cone (the meshlet faces away from a camera at position p if dot(normalize(cone_apex - p), cone_axis) >= cone_cutoff)
+struct a2m_v3_meshlet {
+	uint32_t first_triangle; // into the INDICES/TEX_INDICES sections
+	uint16_t triangle_count;
+	uint16_t vertex_count; // unique vertices
+	float sphere_center[3];
+	float sphere_radius;
+	float cone_apex[3];
+	float cone_axis[3];
+	float cone_cutoff;
+};
+
+// entry of the LODS section: there are LOD COUNT * OBJECT COUNT entries (all sub-objects of the first lod, then all
+// sub-objects of the second lod, ...). the lod triangles index the VERTICES and TEX_COORDS of the full resolution model
+// (with the interleaved encoding: LOD_INDICES index the INTERLEAVED_VERTICES and there is no LOD_TEX_INDICES section)
+struct a2m_v3_lod {
+	uint32_t first_triangle; // into the LOD_INDICES/LOD_TEX_INDICES sections
+	uint32_t triangle_count;
+	float ratio; // target ratio of the triangle count (relative to the full resolution sub-object)
+	float error; // approximate max distance to the full resolution surface
+};
+
+// assembles an a2m v3 file: all data is stored little endian and every section starts at a 16 byte aligned offset,
+// so that the file can be mapped and its arrays be used in place
+class a2m_v3_builder {
+public:
+	// count is the amount of elements stored in the section
+	void add_section(const A2M_V3_SECTION type, a2m_buffer&& data, const uint64_t count);
+	
+	// adds a section whose (size bytes of) data is provided by the caller when writing the file (see finish)
+	void add_external_section(const A2M_V3_SECTION type, const uint64_t size, const uint64_t count);
+	
+	// zlib compresses all sections that were added so far (on thread_count tasks), sections that
+	// wouldn't get smaller are kept uncompressed
+	void compress(const int level, const unsigned int thread_count);
+	
+	// returns all buffers of the file (header, section table, padding and section data) in file order,
+	// these can be written with write_a2m_buffers. the data of external sections is left empty, the
+	// positions of these buffers are added to external_buffers (in the order the sections were added)
+	vector<a2m_buffer> finish(const uint32_t flags, vector<size_t>* external_buffers = nullptr);
+	
+protected:
+	struct section {
+		A2M_V3_SECTION type;
+		a2m_buffer data;
+		uint64_t count;
+		uint32_t flags;
+		bool external;
+		uint64_t external_size;
+	};
+	vector<section> sections;
+	
+};
+
+// decompresses the data of an A2M_V3_SECTION_FLAG_ZLIB section (on thread_count tasks),
+// returns false if the data is corrupt
+bool a2m_v3_decompress_section(const unsigned char* data, const size_t size, vector<unsigned char>& raw_data,
+							   const unsigned int thread_count);
+
+#endif
@@ -0,0 +1,655 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "a2m_verify.h"
+#include "vertex_weld.h"
+#include "meshlets.h"
+#include "mesh_bounds.h"
+#include <unordered_set>
+#include <unordered_map>
+#include <cfloat>
+
+// the corners of a triangle (as stored in the file)
+struct verify_triangle {
+	float3 positions[3];
+	coord coords[3];
+};
+
+// allowed difference of the positions (absolute + relative to the value) and texture coordinates (relative to the value)
+struct verify_tolerance {
+	float position;
+	float position_relative;
+	float coord_relative;
+	float coord_min;
+};
+
+// max error of all matched corners
+struct verify_error {
+	float position = 0.0f;
+	float coord = 0.0f;
+};
+
+// the a2m triangle (of the sub-object) and the corner offset an obj triangle was matched with (~0u if there is none)
+struct verify_match {
+	uint32_t triangle;
+	uint32_t offset;
+};
+
+// returns true if dst contains the corners of src in the same winding (any start corner) within the tolerance,
+// offset is set to the dst corner of the first src corner
+static bool match_triangle(const verify_triangle& src, const verify_triangle& dst, const verify_tolerance& tolerance, verify_error& error,
+						   uint32_t* matched_offset = nullptr) {
+	for(unsigned int offset = 0; offset < 3; offset++) {
+		verify_error triangle_error;
+		bool matched = true;
+		for(unsigned int k = 0; k < 3 && matched; k++) {
+			const float3& p1 = src.positions[k];
+			const float3& p2 = dst.positions[(k + offset) % 3];
+			const float p1_components[3] { p1.x, p1.y, p1.z };
+			const float p2_components[3] { p2.x, p2.y, p2.z };
+			for(unsigned int c = 0; c < 3; c++) {
+				const float diff = fabsf(p1_components[c] - p2_components[c]);
+				if(!(diff <= tolerance.position + fabsf(p1_components[c]) * tolerance.position_relative)) {
+					matched = false;
+					break;
+				}
+				triangle_error.position = std::max(triangle_error.position, diff);
+			}
+			
+			const coord& c1 = src.coords[k];
+			const coord& c2 = dst.coords[(k + offset) % 3];
+			const float u_diff = fabsf(c1.u - c2.u), v_diff = fabsf(c1.v - c2.v);
+			if(!(u_diff <= std::max(fabsf(c1.u) * tolerance.coord_relative, tolerance.coord_min)) ||
+			   !(v_diff <= std::max(fabsf(c1.v) * tolerance.coord_relative, tolerance.coord_min))) {
+				matched = false;
+			}
+			triangle_error.coord = std::max(triangle_error.coord, std::max(u_diff, v_diff));
+		}
+		if(matched) {
+			error.position = std::max(error.position, triangle_error.position);
+			error.coord = std::max(error.coord, triangle_error.coord);
+			if(matched_offset != nullptr) *matched_offset = offset;
+			return true;
+		}
+	}
+	return false;
+}
+
+// matches the triangles of a sub-object in any order: the a2m triangles are sorted into a hash grid of their centroids
+// (cells are larger than the tolerance, so that the centroid of a matching triangle is always in a neighbouring cell).
+// the match of each src triangle is stored in matches (if not nullptr)
+static size_t match_unordered(const vector<verify_triangle>& src, const vector<verify_triangle>& dst, const verify_tolerance& tolerance,
+							  const float max_component, verify_error& error, size_t& first_mismatch, vector<verify_match>* matches) {
+	const double cell_size = std::max(4.0 * (tolerance.position + max_component * tolerance.position_relative), 1.0e-6);
+	auto get_cell = [&cell_size](const verify_triangle& triangle, int64_t (&cell)[3]) {
+		const float3& p0 = triangle.positions[0];
+		const float3& p1 = triangle.positions[1];
+		const float3& p2 = triangle.positions[2];
+		cell[0] = (int64_t)floor(((double)p0.x + (double)p1.x + (double)p2.x) / (3.0 * cell_size));
+		cell[1] = (int64_t)floor(((double)p0.y + (double)p1.y + (double)p2.y) / (3.0 * cell_size));
+		cell[2] = (int64_t)floor(((double)p0.z + (double)p1.z + (double)p2.z) / (3.0 * cell_size));
+	};
+	auto get_key = [](const int64_t x, const int64_t y, const int64_t z) -> uint64_t {
+		return (((uint64_t)x * 73856093ull) ^ ((uint64_t)y * 19349663ull) ^ ((uint64_t)z * 83492791ull));
+	};
+	
+	vector<pair<uint64_t, uint32_t>> cells(dst.size());
+	for(size_t i = 0; i < dst.size(); i++) {
+		int64_t cell[3];
+		get_cell(dst[i], cell);
+		cells[i] = make_pair(get_key(cell[0], cell[1], cell[2]), (uint32_t)i);
+	}
+	sort(cells.begin(), cells.end());
+	
+	vector<bool> matched(dst.size(), false);
+	size_t mismatches = 0;
+	for(size_t i = 0; i < src.size(); i++) {
+		int64_t cell[3];
+		get_cell(src[i], cell);
+		bool found = false;
+		for(int64_t dz = -1; dz <= 1 && !found; dz++) {
+			for(int64_t dy = -1; dy <= 1 && !found; dy++) {
+				for(int64_t dx = -1; dx <= 1 && !found; dx++) {
+					const uint64_t key = get_key(cell[0] + dx, cell[1] + dy, cell[2] + dz);
+					auto candidate = lower_bound(cells.cbegin(), cells.cend(), make_pair(key, (uint32_t)0));
+					for(; candidate != cells.cend() && candidate->first == key; candidate++) {
+						uint32_t offset = 0;
+						if(!matched[candidate->second] && match_triangle(src[i], dst[candidate->second], tolerance, error, &offset)) {
+							matched[candidate->second] = true;
+							found = true;
+							if(matches != nullptr) (*matches)[i] = verify_match { candidate->second, offset };
+							break;
+						}
+					}
+				}
+			}
+		}
+		if(!found && mismatches++ == 0) first_mismatch = i;
+	}
+	return mismatches;
+}
+
+// matches the triangles of sub-object #object of the obj against the a2m (see verify_a2m_model), src and dst are used as
+// scratch. the match of each obj triangle is stored in matches (if not nullptr), returns the amount of unmatched triangles
+static size_t match_sub_object(const a2m_model& a2m, const obj_model& model, const unsigned int object_index, const bool rotate_model,
+							   vector<verify_triangle>& src, vector<verify_triangle>& dst, verify_error& error, size_t& first_mismatch,
+							   vector<verify_match>* matches) {
+	const a2m_model::object& object = a2m.objects[object_index];
+	verify_tolerance tolerance { VERTEX_WELD_EPSILON, 1.0e-6f, 0.0f, 0.0f };
+	if(a2m.compact) {
+		// quantization step of the sub-object aabb and the precision of half floats
+		const float3& bmin = object.bounds_min;
+		const float3& bmax = object.bounds_max;
+		tolerance.position += std::max(std::max(bmax.x - bmin.x, bmax.y - bmin.y), bmax.z - bmin.z) / 65535.0f;
+		tolerance.coord_relative = 1.0f / 1024.0f;
+		tolerance.coord_min = 1.0f / 16384.0f;
+	}
+	
+	// the triangles are stored in obj order unless they were reordered (-optimize_cache)
+	const size_t object_triangle_count = object.triangle_count;
+	src.resize(object_triangle_count);
+	dst.resize(object_triangle_count);
+	if(matches != nullptr) matches->assign(object_triangle_count, verify_match { ~0u, 0 });
+	const s_index* indices = model.get_indices(object_index);
+	const s_index* tex_indices = model.get_tex_indices(object_index);
+	float max_component = 0.0f;
+	bool ordered = true;
+	for(size_t j = 0; j < object_triangle_count; j++) {
+		for(unsigned int k = 0; k < 3; k++) {
+			src[j].positions[k] = get_stored_vertex(model.vertices[indices[j].indices[k]], rotate_model);
+			src[j].coords[k] = model.tex_coords[tex_indices[j].indices[k]];
+			dst[j].positions[k] = a2m.vertices[a2m.indices[object.first_triangle + j].indices[k]];
+			dst[j].coords[k] = a2m.tex_coords[a2m.tex_indices[object.first_triangle + j].indices[k]];
+			max_component = std::max(max_component, std::max(std::max(fabsf(src[j].positions[k].x), fabsf(src[j].positions[k].y)),
+															  fabsf(src[j].positions[k].z)));
+		}
+		uint32_t offset = 0;
+		if(ordered && !match_triangle(src[j], dst[j], tolerance, error, &offset)) ordered = false;
+		if(ordered && matches != nullptr) (*matches)[j] = verify_match { (uint32_t)j, offset };
+	}
+	if(ordered) return 0;
+	if(matches != nullptr) matches->assign(object_triangle_count, verify_match { ~0u, 0 });
+	return match_unordered(src, dst, tolerance, max_component, error, first_mismatch, matches);
+}
+
+bool verify_a2m_model(const a2m_model& a2m, const obj_model& model, const obj_model* collision_model,
+					  const bool rotate_model, const bool rotate_collision) {
+	if(a2m.objects.size() != model.obj_names.size()) {
+		a2e_error("verify: a2m contains %u sub-objects, obj contains %u!", a2m.objects.size(), model.obj_names.size());
+		return false;
+	}
+	
+	bool valid = true;
+	verify_error error;
+	size_t triangle_count = 0;
+	vector<verify_triangle> src, dst;
+	for(unsigned int i = 0; i < (unsigned int)a2m.objects.size(); i++) {
+		const a2m_model::object& object = a2m.objects[i];
+		const string& name = model.obj_names.find(i)->second;
+		if(object.name != name) {
+			a2e_error("verify: sub-object #%u is named \"%s\" in the a2m, but \"%s\" in the obj!", i, object.name, name);
+			valid = false;
+			continue;
+		}
+		if(object.triangle_count != model.get_triangle_count(i)) {
+			a2e_error("verify: sub-object #%u \"%s\" has %u triangles in the a2m, but %u in the obj!", i, name,
+					  object.triangle_count, model.get_triangle_count(i));
+			valid = false;
+			continue;
+		}
+		
+		size_t first_mismatch = 0;
+		const size_t mismatches = match_sub_object(a2m, model, i, rotate_model, src, dst, error, first_mismatch, nullptr);
+		if(mismatches > 0) {
+			const verify_triangle& triangle = src[first_mismatch];
+			a2e_error("verify: %u of %u triangles of sub-object #%u \"%s\" have no matching triangle in the a2m (first: obj triangle #%u (%f, %f, %f) (%f, %f, %f) (%f, %f, %f))!",
+					  mismatches, object.triangle_count, i, name, first_mismatch,
+					  triangle.positions[0].x, triangle.positions[0].y, triangle.positions[0].z,
+					  triangle.positions[1].x, triangle.positions[1].y, triangle.positions[1].z,
+					  triangle.positions[2].x, triangle.positions[2].y, triangle.positions[2].z);
+			valid = false;
+		}
+		triangle_count += object.triangle_count;
+	}
+	
+	// the collision model is stored as it is (only rotated, the triangles may be reordered)
+	if(a2m.has_collision != (collision_model != nullptr)) {
+		a2e_error("verify: %s", (a2m.has_collision ? "a2m contains an unexpected collision model!" : "a2m contains no collision model!"));
+		valid = false;
+	}
+	else if(collision_model != nullptr) {
+		bool collision_valid = (a2m.collision_vertices.size() == collision_model->vertices.size() &&
+								a2m.collision_indices.size() == collision_model->get_triangle_count(0));
+		for(size_t i = 0; collision_valid && i < a2m.collision_vertices.size(); i++) {
+			const float3 vertex = get_stored_vertex(collision_model->vertices[i], rotate_collision);
+			collision_valid = (memcmp(&vertex, &a2m.collision_vertices[i], sizeof(float3)) == 0);
+		}
+		if(collision_valid && !a2m.collision_indices.empty() &&
+		   memcmp(a2m.collision_indices.data(), collision_model->get_indices(0), a2m.collision_indices.size() * sizeof(s_index)) != 0) {
+			// the triangles are stored in bvh leaf order with -collision_bvh
+			const auto less_triangle = [](const s_index& triangle_1, const s_index& triangle_2) {
+				return lexicographical_compare(triangle_1.indices, triangle_1.indices + 3, triangle_2.indices, triangle_2.indices + 3);
+			};
+			vector<s_index> a2m_triangles(a2m.collision_indices);
+			vector<s_index> obj_triangles(collision_model->get_indices(0), collision_model->get_indices(0) + a2m_triangles.size());
+			sort(a2m_triangles.begin(), a2m_triangles.end(), less_triangle);
+			sort(obj_triangles.begin(), obj_triangles.end(), less_triangle);
+			collision_valid = (memcmp(a2m_triangles.data(), obj_triangles.data(), a2m_triangles.size() * sizeof(s_index)) == 0);
+		}
+		if(!collision_valid) {
+			a2e_error("verify: the collision model of the a2m differs from the collision obj!");
+			valid = false;
+		}
+	}
+	
+	if(valid) {
+		a2e_log("verify: all %u triangles of %u sub-objects match (max position error: %f, max texture coordinate error: %f)",
+				triangle_count, a2m.objects.size(), error.position, error.coord);
+	}
+	return valid;
+}
+
+bool verify_a2m_culling_data(const a2m_model& a2m) {
+	if(!a2m.has_bounds) return true;
+	
+	// distance of a vertex outside a sphere (0 if it is inside)
+	const auto sphere_distance = [](const float3& vertex, const float* center, const float radius) {
+		const double dx = (double)vertex.x - (double)center[0];
+		const double dy = (double)vertex.y - (double)center[1];
+		const double dz = (double)vertex.z - (double)center[2];
+		return std::max(sqrt(dx * dx + dy * dy + dz * dz) - (double)radius, 0.0);
+	};
+	
+	bool valid = true;
+	vector<unsigned char> used_vertices(a2m.vertices.size(), 0);
+	vector<unsigned int> meshlet_vertices;
+	for(unsigned int i = 0; i < (unsigned int)a2m.objects.size(); i++) {
+		const a2m_model::object& object = a2m.objects[i];
+		if(object.triangle_count == 0) continue;
+		
+		// the compact vertices are dequantized, so they may lie outside of the bounds by a quantization step
+		const float3& bmin = object.bounds_min;
+		const float3& bmax = object.bounds_max;
+		const float tolerance = (a2m.compact ?
+								 std::max(std::max(bmax.x - bmin.x, bmax.y - bmin.y), bmax.z - bmin.z) / 65535.0f : 0.0f);
+		const float sphere_center[3] { object.sphere_center.x, object.sphere_center.y, object.sphere_center.z };
+		size_t outside_count = 0;
+		for(size_t j = object.first_triangle; j < object.first_triangle + object.triangle_count; j++) {
+			for(unsigned int k = 0; k < 3; k++) {
+				const float3& vertex = a2m.vertices[a2m.indices[j].indices[k]];
+				if(vertex.x < bmin.x - tolerance || vertex.y < bmin.y - tolerance || vertex.z < bmin.z - tolerance ||
+				   vertex.x > bmax.x + tolerance || vertex.y > bmax.y + tolerance || vertex.z > bmax.z + tolerance ||
+				   sphere_distance(vertex, sphere_center, object.sphere_radius) > (double)tolerance * 2.0) {
+					outside_count++;
+				}
+			}
+		}
+		if(outside_count > 0) {
+			a2e_error("verify: %u vertices of sub-object #%u \"%s\" lie outside of its bounds!", outside_count, i, object.name);
+			valid = false;
+		}
+		
+		// the meshlets must cover the triangles of the sub-object in order
+		if(a2m.meshlets.empty()) continue;
+		size_t next_triangle = object.first_triangle;
+		for(size_t m = object.first_meshlet; m < object.first_meshlet + object.meshlet_count; m++) {
+			const a2m_v3_meshlet& object_meshlet = a2m.meshlets[m];
+			if(object_meshlet.first_triangle != next_triangle || object_meshlet.triangle_count == 0 ||
+			   object_meshlet.triangle_count > MESHLET_MAX_TRIANGLES) {
+				a2e_error("verify: meshlet #%u of sub-object #%u \"%s\" has an invalid triangle range!", m, i, object.name);
+				valid = false;
+				break;
+			}
+			next_triangle += object_meshlet.triangle_count;
+			
+			meshlet_vertices.clear();
+			size_t outside_vertex_count = 0, outside_normal_count = 0;
+			const bool has_cone = (object_meshlet.cone_cutoff < 1.0f);
+			const float min_dot = sqrtf(std::max(1.0f - object_meshlet.cone_cutoff * object_meshlet.cone_cutoff, 0.0f));
+			for(size_t j = object_meshlet.first_triangle; j < object_meshlet.first_triangle + object_meshlet.triangle_count; j++) {
+				const s_index& triangle = a2m.indices[j];
+				for(unsigned int k = 0; k < 3; k++) {
+					const unsigned int index = triangle.indices[k];
+					if(used_vertices[index] == 0) {
+						used_vertices[index] = 1;
+						meshlet_vertices.push_back(index);
+					}
+					if(sphere_distance(a2m.vertices[index], object_meshlet.sphere_center, object_meshlet.sphere_radius) > (double)tolerance * 2.0) {
+						outside_vertex_count++;
+					}
+				}
+				if(!has_cone || a2m.compact) continue;
+				
+				const float3& v0 = a2m.vertices[triangle.indices[0]];
+				const float3& v1 = a2m.vertices[triangle.indices[1]];
+				const float3& v2 = a2m.vertices[triangle.indices[2]];
+				const float3 e1(v1.x - v0.x, v1.y - v0.y, v1.z - v0.z);
+				const float3 e2(v2.x - v0.x, v2.y - v0.y, v2.z - v0.z);
+				const float3 normal(e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x);
+				const float length = sqrtf(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+				if(!(length > 0.0f)) continue;
+				const float* axis = object_meshlet.cone_axis;
+				if((normal.x * axis[0] + normal.y * axis[1] + normal.z * axis[2]) / length < min_dot - 1.0e-3f) {
+					outside_normal_count++;
+				}
+			}
+			for(const auto& index : meshlet_vertices) {
+				used_vertices[index] = 0;
+			}
+			
+			if(meshlet_vertices.size() != object_meshlet.vertex_count || meshlet_vertices.size() > MESHLET_MAX_VERTICES) {
+				a2e_error("verify: meshlet #%u of sub-object #%u \"%s\" has %u vertices (stored: %u)!", m, i, object.name,
+						  meshlet_vertices.size(), object_meshlet.vertex_count);
+				valid = false;
+			}
+			if(outside_vertex_count > 0 || outside_normal_count > 0) {
+				a2e_error("verify: meshlet #%u of sub-object #%u \"%s\" has %u vertices outside of its sphere and %u normals outside of its cone!",
+						  m, i, object.name, outside_vertex_count, outside_normal_count);
+				valid = false;
+			}
+		}
+		if(next_triangle != object.first_triangle + object.triangle_count) {
+			a2e_error("verify: the meshlets of sub-object #%u \"%s\" don't cover all of its triangles!", i, object.name);
+			valid = false;
+		}
+	}
+	
+	if(valid) {
+		a2e_log("verify: culling data of %u sub-objects (%u meshlets) is valid", a2m.objects.size(), a2m.meshlets.size());
+	}
+	return valid;
+}
+
+bool verify_a2m_lods(const a2m_model& a2m) {
+	if(a2m.lods.empty()) return true;
+	
+	bool valid = true;
+	const size_t object_count = a2m.objects.size();
+	const size_t lod_count = a2m.lods.size() / object_count;
+	vector<size_t> level_triangle_counts(lod_count, 0);
+	unordered_set<uint64_t> corners;
+	for(size_t i = 0; i < object_count; i++) {
+		const a2m_model::object& object = a2m.objects[i];
+		corners.clear();
+		for(size_t j = object.first_triangle; j < object.first_triangle + object.triangle_count; j++) {
+			for(unsigned int k = 0; k < 3; k++) {
+				corners.insert(((uint64_t)a2m.indices[j].indices[k] << 32ull) | (uint64_t)a2m.tex_indices[j].indices[k]);
+			}
+		}
+		
+		size_t prev_triangle_count = object.triangle_count;
+		float prev_error = 0.0f;
+		for(size_t level = 0; level < lod_count; level++) {
+			const a2m_v3_lod& lod = a2m.lods[level * object_count + i];
+			level_triangle_counts[level] += lod.triangle_count;
+			if(lod.triangle_count > prev_triangle_count || !(lod.error >= prev_error) || !(lod.error < FLT_MAX)) {
+				a2e_error("verify: lod #%u of sub-object #%u \"%s\" has more triangles or a smaller error than the previous one!",
+						  level + 1, i, object.name);
+				valid = false;
+			}
+			prev_triangle_count = lod.triangle_count;
+			prev_error = lod.error;
+			
+			size_t invalid_count = 0;
+			for(size_t j = lod.first_triangle; j < lod.first_triangle + lod.triangle_count; j++) {
+				const unsigned int* triangle = a2m.lod_indices[j].indices;
+				if(triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2]) {
+					invalid_count++;
+					continue;
+				}
+				for(unsigned int k = 0; k < 3; k++) {
+					if(corners.count(((uint64_t)triangle[k] << 32ull) | (uint64_t)a2m.lod_tex_indices[j].indices[k]) == 0) {
+						invalid_count++;
+						break;
+					}
+				}
+			}
+			if(invalid_count > 0) {
+				a2e_error("verify: %u triangles of lod #%u of sub-object #%u \"%s\" are degenerate or use corners that don't exist in the sub-object!",
+						  invalid_count, level + 1, i, object.name);
+				valid = false;
+			}
+		}
+	}
+	
+	if(valid) {
+		stringstream triangle_counts;
+		for(const auto& count : level_triangle_counts) {
+			triangle_counts << " -> " << count;
+		}
+		a2e_log("verify: %u lods of %u sub-objects are valid (%u triangles%s)", lod_count, object_count, a2m.indices.size(), triangle_counts.str());
+	}
+	return valid;
+}
+
+bool verify_a2m_interleaved(const a2m_model& a2m) {
+	if(!a2m.interleaved) return true;
+	
+	bool valid = true;
+	vector<bool> used;
+	unordered_set<string> unique_vertices;
+	for(size_t i = 0; i < a2m.objects.size(); i++) {
+		const a2m_model::object& object = a2m.objects[i];
+		
+		// every triangle must index the vertices of its own sub-object, and all of them must be used
+		used.assign(object.vertex_count, false);
+		size_t foreign_count = 0;
+		for(size_t j = object.first_triangle; j < object.first_triangle + object.triangle_count; j++) {
+			for(unsigned int k = 0; k < 3; k++) {
+				const unsigned int index = a2m.indices[j].indices[k];
+				if(index < object.first_vertex || index >= object.first_vertex + object.vertex_count) foreign_count++;
+				else used[index - object.first_vertex] = true;
+			}
+		}
+		const size_t unused_count = (size_t)count(used.begin(), used.end(), false);
+		
+		// no two vertices of a sub-object may be equal (bitwise)
+		unique_vertices.clear();
+		size_t duplicate_count = 0;
+		for(size_t j = object.first_vertex; j < object.first_vertex + object.vertex_count; j++) {
+			string key((const char*)&a2m.vertices[j], sizeof(float3));
+			key.append((const char*)&a2m.tex_coords[j], sizeof(coord));
+			if(!a2m.normals.empty()) key.append((const char*)&a2m.normals[j], sizeof(float3));
+			if(!a2m.tangents.empty()) key.append((const char*)&a2m.tangents[j], sizeof(vertex_tangent));
+			if(!unique_vertices.insert(key).second) duplicate_count++;
+		}
+		
+		if(foreign_count > 0 || unused_count > 0 || duplicate_count > 0) {
+			a2e_error("verify: interleaved sub-object #%u \"%s\" has %u indices outside of its vertices, %u unused and %u duplicate vertices!",
+					  i, object.name, foreign_count, unused_count, duplicate_count);
+			valid = false;
+		}
+	}
+	
+	if(valid) {
+		a2e_log("verify: %u interleaved vertices of %u sub-objects are unique (%f vertices per triangle)", a2m.vertices.size(), a2m.objects.size(),
+				(a2m.indices.empty() ? 0.0 : (double)a2m.vertices.size() / (double)a2m.indices.size()));
+	}
+	return valid;
+}
+
+// double precision vector of the reference normals
+struct verify_vector {
+	double x = 0.0, y = 0.0, z = 0.0;
+	
+	verify_vector() {}
+	verify_vector(const double x_, const double y_, const double z_) : x(x_), y(y_), z(z_) {}
+	verify_vector(const float3& v) : x(v.x), y(v.y), z(v.z) {}
+	verify_vector operator-(const verify_vector& v) const { return verify_vector(x - v.x, y - v.y, z - v.z); }
+	verify_vector operator*(const double f) const { return verify_vector(x * f, y * f, z * f); }
+	verify_vector& operator+=(const verify_vector& v) { x += v.x; y += v.y; z += v.z; return *this; }
+	double dot(const verify_vector& v) const { return x * v.x + y * v.y + z * v.z; }
+	double length() const { return sqrt(dot(*this)); }
+	verify_vector cross(const verify_vector& v) const { return verify_vector(y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x); }
+};
+
+// the expected normal of a corner: the obj normal, the face normal ("s off") or the (angle weighted) sum of the
+// smoothing group at the corner position (smoothed_index)
+struct verify_corner_normal {
+	uint32_t vertex = ~0u;
+	uint32_t smoothed_index = ~0u;
+	bool skip = true;
+	verify_vector normal;
+};
+
+// checks the a2m normals of sub-object #object against the normals computed from the obj: the obj normal of a corner
+// if it has one, otherwise the face normal for smoothing group 0, otherwise the angle weighted sum of the face normals
+// of all corners at the same (welded) position in the same smoothing group. returns the amount of mismatching corners
+static size_t verify_object_normals(const a2m_model& a2m, const obj_model& model, const unsigned int object_index,
+									const bool rotate_model, const vector<verify_match>& matches, size_t& checked_count,
+									size_t& first_mismatch, float& max_error) {
+	static const double max_normal_error = 1.0e-4; // 1 - cos(angle)
+	const a2m_model::object& object = a2m.objects[object_index];
+	const s_index* normal_indices = model.get_normal_indices(object_index);
+	const unsigned int* smoothing_groups = model.get_smoothing_groups(object_index);
+	
+	vector<verify_corner_normal> corners(matches.size() * 3);
+	vector<verify_vector> smoothed_normals;
+	vector<double> smoothed_weights;
+	unordered_map<string, uint32_t> smoothed_indices;
+	for(size_t j = 0; j < matches.size(); j++) {
+		const s_index& triangle = a2m.indices[object.first_triangle + matches[j].triangle];
+		uint32_t vertex_indices[3];
+		verify_vector positions[3];
+		for(unsigned int k = 0; k < 3; k++) {
+			vertex_indices[k] = triangle.indices[(k + matches[j].offset) % 3];
+			positions[k] = a2m.vertices[vertex_indices[k]];
+		}
+		const verify_vector face_normal = (positions[1] - positions[0]).cross(positions[2] - positions[0]);
+		const double face_length = face_normal.length();
+		const unsigned int group = (smoothing_groups != nullptr ? smoothing_groups[j] : 1);
+		for(unsigned int k = 0; k < 3; k++) {
+			verify_corner_normal& corner = corners[j * 3 + k];
+			corner.vertex = vertex_indices[k];
+			const unsigned int normal_index = (normal_indices != nullptr ? normal_indices[j].indices[k] : ~0u);
+			if(normal_index < model.normals.size()) {
+				const verify_vector normal = get_stored_vertex(model.normals[normal_index], rotate_model);
+				const double normal_length = normal.length();
+				corner.skip = !(normal_length > 0.0 && normal_length < DBL_MAX);
+				if(!corner.skip) corner.normal = normal * (1.0 / normal_length);
+			}
+			else if(group == 0) {
+				corner.skip = !(face_length > 0.0);
+				if(!corner.skip) corner.normal = face_normal * (1.0 / face_length);
+			}
+			else {
+				string key((const char*)&a2m.vertices[vertex_indices[k]], sizeof(float3));
+				key.append((const char*)&group, sizeof(group));
+				const auto smoothed = smoothed_indices.emplace(key, (uint32_t)smoothed_normals.size());
+				if(smoothed.second) {
+					smoothed_normals.emplace_back();
+					smoothed_weights.push_back(0.0);
+				}
+				corner.smoothed_index = smoothed.first->second;
+				corner.skip = false;
+				if(!(face_length > 0.0)) continue;
+				
+				const verify_vector e1 = positions[(k + 1) % 3] - positions[k];
+				const verify_vector e2 = positions[(k + 2) % 3] - positions[k];
+				const double edge_lengths = e1.length() * e2.length();
+				if(!(edge_lengths > 0.0)) continue;
+				const double angle = acos(std::max(-1.0, std::min(1.0, e1.dot(e2) / edge_lengths)));
+				smoothed_normals[corner.smoothed_index] += face_normal * (angle / face_length);
+				smoothed_weights[corner.smoothed_index] += angle;
+			}
+		}
+	}
+	
+	size_t mismatches = 0;
+	for(size_t i = 0; i < corners.size(); i++) {
+		verify_corner_normal& corner = corners[i];
+		if(corner.smoothed_index != ~0u) {
+			// the direction of (nearly) cancelling face normals isn't well defined
+			const verify_vector& sum = smoothed_normals[corner.smoothed_index];
+			const double sum_length = sum.length();
+			corner.skip = !(sum_length > 0.01 * smoothed_weights[corner.smoothed_index]);
+			if(!corner.skip) corner.normal = sum * (1.0 / sum_length);
+		}
+		if(corner.skip) continue;
+		
+		const double error = 1.0 - corner.normal.dot(a2m.normals[corner.vertex]);
+		max_error = std::max(max_error, (float)error);
+		checked_count++;
+		if(!(error <= max_normal_error)) {
+			if(mismatches == 0) first_mismatch = i;
+			mismatches++;
+		}
+	}
+	return mismatches;
+}
+
+bool verify_a2m_normals(const a2m_model& a2m, const obj_model& model, const bool rotate_model) {
+	if(a2m.normals.empty()) return true;
+	
+	static const float max_error = 0.001f;
+	size_t invalid_normals = 0, invalid_tangents = 0;
+	for(size_t i = 0; i < a2m.normals.size(); i++) {
+		const float3& normal = a2m.normals[i];
+		const float normal_length = sqrtf(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+		if(!(fabsf(normal_length - 1.0f) <= max_error)) invalid_normals++;
+		if(a2m.tangents.empty()) continue;
+		
+		const vertex_tangent& tangent = a2m.tangents[i];
+		const float tangent_length = sqrtf(tangent.x * tangent.x + tangent.y * tangent.y + tangent.z * tangent.z);
+		const float normal_dot = normal.x * tangent.x + normal.y * tangent.y + normal.z * tangent.z;
+		if(!(fabsf(tangent_length - 1.0f) <= max_error) || !(fabsf(normal_dot) <= max_error) ||
+		   (tangent.w != 1.0f && tangent.w != -1.0f)) {
+			invalid_tangents++;
+		}
+	}
+	
+	if(invalid_normals > 0 || invalid_tangents > 0) {
+		a2e_error("verify: %u normals aren't unit length, %u tangents aren't unit length, orthogonal to their normal or have an invalid handedness!",
+				  invalid_normals, invalid_tangents);
+		return false;
+	}
+	
+	// compare the normals against the obj normals and smoothing groups (sub-objects whose triangles don't match
+	// are already reported by verify_a2m_model)
+	if(a2m.objects.size() != model.obj_names.size()) return false;
+	bool valid = true;
+	verify_error error;
+	size_t checked_count = 0;
+	float max_normal_error = 0.0f;
+	vector<verify_triangle> src, dst;
+	vector<verify_match> matches;
+	for(unsigned int i = 0; i < (unsigned int)a2m.objects.size(); i++) {
+		const a2m_model::object& object = a2m.objects[i];
+		if(object.triangle_count != model.get_triangle_count(i)) continue;
+		size_t first_mismatch = 0;
+		if(match_sub_object(a2m, model, i, rotate_model, src, dst, error, first_mismatch, &matches) > 0) continue;
+		
+		const size_t mismatches = verify_object_normals(a2m, model, i, rotate_model, matches, checked_count, first_mismatch,
+														max_normal_error);
+		if(mismatches > 0) {
+			const verify_triangle& triangle = src[first_mismatch / 3];
+			const float3& normal = a2m.normals[a2m.indices[object.first_triangle + matches[first_mismatch / 3].triangle]
+											   .indices[(first_mismatch % 3 + matches[first_mismatch / 3].offset) % 3]];
+			a2e_error("verify: %u corner normals of sub-object #%u \"%s\" don't match the obj normals/smoothing groups (first: obj triangle #%u corner #%u at (%f, %f, %f) has the normal (%f, %f, %f))!",
+					  mismatches, i, object.name, first_mismatch / 3, first_mismatch % 3,
+					  triangle.positions[first_mismatch % 3].x, triangle.positions[first_mismatch % 3].y,
+					  triangle.positions[first_mismatch % 3].z, normal.x, normal.y, normal.z);
+			valid = false;
+		}
+	}
+	if(!valid) return false;
+	
+	a2e_log("verify: %u normals%s are valid, %u corner normals match the obj (max error: %f)", a2m.normals.size(),
+			(a2m.tangents.empty() ? "" : " and tangents"), checked_count, max_normal_error);
+	return true;
+}
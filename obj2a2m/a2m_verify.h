@@ -0,0 +1,60 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_A2M_VERIFY_H__
+#define __OBJ2A2M_A2M_VERIFY_H__
+
+#include <a2e.h>
+#include "obj_model.h"
+#include "a2m_reader.h"
+
+// compares a decoded a2m model against the .obj model it was converted from: the sub-objects must have the same
+// names and triangle counts, every triangle must have a matching triangle (in any order, with the same winding)
+// whose corner positions are within the welding epsilon (plus the quantization error of the compact encoding)
+// and whose texture coordinates are equal (within the half float error of the compact encoding), and the collision
+// model (if any) must be stored unchanged (except for its triangle order, see -collision_bvh). vertices are rotated
+// before comparing them if rotate_model/rotate_collision is set. mismatches are logged, returns true if the models match
+bool verify_a2m_model(const a2m_model& a2m, const obj_model& model, const obj_model* collision_model,
+					  const bool rotate_model, const bool rotate_collision);
+
+// checks the culling data of the a2m against its own vertices and triangles: all vertices of a sub-object must lie
+// within its aabb and bounding sphere, its meshlets must cover its triangles in order and respect the meshlet limits,
+// the vertices of a meshlet must lie within its sphere and the normals of its triangles within its cone (the cones
+// aren't checked for the compact encoding, whose quantized vertices may turn the normals of small triangles).
+// mismatches are logged, returns true if the data is consistent (or the a2m contains no culling data)
+bool verify_a2m_culling_data(const a2m_model& a2m);
+
+// checks the lod chain of the a2m against its full resolution triangles: the triangle counts of each sub-object must
+// not increase from lod to lod, no triangle may use a vertex twice and every corner of a lod triangle must be a corner
+// (vertex + texture coordinate pair) of the full resolution sub-object (so that no uv seam was moved).
+// mismatches are logged, returns true if the lods are consistent (or the a2m contains none)
+bool verify_a2m_lods(const a2m_model& a2m);
+
+// checks the interleaved encoding of the a2m: the triangles of each sub-object must only index (and use all of)
+// its own interleaved vertices, and no two of these may be equal (see interleaved_builder).
+// mismatches are logged, returns true if the vertices are unified (or the a2m isn't interleaved)
+bool verify_a2m_interleaved(const a2m_model& a2m);
+
+// checks the normals and tangents of the a2m: every normal and tangent must be unit length, every tangent must be
+// orthogonal to its normal and have a handedness of +1 or -1. the normal of each corner must also match the normal
+// computed from the obj (model must have been loaded with normals): its vn normal if it has one, otherwise the face
+// normal ("s off") or the angle weighted normal of its smoothing group. mismatches are logged, returns true if they
+// are valid (or the a2m contains no normals)
+bool verify_a2m_normals(const a2m_model& a2m, const obj_model& model, const bool rotate_model);
+
+#endif
@@ -0,0 +1,264 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "a2m_writer.h"
+
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <climits>
+#include <cerrno>
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// conversion kernels
+
+void rotate_vertices(float* data, const size_t count) {
+	size_t i = 0;
+#if defined(A2M_WRITER_SSE2)
+	// 4 vertices (3 registers) per iteration:
+	// a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3 -> x0 z0 -y0 x1, z1 -y1 x2 z2, -y2 x3 z3 -y3
+	const __m128 sign_0 = _mm_castsi128_ps(_mm_set_epi32(0, (int)0x80000000, 0, 0));
+	const __m128 sign_1 = _mm_castsi128_ps(_mm_set_epi32(0, 0, (int)0x80000000, 0));
+	const __m128 sign_2 = _mm_castsi128_ps(_mm_set_epi32((int)0x80000000, 0, 0, (int)0x80000000));
+	for(; i + 4 <= count; i += 4) {
+		float* vertices = data + i * 3;
+		const __m128 a = _mm_loadu_ps(vertices);
+		const __m128 b = _mm_loadu_ps(vertices + 4);
+		const __m128 c = _mm_loadu_ps(vertices + 8);
+		
+		const __m128 out_0 = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 2, 0));
+		const __m128 x2_z2 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 0, 2, 2));
+		const __m128 out_1 = _mm_shuffle_ps(b, x2_z2, _MM_SHUFFLE(2, 0, 0, 1));
+		const __m128 y2_x3 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 3, 3));
+		const __m128 out_2 = _mm_shuffle_ps(y2_x3, c, _MM_SHUFFLE(2, 3, 2, 0));
+		
+		_mm_storeu_ps(vertices, _mm_xor_ps(out_0, sign_0));
+		_mm_storeu_ps(vertices + 4, _mm_xor_ps(out_1, sign_1));
+		_mm_storeu_ps(vertices + 8, _mm_xor_ps(out_2, sign_2));
+	}
+#endif
+	for(; i < count; i++) {
+		float* vertex = data + i * 3;
+		const float y = vertex[1];
+		vertex[1] = vertex[2];
+		vertex[2] = -y;
+	}
+}
+
+static inline unsigned int swap_bytes(const unsigned int ui) {
+	return (((ui & 0xFF) << 24) | ((ui & 0xFF00) << 8) | ((ui & 0xFF0000) >> 8) | ((ui & 0xFF000000) >> 24));
+}
+
+void store_uints_big_endian(unsigned char* dst, const unsigned int* uints, const size_t count) {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+	memcpy(dst, uints, count * sizeof(unsigned int));
+#else
+	size_t i = 0;
+#if defined(A2M_WRITER_SSE2)
+	// swap the bytes of each 16-bit half, then swap the halves
+	for(; i + 4 <= count; i += 4) {
+		const __m128i value = _mm_loadu_si128((const __m128i*)(uints + i));
+		__m128i swapped = _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+		swapped = _mm_shufflelo_epi16(swapped, _MM_SHUFFLE(2, 3, 0, 1));
+		swapped = _mm_shufflehi_epi16(swapped, _MM_SHUFFLE(2, 3, 0, 1));
+		_mm_storeu_si128((__m128i*)(dst + i * sizeof(unsigned int)), swapped);
+	}
+#endif
+	for(; i < count; i++) {
+		const unsigned int swapped = swap_bytes(uints[i]);
+		memcpy(dst + i * sizeof(unsigned int), &swapped, sizeof(unsigned int));
+	}
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// a2m_buffer
+
+void a2m_buffer::reserve(const size_t size) {
+	if(size <= capacity) return;
+	unique_ptr<unsigned char[]> new_buffer(new unsigned char[size]);
+	if(cur_size > 0) memcpy(new_buffer.get(), buffer.get(), cur_size);
+	buffer = move(new_buffer);
+	capacity = size;
+}
+
+unsigned char* a2m_buffer::grow(const size_t size) {
+	if(cur_size + size > capacity) {
+		reserve(std::max(cur_size + size, capacity * 2));
+	}
+	unsigned char* ptr = buffer.get() + cur_size;
+	cur_size += size;
+	return ptr;
+}
+
+void a2m_buffer::put_block(const void* block, const size_t size) {
+	if(size == 0) return;
+	memcpy(grow(size), block, size);
+}
+
+void a2m_buffer::put_terminated_block(const string& str, const char term) {
+	put_block(str.c_str(), str.size());
+	put_char((unsigned char)term);
+}
+
+void a2m_buffer::put_char(const unsigned char ch) {
+	*grow(1) = ch;
+}
+
+void a2m_buffer::put_uint(const unsigned int ui) {
+	store_uints_big_endian(grow(sizeof(unsigned int)), &ui, 1);
+}
+
+void a2m_buffer::put_uints(const unsigned int* uints, const size_t count) {
+	store_uints_big_endian(grow(count * sizeof(unsigned int)), uints, count);
+}
+
+void a2m_buffer::put_float(const float f) {
+	put_block(&f, sizeof(float));
+}
+
+void a2m_buffer::put_floats(const float* floats, const size_t count) {
+	put_block(floats, count * sizeof(float));
+}
+
+void a2m_buffer::put_vertices(const float3* vertices, const size_t count, const bool rotate) {
+	static_assert(sizeof(float3) == sizeof(float) * 3, "float3 must be tightly packed");
+	if(count == 0) return;
+	unsigned char* dst = grow(count * sizeof(float3));
+	memcpy(dst, vertices, count * sizeof(float3));
+	// dst is only 1-byte aligned, but rotate_vertices only uses unaligned loads/stores
+	if(rotate) rotate_vertices((float*)dst, count);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// output
+
+static bool write_buffered(const char* filename, const vector<a2m_block>& blocks) {
+	file_io f;
+	if(!f.open(filename, file_io::OPEN_TYPE::WRITE_BINARY)) {
+		a2e_error("couldn't open/write a2m file \"%s\"!", filename);
+		return false;
+	}
+	for(const auto& block : blocks) {
+		if(block.size == 0) continue;
+		f.write_block((const char*)block.data, block.size);
+	}
+	f.close();
+	return true;
+}
+
+#ifndef WIN32
+static bool write_gathered(const char* filename, const vector<a2m_block>& blocks) {
+	const int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(fd < 0) {
+		a2e_error("couldn't open/write a2m file \"%s\"!", filename);
+		return false;
+	}
+	
+	vector<iovec> iovecs;
+	for(const auto& block : blocks) {
+		if(block.size == 0) continue;
+		iovecs.push_back(iovec { (void*)block.data, block.size });
+	}
+	
+	// writev may write less than requested -> continue behind the last written byte
+	size_t first = 0;
+	while(first < iovecs.size()) {
+		const int iovec_count = (int)std::min(iovecs.size() - first, (size_t)IOV_MAX);
+		const ssize_t written = writev(fd, &iovecs[first], iovec_count);
+		if(written < 0) {
+			if(errno == EINTR) continue;
+			a2e_error("couldn't write a2m file \"%s\": %s", filename, strerror(errno));
+			close(fd);
+			return false;
+		}
+		size_t remaining = (size_t)written;
+		while(first < iovecs.size() && remaining >= iovecs[first].iov_len) {
+			remaining -= iovecs[first].iov_len;
+			first++;
+		}
+		if(remaining > 0) {
+			iovecs[first].iov_base = (unsigned char*)iovecs[first].iov_base + remaining;
+			iovecs[first].iov_len -= remaining;
+		}
+	}
+	close(fd);
+	return true;
+}
+
+static bool write_mapped(const char* filename, const vector<a2m_block>& blocks) {
+	size_t file_size = 0;
+	for(const auto& block : blocks) {
+		file_size += block.size;
+	}
+	
+	const int fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if(fd < 0) {
+		a2e_error("couldn't open/write a2m file \"%s\"!", filename);
+		return false;
+	}
+	if(file_size == 0) {
+		close(fd);
+		return true;
+	}
+	if(ftruncate(fd, (off_t)file_size) != 0) {
+		a2e_error("couldn't resize a2m file \"%s\": %s", filename, strerror(errno));
+		close(fd);
+		return false;
+	}
+	
+	void* mapping = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if(mapping == MAP_FAILED) {
+		a2e_error("couldn't map a2m file \"%s\": %s", filename, strerror(errno));
+		close(fd);
+		return false;
+	}
+	unsigned char* dst = (unsigned char*)mapping;
+	for(const auto& block : blocks) {
+		if(block.size == 0) continue;
+		memcpy(dst, block.data, block.size);
+		dst += block.size;
+	}
+	munmap(mapping, file_size);
+	close(fd);
+	return true;
+}
+#endif
+
+bool write_a2m_blocks(const char* filename, const vector<a2m_block>& blocks, const A2M_WRITE_MODE mode) {
+#ifndef WIN32
+	switch(mode) {
+		case A2M_WRITE_MODE::WRITEV: return write_gathered(filename, blocks);
+		case A2M_WRITE_MODE::MMAP: return write_mapped(filename, blocks);
+		case A2M_WRITE_MODE::BUFFERED: break;
+	}
+#endif
+	return write_buffered(filename, blocks);
+}
+
+bool write_a2m_buffers(const char* filename, const vector<a2m_buffer>& buffers, const A2M_WRITE_MODE mode) {
+	vector<a2m_block> blocks;
+	blocks.reserve(buffers.size());
+	for(const auto& buffer : buffers) {
+		blocks.push_back(a2m_block { buffer.data(), buffer.size() });
+	}
+	return write_a2m_blocks(filename, blocks, mode);
+}
@@ -0,0 +1,94 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_A2M_WRITER_H__
+#define __OBJ2A2M_A2M_WRITER_H__
+
+#include <a2e.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define A2M_WRITER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// byte buffer that already contains the on-disk encoding of (a part of) an a2m file:
+// the encoding is the same as the one of file_io (uints are stored big endian, floats as they are in memory)
+class a2m_buffer {
+public:
+	a2m_buffer() {}
+	a2m_buffer(a2m_buffer&& buffer) = default;
+	a2m_buffer& operator=(a2m_buffer&& buffer) = default;
+	
+	void reserve(const size_t size);
+	void clear() { cur_size = 0; }
+	
+	void put_block(const void* block, const size_t size);
+	void put_terminated_block(const string& str, const char term);
+	void put_char(const unsigned char ch);
+	void put_uint(const unsigned int ui);
+	void put_uints(const unsigned int* uints, const size_t count);
+	void put_float(const float f);
+	void put_floats(const float* floats, const size_t count);
+	// appends all vertices, these are rotated if rotate is set (see rotate_vertices)
+	void put_vertices(const float3* vertices, const size_t count, const bool rotate);
+	
+	const unsigned char* data() const { return buffer.get(); }
+	size_t size() const { return cur_size; }
+	
+protected:
+	unique_ptr<unsigned char[]> buffer;
+	size_t cur_size = 0;
+	size_t capacity = 0;
+	
+	// makes room for size more bytes and returns the current end of the buffer
+	unsigned char* grow(const size_t size);
+	
+	a2m_buffer(const a2m_buffer&) = delete;
+	a2m_buffer& operator=(const a2m_buffer&) = delete;
+	
+};
+
+// (x, y, z) -> (x, z, -y) for count vertices that are stored as consecutive xyz floats
+void rotate_vertices(float* data, const size_t count);
+
+// stores count uints as big endian uints in dst (dst and uints may not overlap)
+void store_uints_big_endian(unsigned char* dst, const unsigned int* uints, const size_t count);
+
+// how the a2m buffers are written to the file:
+//  * BUFFERED: one large write per buffer through file_io
+//  * WRITEV: all buffers with a single gathering writev call (posix only, falls back to BUFFERED)
+//  * MMAP: the file is mapped and all buffers are copied into it (posix only, falls back to BUFFERED)
+enum class A2M_WRITE_MODE : unsigned int {
+	BUFFERED,
+	WRITEV,
+	MMAP,
+};
+
+// writes all buffers in order to the file, returns false on failure
+bool write_a2m_buffers(const char* filename, const vector<a2m_buffer>& buffers, const A2M_WRITE_MODE mode);
+
+// already encoded a2m data that is stored elsewhere (e.g. in a mapped spill file)
+struct a2m_block {
+	const unsigned char* data;
+	size_t size;
+};
+
+// writes all blocks in order to the file, returns false on failure
+bool write_a2m_blocks(const char* filename, const vector<a2m_block>& blocks, const A2M_WRITE_MODE mode);
+
+#endif
@@ -0,0 +1,410 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "collision_bvh.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// construction
+
+struct bvh_bounds {
+	float min[3] { FLT_MAX, FLT_MAX, FLT_MAX };
+	float max[3] { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	
+	void extend(const float3& point) {
+		min[0] = std::min(min[0], point.x);
+		min[1] = std::min(min[1], point.y);
+		min[2] = std::min(min[2], point.z);
+		max[0] = std::max(max[0], point.x);
+		max[1] = std::max(max[1], point.y);
+		max[2] = std::max(max[2], point.z);
+	}
+	void extend(const bvh_bounds& bounds) {
+		for(unsigned int k = 0; k < 3; k++) {
+			min[k] = std::min(min[k], bounds.min[k]);
+			max[k] = std::max(max[k], bounds.max[k]);
+		}
+	}
+	bool is_empty() const { return (min[0] > max[0]); }
+	// half of the surface area (the sah only needs ratios)
+	float area() const {
+		if(is_empty()) return 0.0f;
+		const float extent[3] { max[0] - min[0], max[1] - min[1], max[2] - min[2] };
+		return extent[0] * extent[1] + extent[1] * extent[2] + extent[2] * extent[0];
+	}
+};
+
+struct bvh_build_task {
+	size_t first;
+	size_t count;
+	// node whose second child offset must be set to the node of this task (~0 for first children and the root)
+	size_t parent;
+};
+
+// bin of a centroid along an axis (the same mapping is used for binning and partitioning)
+static unsigned int get_bin(const float centroid, const float centroid_min, const float bin_scale) {
+	const int bin = (int)((centroid - centroid_min) * bin_scale);
+	return (unsigned int)std::min(std::max(bin, 0), (int)COLLISION_BVH_BIN_COUNT - 1);
+}
+
+void build_collision_bvh(const float3* vertices, vector<s_index>& triangles, vector<collision_bvh_node>& nodes) {
+	nodes.clear();
+	if(triangles.empty()) return;
+	
+	const size_t triangle_count = triangles.size();
+	vector<bvh_bounds> triangle_bounds(triangle_count);
+	vector<float3> centroids(triangle_count);
+	for(size_t i = 0; i < triangle_count; i++) {
+		const float3& v0 = vertices[triangles[i].indices[0]];
+		const float3& v1 = vertices[triangles[i].indices[1]];
+		const float3& v2 = vertices[triangles[i].indices[2]];
+		triangle_bounds[i].extend(v0);
+		triangle_bounds[i].extend(v1);
+		triangle_bounds[i].extend(v2);
+		centroids[i] = float3((v0.x + v1.x + v2.x) / 3.0f, (v0.y + v1.y + v2.y) / 3.0f, (v0.z + v1.z + v2.z) / 3.0f);
+	}
+	const auto get_centroid = [&centroids](const uint32_t triangle, const unsigned int axis) {
+		return (axis == 0 ? centroids[triangle].x : (axis == 1 ? centroids[triangle].y : centroids[triangle].z));
+	};
+	
+	vector<uint32_t> order(triangle_count);
+	for(size_t i = 0; i < triangle_count; i++) {
+		order[i] = (uint32_t)i;
+	}
+	nodes.reserve((triangle_count / 2) + 1);
+	
+	// depth-first: the first child is always built right after its parent, the second one once the first subtree is done
+	vector<bvh_build_task> tasks { bvh_build_task { 0, triangle_count, ~size_t(0) } };
+	while(!tasks.empty()) {
+		const bvh_build_task task = tasks.back();
+		tasks.pop_back();
+		const size_t node_index = nodes.size();
+		if(task.parent != ~size_t(0)) nodes[task.parent].offset = (uint32_t)node_index;
+		
+		bvh_bounds bounds, centroid_bounds;
+		for(size_t i = task.first; i < task.first + task.count; i++) {
+			bounds.extend(triangle_bounds[order[i]]);
+			centroid_bounds.extend(centroids[order[i]]);
+		}
+		collision_bvh_node node;
+		for(unsigned int k = 0; k < 3; k++) {
+			node.bounds_min[k] = bounds.min[k];
+			node.bounds_max[k] = bounds.max[k];
+		}
+		
+		// find the split with the lowest sah cost (over the bins of all axes)
+		float best_cost = FLT_MAX;
+		unsigned int best_axis = 0, best_split = 0;
+		const float parent_area = bounds.area();
+		for(unsigned int axis = 0; axis < 3 && task.count > 1; axis++) {
+			const float extent = centroid_bounds.max[axis] - centroid_bounds.min[axis];
+			if(!(extent > 0.0f)) continue;
+			const float bin_scale = (float)COLLISION_BVH_BIN_COUNT / extent;
+			
+			bvh_bounds bin_bounds[COLLISION_BVH_BIN_COUNT];
+			size_t bin_counts[COLLISION_BVH_BIN_COUNT] {};
+			for(size_t i = task.first; i < task.first + task.count; i++) {
+				const unsigned int bin = get_bin(get_centroid(order[i], axis), centroid_bounds.min[axis], bin_scale);
+				bin_bounds[bin].extend(triangle_bounds[order[i]]);
+				bin_counts[bin]++;
+			}
+			
+			// right side areas/counts of all splits (split s: bins [0, s) are left, [s, BIN_COUNT) right)
+			float right_costs[COLLISION_BVH_BIN_COUNT] {};
+			size_t right_counts[COLLISION_BVH_BIN_COUNT] {};
+			bvh_bounds right_bounds;
+			size_t right_count = 0;
+			for(unsigned int bin = COLLISION_BVH_BIN_COUNT - 1; bin > 0; bin--) {
+				right_bounds.extend(bin_bounds[bin]);
+				right_count += bin_counts[bin];
+				right_costs[bin] = right_bounds.area() * (float)right_count;
+				right_counts[bin] = right_count;
+			}
+			bvh_bounds left_bounds;
+			size_t left_count = 0;
+			for(unsigned int split = 1; split < COLLISION_BVH_BIN_COUNT; split++) {
+				left_bounds.extend(bin_bounds[split - 1]);
+				left_count += bin_counts[split - 1];
+				if(left_count == 0 || right_counts[split] == 0) continue;
+				const float cost = left_bounds.area() * (float)left_count + right_costs[split];
+				if(cost < best_cost) {
+					best_cost = cost;
+					best_axis = axis;
+					best_split = split;
+				}
+			}
+		}
+		
+		// sah cost relative to intersecting all triangles of this node (the leaf cost)
+		const bool has_split = (best_cost < FLT_MAX);
+		const float split_cost = (has_split ?
+								  COLLISION_BVH_TRAVERSAL_COST + (parent_area > 0.0f ? best_cost / parent_area : (float)task.count) :
+								  FLT_MAX);
+		if(task.count <= COLLISION_BVH_MAX_LEAF_TRIANGLES && split_cost >= (float)task.count) {
+			node.offset = (uint32_t)task.first;
+			node.triangle_count = (uint32_t)task.count;
+			nodes.push_back(node);
+			continue;
+		}
+		
+		size_t first_count = task.count / 2;
+		if(has_split) {
+			const float bin_scale = (float)COLLISION_BVH_BIN_COUNT / (centroid_bounds.max[best_axis] - centroid_bounds.min[best_axis]);
+			const auto middle = partition(order.begin() + (ptrdiff_t)task.first, order.begin() + (ptrdiff_t)(task.first + task.count),
+										  [&](const uint32_t triangle) {
+											  return (get_bin(get_centroid(triangle, best_axis), centroid_bounds.min[best_axis], bin_scale) < best_split);
+										  });
+			first_count = (size_t)(middle - order.begin()) - task.first;
+		}
+		// else: all centroids are equal, any split is as good as any other
+		
+		node.offset = 0; // set once the second child is built
+		node.triangle_count = 0;
+		nodes.push_back(node);
+		tasks.push_back(bvh_build_task { task.first + first_count, task.count - first_count, node_index });
+		tasks.push_back(bvh_build_task { task.first, first_count, ~size_t(0) });
+	}
+	
+	// store the triangles in leaf order
+	vector<s_index> ordered_triangles(triangle_count);
+	for(size_t i = 0; i < triangle_count; i++) {
+		ordered_triangles[i] = triangles[order[i]];
+	}
+	triangles.swap(ordered_triangles);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// validation
+
+static bool contains_bounds(const collision_bvh_node& node, const float* bounds_min, const float* bounds_max) {
+	for(unsigned int k = 0; k < 3; k++) {
+		if(bounds_min[k] < node.bounds_min[k] || bounds_max[k] > node.bounds_max[k]) return false;
+	}
+	return true;
+}
+
+bool validate_collision_bvh(const collision_bvh_node* nodes, const size_t node_count,
+							const float3* vertices, const s_index* triangles, const size_t triangle_count) {
+	if(node_count == 0) return (triangle_count == 0);
+	
+	vector<bool> referenced_triangles(triangle_count, false);
+	size_t visited_nodes = 0;
+	vector<uint32_t> stack { 0 };
+	while(!stack.empty()) {
+		const uint32_t index = stack.back();
+		stack.pop_back();
+		visited_nodes++;
+		const collision_bvh_node& node = nodes[index];
+		
+		if(node.is_leaf()) {
+			if((uint64_t)node.offset + node.triangle_count > triangle_count) return false;
+			for(uint32_t i = node.offset; i < node.offset + node.triangle_count; i++) {
+				if(referenced_triangles[i]) return false;
+				referenced_triangles[i] = true;
+				for(unsigned int k = 0; k < 3; k++) {
+					const float3& vertex = vertices[triangles[i].indices[k]];
+					const float point[3] { vertex.x, vertex.y, vertex.z };
+					if(!contains_bounds(node, point, point)) return false;
+				}
+			}
+			continue;
+		}
+		
+		// children are always stored behind their parent (this also rules out cycles)
+		if((size_t)index + 1 >= node_count || node.offset <= index + 1 || node.offset >= node_count) return false;
+		for(const uint32_t child : { index + 1, node.offset }) {
+			if(!contains_bounds(node, nodes[child].bounds_min, nodes[child].bounds_max)) return false;
+			stack.push_back(child);
+		}
+	}
+	if(visited_nodes != node_count) return false;
+	for(size_t i = 0; i < triangle_count; i++) {
+		if(!referenced_triangles[i]) return false;
+	}
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// queries
+
+// traversal stack: nodes are pushed to a fixed-size array, only very deep (degenerate) trees use the overflow vector
+class bvh_traversal_stack {
+public:
+	void push(const uint32_t node) {
+		if(size < sizeof(nodes) / sizeof(uint32_t)) nodes[size++] = node;
+		else overflow.push_back(node);
+	}
+	bool pop(uint32_t& node) {
+		if(!overflow.empty()) {
+			node = overflow.back();
+			overflow.pop_back();
+			return true;
+		}
+		if(size == 0) return false;
+		node = nodes[--size];
+		return true;
+	}
+	
+protected:
+	uint32_t nodes[64];
+	size_t size = 0;
+	vector<uint32_t> overflow;
+	
+};
+
+static void sub3(const float3& a, const float3& b, float* result) {
+	result[0] = a.x - b.x;
+	result[1] = a.y - b.y;
+	result[2] = a.z - b.z;
+}
+
+static void cross3(const float* a, const float* b, float* result) {
+	result[0] = a[1] * b[2] - a[2] * b[1];
+	result[1] = a[2] * b[0] - a[0] * b[2];
+	result[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static float dot3(const float* a, const float* b) {
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+bool intersect_ray_triangle(const float3& origin, const float3& direction, const float3& v0, const float3& v1, const float3& v2, float& t) {
+	// möller-trumbore
+	const float dir[3] { direction.x, direction.y, direction.z };
+	float edge1[3], edge2[3], s[3], p[3], q[3];
+	sub3(v1, v0, edge1);
+	sub3(v2, v0, edge2);
+	cross3(dir, edge2, p);
+	const float det = dot3(edge1, p);
+	if(fabsf(det) < 1.0e-20f) return false;
+	const float inv_det = 1.0f / det;
+	sub3(origin, v0, s);
+	const float u = dot3(s, p) * inv_det;
+	if(u < 0.0f || u > 1.0f) return false;
+	cross3(s, edge1, q);
+	const float v = dot3(dir, q) * inv_det;
+	if(v < 0.0f || u + v > 1.0f) return false;
+	t = dot3(edge2, q) * inv_det;
+	return (t >= 0.0f);
+}
+
+bool overlaps_triangle_bounds(const float3& box_min, const float3& box_max, const float3& v0, const float3& v1, const float3& v2) {
+	return (std::max(std::max(v0.x, v1.x), v2.x) >= box_min.x && std::min(std::min(v0.x, v1.x), v2.x) <= box_max.x &&
+			std::max(std::max(v0.y, v1.y), v2.y) >= box_min.y && std::min(std::min(v0.y, v1.y), v2.y) <= box_max.y &&
+			std::max(std::max(v0.z, v1.z), v2.z) >= box_min.z && std::min(std::min(v0.z, v1.z), v2.z) <= box_max.z);
+}
+
+// slab test, returns the entry distance or FLT_MAX if the ray misses the node (or only hits it beyond max_t)
+static float intersect_ray_node(const collision_bvh_node& node, const float* origin, const float* inv_direction, const float max_t) {
+	float t_min = 0.0f, t_max = max_t;
+	for(unsigned int k = 0; k < 3; k++) {
+		const float t0 = (node.bounds_min[k] - origin[k]) * inv_direction[k];
+		const float t1 = (node.bounds_max[k] - origin[k]) * inv_direction[k];
+		t_min = std::max(t_min, std::min(t0, t1));
+		t_max = std::min(t_max, std::max(t0, t1));
+	}
+	return (t_min <= t_max ? t_min : FLT_MAX);
+}
+
+bool raycast_collision_bvh(const collision_bvh_node* nodes, const size_t node_count, const float3* vertices, const s_index* triangles,
+						   const float3& origin, const float3& direction, const float max_t, collision_ray_hit& hit) {
+	if(node_count == 0) return false;
+	const float ray_origin[3] { origin.x, origin.y, origin.z };
+	// zero direction components are replaced by a tiny value (no inf/nan, -ffast-math doesn't handle them)
+	float inv_direction[3];
+	const float direction_components[3] { direction.x, direction.y, direction.z };
+	for(unsigned int k = 0; k < 3; k++) {
+		const float component = direction_components[k];
+		inv_direction[k] = 1.0f / (fabsf(component) > 1.0e-30f ? component : (component < 0.0f ? -1.0e-30f : 1.0e-30f));
+	}
+	
+	hit.t = max_t;
+	hit.triangle = ~0u;
+	if(intersect_ray_node(nodes[0], ray_origin, inv_direction, hit.t) == FLT_MAX) return false;
+	bvh_traversal_stack stack;
+	uint32_t index = 0;
+	for(;;) {
+		const collision_bvh_node& node = nodes[index];
+		if(node.is_leaf()) {
+			for(uint32_t i = node.offset; i < node.offset + node.triangle_count; i++) {
+				float t;
+				if(intersect_ray_triangle(origin, direction, vertices[triangles[i].indices[0]], vertices[triangles[i].indices[1]],
+										  vertices[triangles[i].indices[2]], t) && t <= hit.t) {
+					hit.t = t;
+					hit.triangle = i;
+				}
+			}
+		}
+		else {
+			// visit the nearer child first, the other one later (if it's still closer than the closest hit then)
+			uint32_t near_child = index + 1, far_child = node.offset;
+			float near_t = intersect_ray_node(nodes[near_child], ray_origin, inv_direction, hit.t);
+			float far_t = intersect_ray_node(nodes[far_child], ray_origin, inv_direction, hit.t);
+			if(far_t < near_t) {
+				swap(near_child, far_child);
+				swap(near_t, far_t);
+			}
+			if(near_t != FLT_MAX) {
+				if(far_t != FLT_MAX) stack.push(far_child);
+				index = near_child;
+				continue;
+			}
+		}
+		
+		// next node that may still contain a closer hit
+		bool found = false;
+		while(stack.pop(index)) {
+			if(intersect_ray_node(nodes[index], ray_origin, inv_direction, hit.t) != FLT_MAX) {
+				found = true;
+				break;
+			}
+		}
+		if(!found) break;
+	}
+	return (hit.triangle != ~0u);
+}
+
+void query_collision_bvh_box(const collision_bvh_node* nodes, const size_t node_count, const float3* vertices, const s_index* triangles,
+							 const float3& box_min, const float3& box_max, vector<uint32_t>& result) {
+	if(node_count == 0) return;
+	const float query_min[3] { box_min.x, box_min.y, box_min.z };
+	const float query_max[3] { box_max.x, box_max.y, box_max.z };
+	bvh_traversal_stack stack;
+	stack.push(0);
+	uint32_t index;
+	while(stack.pop(index)) {
+		const collision_bvh_node& node = nodes[index];
+		bool overlaps = true;
+		for(unsigned int k = 0; k < 3; k++) {
+			if(node.bounds_min[k] > query_max[k] || node.bounds_max[k] < query_min[k]) overlaps = false;
+		}
+		if(!overlaps) continue;
+		
+		if(node.is_leaf()) {
+			for(uint32_t i = node.offset; i < node.offset + node.triangle_count; i++) {
+				if(overlaps_triangle_bounds(box_min, box_max, vertices[triangles[i].indices[0]], vertices[triangles[i].indices[1]],
+											vertices[triangles[i].indices[2]])) {
+					result.push_back(i);
+				}
+			}
+		}
+		else {
+			stack.push(node.offset);
+			stack.push(index + 1);
+		}
+	}
+}
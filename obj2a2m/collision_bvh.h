@@ -0,0 +1,75 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_COLLISION_BVH_H__
+#define __OBJ2A2M_COLLISION_BVH_H__
+
+#include <a2e.h>
+#include "obj_model.h"
+#include <cfloat>
+
+// max amount of triangles of a leaf (leaves are created earlier if splitting doesn't pay off, see the sah costs)
+#define COLLISION_BVH_MAX_LEAF_TRIANGLES 8
+// amount of bins per axis that are evaluated for each split
+#define COLLISION_BVH_BIN_COUNT 16
+// sah cost of an inner node traversal step, relative to a ray/triangle test
+#define COLLISION_BVH_TRAVERSAL_COST 1.0f
+
+// node of the flattened collision bvh (32 bytes, stored as is in the COLLISION_BVH section).
+// the nodes are stored depth-first: the first child of an inner node directly follows it,
+// the triangles of each leaf are a contiguous range of the (reordered) collision triangles
+struct collision_bvh_node {
+	float bounds_min[3];
+	// inner node: index of the second child, leaf: index of the first triangle
+	uint32_t offset;
+	float bounds_max[3];
+	// 0 for inner nodes
+	uint32_t triangle_count;
+	
+	bool is_leaf() const { return (triangle_count != 0); }
+};
+static_assert(sizeof(collision_bvh_node) == 32, "collision_bvh_node must be 32 bytes");
+
+// builds the bvh (binned sah) over the triangles and reorders them so that every leaf references a contiguous range.
+// an empty triangle list results in no nodes at all
+void build_collision_bvh(const float3* vertices, vector<s_index>& triangles, vector<collision_bvh_node>& nodes);
+
+// returns false if the bvh isn't valid for the triangles: child/triangle offsets out of range, triangles that aren't
+// referenced by exactly one leaf, or node bounds that don't contain their children/triangles
+bool validate_collision_bvh(const collision_bvh_node* nodes, const size_t node_count,
+							const float3* vertices, const s_index* triangles, const size_t triangle_count);
+
+// reference queries (as an engine would run them on the stored bvh)
+struct collision_ray_hit {
+	float t;
+	uint32_t triangle;
+};
+
+// closest intersection of the ray origin + t * direction (t in [0, max_t]) with the triangles, returns false if there is none
+bool raycast_collision_bvh(const collision_bvh_node* nodes, const size_t node_count, const float3* vertices, const s_index* triangles,
+						   const float3& origin, const float3& direction, const float max_t, collision_ray_hit& hit);
+
+// adds the indices of all triangles whose aabb overlaps the box to result (broad phase of a box query)
+void query_collision_bvh_box(const collision_bvh_node* nodes, const size_t node_count, const float3* vertices, const s_index* triangles,
+							 const float3& box_min, const float3& box_max, vector<uint32_t>& result);
+
+// ray/triangle and box/triangle tests of the queries (also used for brute force queries)
+bool intersect_ray_triangle(const float3& origin, const float3& direction, const float3& v0, const float3& v1, const float3& v2, float& t);
+bool overlaps_triangle_bounds(const float3& box_min, const float3& box_max, const float3& v0, const float3& v1, const float3& v2);
+
+#endif
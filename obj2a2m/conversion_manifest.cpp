@@ -0,0 +1,206 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "conversion_manifest.h"
+#include "obj_parser.h"
+#include "parallel.h"
+#include <zlib.h>
+#include <sys/stat.h>
+
+#define CONVERSION_MANIFEST_FILENAME "obj2a2m.manifest"
+#define FILE_HASH_CHUNK_SIZE (16u * 1024u * 1024u)
+
+bool hash_file(const string& filename, const unsigned int thread_count, file_hash& hash) {
+	hash = file_hash();
+	if(filename == "") return true;
+	
+	mapped_file file(filename.c_str());
+	if(!file.is_open()) return false;
+	const size_t size = file.get_size();
+	const unsigned char* data = (const unsigned char*)file.get_data();
+	
+	// crc each chunk on its own, then combine the chunk crcs in order
+	const size_t chunk_count = (size + FILE_HASH_CHUNK_SIZE - 1) / FILE_HASH_CHUNK_SIZE;
+	vector<uint32_t> chunk_crcs(chunk_count);
+	parallel_for(chunk_count, thread_count, [&](const size_t i) {
+		const size_t offset = i * FILE_HASH_CHUNK_SIZE;
+		chunk_crcs[i] = (uint32_t)crc32(crc32(0, Z_NULL, 0), data + offset, (uInt)std::min(size - offset, (size_t)FILE_HASH_CHUNK_SIZE));
+	});
+	
+	uLong crc = crc32(0, Z_NULL, 0);
+	for(size_t i = 0; i < chunk_count; i++) {
+		const size_t offset = i * FILE_HASH_CHUNK_SIZE;
+		crc = crc32_combine(crc, chunk_crcs[i], (z_off_t)std::min(size - offset, (size_t)FILE_HASH_CHUNK_SIZE));
+	}
+	hash.crc = (uint32_t)crc;
+	hash.size = size;
+	return true;
+}
+
+bool get_file_size(const string& filename, uint64_t& size) {
+#ifdef WIN32
+	struct _stat64 file_stat;
+	if(_stat64(filename.c_str(), &file_stat) != 0) return false;
+#else
+	struct stat file_stat;
+	if(stat(filename.c_str(), &file_stat) != 0) return false;
+#endif
+	size = (uint64_t)file_stat.st_size;
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// manifest file
+
+static string write_hash(const file_hash& hash) {
+	char str[32];
+	snprintf(str, sizeof(str), "%08x:%llu", hash.crc, (unsigned long long int)hash.size);
+	return str;
+}
+
+static bool read_hash(const string& str, file_hash& hash) {
+	unsigned int crc = 0;
+	unsigned long long int size = 0;
+	if(sscanf(str.c_str(), "%x:%llu", &crc, &size) != 2) return false;
+	hash.crc = crc;
+	hash.size = size;
+	return true;
+}
+
+// the manifest only stores the filename of each output (they are all in the same directory)
+static string get_directory(const string& filename) {
+	const size_t pos = filename.find_last_of("/\\");
+	return (pos == string::npos ? "" : filename.substr(0, pos + 1));
+}
+
+static string get_filename(const string& filename) {
+	const size_t pos = filename.find_last_of("/\\");
+	return (pos == string::npos ? filename : filename.substr(pos + 1));
+}
+
+string get_referenced_path(const string& input_filename, const string& referenced_filename) {
+	if(referenced_filename.empty() || referenced_filename[0] == '/' || referenced_filename[0] == '\\' ||
+	   (referenced_filename.size() > 1 && referenced_filename[1] == ':')) {
+		return referenced_filename;
+	}
+	return get_directory(input_filename) + referenced_filename;
+}
+
+shared_ptr<conversion_manifest> conversion_manifest::get(const string& output_filename, const bool create) {
+	static map<string, shared_ptr<conversion_manifest>> manifests;
+	static mutex manifests_lock;
+	
+	const string manifest_filename = get_directory(output_filename) + CONVERSION_MANIFEST_FILENAME;
+	lock_guard<mutex> lock(manifests_lock);
+	const auto iter = manifests.find(manifest_filename);
+	if(iter != manifests.end()) return iter->second;
+	
+	uint64_t size = 0;
+	if(!create && !get_file_size(manifest_filename, size)) return nullptr;
+	
+	shared_ptr<conversion_manifest> manifest = make_shared<conversion_manifest>(manifest_filename);
+	manifests[manifest_filename] = manifest;
+	return manifest;
+}
+
+conversion_manifest::conversion_manifest(const string& filename_) : filename(filename_) {
+	load();
+}
+
+bool conversion_manifest::find(const string& output_filename, entry& output_entry) const {
+	lock_guard<mutex> lock(entries_lock);
+	const auto iter = entries.find(get_filename(output_filename));
+	if(iter == entries.end()) return false;
+	output_entry = iter->second;
+	return true;
+}
+
+bool conversion_manifest::update(const string& output_filename, const entry& output_entry) {
+	lock_guard<mutex> lock(entries_lock);
+	entries[get_filename(output_filename)] = output_entry;
+	return save();
+}
+
+// one line per output (tab separated):
+// output	obj hash	collision hash	mtllib	mtllib hash	output size	options
+// (hashes are stored as crc:size, an empty hash means there is no such file)
+void conversion_manifest::load() {
+	// a new manifest
+	uint64_t size = 0;
+	if(!get_file_size(filename, size)) return;
+	
+	stringstream buffer;
+	if(!file_io::file_to_buffer(filename, buffer)) return;
+	
+	string line;
+	size_t line_number = 0;
+	while(getline(buffer, line)) {
+		line_number++;
+		if(line.empty() || line[0] == '#') continue;
+		
+		vector<string> fields;
+		stringstream line_buffer(line);
+		string field;
+		while(getline(line_buffer, field, '\t')) {
+			fields.push_back(field);
+		}
+		
+		entry output_entry;
+		if(fields.size() != 7 ||
+		   !read_hash(fields[1], output_entry.obj_hash) ||
+		   !read_hash(fields[2], output_entry.collision_hash) ||
+		   !read_hash(fields[4], output_entry.mtllib_hash)) {
+			// ignore invalid lines, the outputs will simply be converted again
+			a2e_error("invalid line #%u in manifest \"%s\"!", line_number, filename);
+			continue;
+		}
+		output_entry.mtllib = fields[3];
+		output_entry.output_size = strtoull(fields[5].c_str(), nullptr, 10);
+		output_entry.options = fields[6];
+		entries[fields[0]] = output_entry;
+	}
+}
+
+bool conversion_manifest::save() const {
+	// write to a temporary file first, so that an interrupted write doesn't destroy the manifest
+	const string tmp_filename = filename + ".tmp";
+	file_io f;
+	if(!f.open(tmp_filename, file_io::OPEN_TYPE::WRITE)) {
+		a2e_error("couldn't write manifest \"%s\"!", tmp_filename);
+		return false;
+	}
+	fstream& file = *f.get_filestream();
+	file << "# obj2a2m manifest: output, obj hash, collision hash, mtllib, mtllib hash, output size, options" << endl;
+	for(const auto& output : entries) {
+		const entry& output_entry = output.second;
+		file << output.first << "\t" << write_hash(output_entry.obj_hash) << "\t" << write_hash(output_entry.collision_hash) << "\t"
+			 << output_entry.mtllib << "\t" << write_hash(output_entry.mtllib_hash) << "\t" << output_entry.output_size << "\t"
+			 << output_entry.options << endl;
+	}
+	f.close();
+	
+#ifdef WIN32
+	// rename doesn't replace existing files on windows
+	remove(filename.c_str());
+#endif
+	if(rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+		a2e_error("couldn't write manifest \"%s\"!", filename);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,82 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_CONVERSION_MANIFEST_H__
+#define __OBJ2A2M_CONVERSION_MANIFEST_H__
+
+#include <a2e.h>
+#include <mutex>
+
+// fast content hash of a file (crc32 of the contents + file size)
+struct file_hash {
+	uint32_t crc = 0;
+	uint64_t size = 0;
+	
+	bool operator==(const file_hash& hash) const { return (crc == hash.crc && size == hash.size); }
+	bool operator!=(const file_hash& hash) const { return !(*this == hash); }
+};
+
+// hashes the file in chunks on (at most) thread_count tasks, returns false if the file doesn't exist or can't be read.
+// an empty filename results in an empty hash
+bool hash_file(const string& filename, const unsigned int thread_count, file_hash& hash);
+
+// returns false if the file doesn't exist
+bool get_file_size(const string& filename, uint64_t& size);
+
+// path of a file that is referenced by input_filename (e.g. the mtllib of an .obj): relative paths are relative to the
+// directory of input_filename, absolute and empty paths are returned as they are
+string get_referenced_path(const string& input_filename, const string& referenced_filename);
+
+// persistent record of all conversions into one directory (stored as "obj2a2m.manifest" next to the outputs).
+// an output is up-to-date if its input .obj, collision .obj, mtllib and conversion options still hash to the recorded
+// values and the output file still has the recorded size
+class conversion_manifest {
+public:
+	struct entry {
+		file_hash obj_hash;
+		file_hash collision_hash;
+		string mtllib = "";
+		file_hash mtllib_hash;
+		string options = "";
+		uint64_t output_size = 0;
+	};
+	
+	// returns the manifest of the directory output_filename is stored in (shared by all conversions of this process).
+	// returns nullptr if no manifest exists in this directory and create is false
+	static shared_ptr<conversion_manifest> get(const string& output_filename, const bool create);
+	
+	bool find(const string& output_filename, entry& output_entry) const;
+	// adds or replaces the entry of this output and writes the manifest
+	bool update(const string& output_filename, const entry& output_entry);
+	
+	conversion_manifest(const string& filename);
+	
+protected:
+	const string filename;
+	map<string, entry> entries;
+	mutable mutex entries_lock;
+	
+	void load();
+	bool save() const;
+	
+	conversion_manifest(const conversion_manifest&) = delete;
+	conversion_manifest& operator=(const conversion_manifest&) = delete;
+	
+};
+
+#endif
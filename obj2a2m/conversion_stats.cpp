@@ -0,0 +1,77 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "conversion_stats.h"
+#ifdef WIN32
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+conversion_stats::conversion_stats() :
+token_count(0), face_count(0), quad_count(0), weld_vertex_count(0), welded_vertex_count(0), merged_coord_count(0) {
+	for(auto& phase_time : phase_times) {
+		phase_time = 0;
+	}
+}
+
+void conversion_stats::add_time(const CONVERSION_PHASE phase, const double seconds) {
+	phase_times[(size_t)phase] += (uint64_t)(seconds * 1000000000.0);
+}
+
+double conversion_stats::get_time(const CONVERSION_PHASE phase) const {
+	return (double)phase_times[(size_t)phase] / 1000000000.0;
+}
+
+const char* conversion_stats::get_phase_name(const CONVERSION_PHASE phase) {
+	switch(phase) {
+		case CONVERSION_PHASE::READ: return "read";
+		case CONVERSION_PHASE::PARSE: return "parse";
+		case CONVERSION_PHASE::REDUCE: return "reduce";
+		case CONVERSION_PHASE::SORT: return "sort";
+		case CONVERSION_PHASE::WELD: return "weld";
+		case CONVERSION_PHASE::DEDUP: return "dedup";
+		case CONVERSION_PHASE::INDEX: return "index";
+		case CONVERSION_PHASE::WRITE: return "write";
+		case CONVERSION_PHASE::MAT_MAPPING: return "mat_mapping";
+		case CONVERSION_PHASE::BVH: return "bvh";
+		case CONVERSION_PHASE::MESHLETS: return "meshlets";
+		case CONVERSION_PHASE::LOD: return "lod";
+		case CONVERSION_PHASE::NORMALS: return "normals";
+		case CONVERSION_PHASE::__MAX_CONVERSION_PHASE: break;
+	}
+	return "";
+}
+
+size_t get_peak_rss() {
+#ifdef WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+	return (size_t)counters.PeakWorkingSetSize;
+#else
+	struct rusage usage;
+	if(getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+	// bytes on os x
+	return (size_t)usage.ru_maxrss;
+#else
+	// kilobytes on linux
+	return (size_t)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
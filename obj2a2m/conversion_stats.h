@@ -0,0 +1,91 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_CONVERSION_STATS_H__
+#define __OBJ2A2M_CONVERSION_STATS_H__
+
+#include <a2e.h>
+#include <chrono>
+
+// timed phases of a conversion
+enum class CONVERSION_PHASE : unsigned int {
+	READ,			// reading, mapping or decompressing the .obj files
+	PARSE,			// parsing the .obj data
+	REDUCE,			// reducing all sub-objects (includes SORT, WELD and DEDUP)
+	SORT,			// sorting the vertices of the sub-objects
+	WELD,			// welding the sorted vertices of the sub-objects and remapping their indices
+	DEDUP,			// removing duplicate vertices and texture coordinates of the sub-objects
+	INDEX,			// creating the final indices
+	WRITE,			// serializing and writing the output
+	MAT_MAPPING,	// creating the material mapping
+	BVH,			// building the collision bvh
+	MESHLETS,		// building the meshlets of the sub-objects
+	LOD,			// simplifying the sub-objects (lod chain)
+	NORMALS,		// computing the normals of the sub-objects
+	__MAX_CONVERSION_PHASE
+};
+
+// phase times and counters of a single conversion (thread-safe). SORT, WELD, DEDUP, MESHLETS, LOD and NORMALS run inside the
+// parallel REDUCE phase, so their times are summed over all tasks, all other phases are wall clock times
+class conversion_stats {
+public:
+	conversion_stats();
+	
+	void add_time(const CONVERSION_PHASE phase, const double seconds);
+	double get_time(const CONVERSION_PHASE phase) const;
+	static const char* get_phase_name(const CONVERSION_PHASE phase);
+	
+	atomic<size_t> token_count;
+	atomic<size_t> face_count;
+	atomic<size_t> quad_count; // quads that were split into two triangles
+	atomic<size_t> weld_vertex_count; // vertices that were checked for welding
+	atomic<size_t> welded_vertex_count;
+	atomic<size_t> merged_coord_count; // texture coordinates that were merged with an equal one of another .obj index
+	
+protected:
+	atomic<uint64_t> phase_times[(size_t)CONVERSION_PHASE::__MAX_CONVERSION_PHASE]; // in ns
+	
+	conversion_stats(const conversion_stats&) = delete;
+	conversion_stats& operator=(const conversion_stats&) = delete;
+	
+};
+
+// adds the time between construction and destruction (or stop) to a phase (does nothing if stats is nullptr)
+class phase_timer {
+public:
+	phase_timer(conversion_stats* stats_, const CONVERSION_PHASE phase_) :
+	stats(stats_), phase(phase_), start(chrono::high_resolution_clock::now()) {}
+	~phase_timer() { stop(); }
+	
+	void stop() {
+		if(stats == nullptr) return;
+		stats->add_time(phase, chrono::duration<double>(chrono::high_resolution_clock::now() - start).count());
+		stats = nullptr;
+	}
+	
+protected:
+	conversion_stats* stats;
+	const CONVERSION_PHASE phase;
+	const chrono::high_resolution_clock::time_point start;
+	
+};
+
+// peak resident set size of this process in bytes (0 if unknown)
+size_t get_peak_rss();
+
+#endif
@@ -0,0 +1,89 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "coord_dedup.h"
+#include "hash_mix.h"
+
+constexpr unsigned int coord_dedup_table::invalid_index;
+
+void coord_dedup_table::reset(const size_t corner_count) {
+	// power of two size with a max load factor of 0.5
+	size_t size = 16;
+	while(size < corner_count * 2) size <<= 1;
+	mask = size - 1;
+	
+	vertex_slots.assign(size, vertex_slot { 0, invalid_index });
+	coord_slots.assign(size, coord_slot { 0, 0, 0, invalid_index, coord() });
+}
+
+int coord_dedup_table::cell(const double value) {
+	// values outside of the int range are clamped (these cells only lead to additional rejected candidates)
+	static const double inv_cell_size = 1.0 / (2.0 * (double)COORD_DEDUP_EPSILON);
+	const double cell_value = floor(value * inv_cell_size);
+	if(!(cell_value > -2147483647.0)) return -2147483647;
+	if(cell_value > 2147483647.0) return 2147483647;
+	return (int)cell_value;
+}
+
+size_t coord_dedup_table::hash(const unsigned int vertex_index, const int cell_u, const int cell_v) {
+	return (size_t)hash_mix64(((uint64_t)vertex_index << 32) ^ ((uint64_t)(unsigned int)cell_u * 0x9E3779B97F4A7C15ULL) ^
+							  (uint64_t)(unsigned int)cell_v);
+}
+
+unsigned int coord_dedup_table::find_vertex(const unsigned int vertex_index) const {
+	for(size_t slot = hash(vertex_index, 0, 0) & mask; vertex_slots[slot].vertex != invalid_index; slot = (slot + 1) & mask) {
+		if(vertex_slots[slot].vertex_index == vertex_index) return vertex_slots[slot].vertex;
+	}
+	return invalid_index;
+}
+
+void coord_dedup_table::add_vertex(const unsigned int vertex_index, const unsigned int vertex) {
+	size_t slot = hash(vertex_index, 0, 0) & mask;
+	while(vertex_slots[slot].vertex != invalid_index) slot = (slot + 1) & mask;
+	vertex_slots[slot] = vertex_slot { vertex_index, vertex };
+}
+
+unsigned int coord_dedup_table::find_coord(const unsigned int vertex_index, const coord& tex_coord) const {
+	// an equal coordinate is at most ~1.5 * epsilon away (including float rounding) -> probe all cells in this range
+	static const double range = 1.5 * (double)COORD_DEDUP_EPSILON;
+	const int min_u = cell((double)tex_coord.u - range), max_u = cell((double)tex_coord.u + range);
+	const int min_v = cell((double)tex_coord.v - range), max_v = cell((double)tex_coord.v + range);
+	
+	unsigned int found = invalid_index;
+	for(int cell_u = min_u; ; cell_u++) {
+		for(int cell_v = min_v; ; cell_v++) {
+			for(size_t slot = hash(vertex_index, cell_u, cell_v) & mask; coord_slots[slot].coord_index != invalid_index; slot = (slot + 1) & mask) {
+				const coord_slot& entry = coord_slots[slot];
+				if(entry.vertex_index != vertex_index || entry.cell_u != cell_u || entry.cell_v != cell_v) continue;
+				if((found == invalid_index || entry.coord_index > found) && equal_coord(entry.tex_coord, tex_coord)) {
+					found = entry.coord_index;
+				}
+			}
+			if(cell_v == max_v) break;
+		}
+		if(cell_u == max_u) break;
+	}
+	return found;
+}
+
+void coord_dedup_table::add_coord(const unsigned int vertex_index, const unsigned int coord_index, const coord& tex_coord) {
+	const int cell_u = cell((double)tex_coord.u), cell_v = cell((double)tex_coord.v);
+	size_t slot = hash(vertex_index, cell_u, cell_v) & mask;
+	while(coord_slots[slot].coord_index != invalid_index) slot = (slot + 1) & mask;
+	coord_slots[slot] = coord_slot { vertex_index, cell_u, cell_v, coord_index, tex_coord };
+}
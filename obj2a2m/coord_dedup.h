@@ -0,0 +1,78 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_COORD_DEDUP_H__
+#define __OBJ2A2M_COORD_DEDUP_H__
+
+#include <a2e.h>
+
+#define COORD_DEDUP_EPSILON 0.000001f
+
+inline bool equal_coord(const coord& c1, const coord& c2) {
+	const static float epsilon = COORD_DEDUP_EPSILON;
+	if(((c1.u - epsilon) < c2.u) && (c2.u < (c1.u + epsilon))) {
+		if(((c1.v - epsilon) < c2.v) && (c2.v < (c1.v + epsilon))) {
+			return true;
+		}
+		else return false;
+	}
+	return false;
+}
+
+// open addressing (linear probing) hash tables that map obj vertex indices to their (sub-object) vertex index and
+// (vertex index, quantized texture coordinate) pairs to their (sub-object) texture coordinate index.
+// the texture coordinates are quantized to cells that are twice the epsilon in size. a lookup probes all cells within
+// ~1.5 * epsilon (including float rounding) of the coordinate that can contain an equal (see equal_coord) one, these
+// are 2x2 cells in most cases, but up to 3x3 cells.
+class coord_dedup_table {
+public:
+	static constexpr unsigned int invalid_index = ~0u;
+	
+	// clears the table and prepares it for (at most) corner_count added vertices/coordinates
+	void reset(const size_t corner_count);
+	
+	// returns the vertex index that was added for vertex_index (or invalid_index if there is none)
+	unsigned int find_vertex(const unsigned int vertex_index) const;
+	void add_vertex(const unsigned int vertex_index, const unsigned int vertex);
+	
+	// returns the most recently added coordinate index of vertex_index whose coordinate is equal to tex_coord
+	// (or invalid_index if there is none), coordinate indices must be added in increasing order
+	unsigned int find_coord(const unsigned int vertex_index, const coord& tex_coord) const;
+	void add_coord(const unsigned int vertex_index, const unsigned int coord_index, const coord& tex_coord);
+	
+protected:
+	struct vertex_slot {
+		unsigned int vertex_index;
+		unsigned int vertex; // invalid_index: empty slot
+	};
+	struct coord_slot {
+		unsigned int vertex_index;
+		int cell_u, cell_v;
+		unsigned int coord_index; // invalid_index: empty slot
+		coord tex_coord;
+	};
+	vector<vertex_slot> vertex_slots;
+	vector<coord_slot> coord_slots;
+	size_t mask = 0;
+	
+	static int cell(const double value);
+	static size_t hash(const unsigned int vertex_index, const int cell_u, const int cell_v);
+	
+};
+
+#endif
@@ -0,0 +1,166 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "gz_stream.h"
+#include <zlib.h>
+
+gz_line_stream::gz_line_stream(const char* filename, const size_t block_size_, const size_t max_blocks_) :
+block_size(std::max(block_size_, (size_t)4096)), max_blocks(std::max(max_blocks_, (size_t)1)) {
+	file = fopen(filename, "rb");
+	if(file == nullptr) return;
+	opened = true;
+	stream_thread = thread(&gz_line_stream::decompress, this);
+}
+
+gz_line_stream::~gz_line_stream() {
+	if(stream_thread.joinable()) {
+		{
+			// stop the decompression if not all blocks were consumed
+			lock_guard<mutex> lock(queue_lock);
+			stopped = true;
+		}
+		space_available.notify_all();
+		stream_thread.join();
+	}
+	if(file != nullptr) fclose(file);
+}
+
+bool gz_line_stream::is_compressed(const char* filename) {
+	FILE* header_file = fopen(filename, "rb");
+	if(header_file == nullptr) return false;
+	unsigned char header[2] { 0, 0 };
+	const size_t header_size = fread(header, 1, 2, header_file);
+	fclose(header_file);
+	if(header_size != 2) return false;
+	
+	// gzip magic
+	if(header[0] == 0x1F && header[1] == 0x8B) return true;
+	// zlib: deflate with a 32k window, valid header checksum, no preset dictionary
+	return (header[0] == 0x78 && ((header[0] << 8) | header[1]) % 31 == 0 && (header[1] & 0x20) == 0);
+}
+
+bool gz_line_stream::next_block(vector<char>& block, size_t& block_index) {
+	unique_lock<mutex> lock(queue_lock);
+	block_available.wait(lock, [this] { return (!blocks.empty() || finished); });
+	if(blocks.empty()) return false;
+	
+	block = move(blocks.front());
+	blocks.pop_front();
+	block_index = next_block_index++;
+	lock.unlock();
+	space_available.notify_one();
+	return true;
+}
+
+bool gz_line_stream::has_failed() const {
+	lock_guard<mutex> lock(queue_lock);
+	return failed;
+}
+
+double gz_line_stream::get_decompress_time() const {
+	lock_guard<mutex> lock(queue_lock);
+	return decompress_time;
+}
+
+bool gz_line_stream::push_block(vector<char>&& block) {
+	const auto wait_start = chrono::high_resolution_clock::now();
+	unique_lock<mutex> lock(queue_lock);
+	space_available.wait(lock, [this] { return (blocks.size() < max_blocks || stopped); });
+	wait_time += chrono::duration<double>(chrono::high_resolution_clock::now() - wait_start).count();
+	if(stopped) return false;
+	blocks.push_back(move(block));
+	lock.unlock();
+	block_available.notify_one();
+	return true;
+}
+
+void gz_line_stream::decompress() {
+	const auto start_time = chrono::high_resolution_clock::now();
+	z_stream stream;
+	memset(&stream, 0, sizeof(z_stream));
+	// +32: automatic gzip/zlib header detection
+	bool success = (inflateInit2(&stream, 15 + 32) == Z_OK);
+	
+	static const size_t input_size = 256 * 1024;
+	vector<unsigned char> input(input_size);
+	vector<char> output(block_size);
+	size_t output_size = 0;
+	bool stream_end = false;
+	while(success) {
+		if(stream.avail_in == 0) {
+			stream.next_in = input.data();
+			stream.avail_in = (uInt)fread(input.data(), 1, input_size, file);
+			if(stream.avail_in == 0) {
+				// a truncated file is an error
+				success = stream_end;
+				break;
+			}
+		}
+		// concatenated gzip members
+		if(stream_end) {
+			if(inflateReset(&stream) != Z_OK) {
+				success = false;
+				break;
+			}
+			stream_end = false;
+		}
+		
+		stream.next_out = (Bytef*)output.data() + output_size;
+		stream.avail_out = (uInt)(output.size() - output_size);
+		const int ret = inflate(&stream, Z_NO_FLUSH);
+		if(ret == Z_STREAM_END) stream_end = true;
+		else if(ret != Z_OK && ret != Z_BUF_ERROR) {
+			success = false;
+			break;
+		}
+		output_size = output.size() - stream.avail_out;
+		if(output_size < output.size()) continue;
+		
+		// output block is full -> hand out everything up to the last newline, the rest goes into the next block
+		size_t line_end = output_size;
+		while(line_end > 0 && output[line_end - 1] != '\n') line_end--;
+		if(line_end == 0) {
+			// no newline in the whole block: grow it
+			output.resize(output.size() * 2);
+			continue;
+		}
+		vector<char> next_output(block_size);
+		output_size -= line_end;
+		copy(output.begin() + (ptrdiff_t)line_end, output.begin() + (ptrdiff_t)(line_end + output_size), next_output.begin());
+		output.resize(line_end);
+		if(!push_block(move(output))) {
+			// stopped
+			inflateEnd(&stream);
+			return;
+		}
+		output = move(next_output);
+	}
+	inflateEnd(&stream);
+	
+	if(success && output_size > 0) {
+		output.resize(output_size);
+		push_block(move(output));
+	}
+	{
+		lock_guard<mutex> lock(queue_lock);
+		finished = true;
+		failed = !success;
+		decompress_time = chrono::duration<double>(chrono::high_resolution_clock::now() - start_time).count() - wait_time;
+	}
+	block_available.notify_all();
+}
@@ -0,0 +1,79 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_GZ_STREAM_H__
+#define __OBJ2A2M_GZ_STREAM_H__
+
+#include <a2e.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <chrono>
+
+// decompresses a gzip or zlib compressed text file on its own thread and hands out the decompressed text
+// in line-aligned blocks of about block_size bytes. at most max_blocks blocks are buffered at once, so the
+// decompressed text never has to be in memory as a whole
+class gz_line_stream {
+public:
+	gz_line_stream(const char* filename, const size_t block_size, const size_t max_blocks);
+	~gz_line_stream();
+	
+	bool is_open() const { return opened; }
+	
+	// waits for the next block, returns false once all blocks have been handed out (or decompression failed).
+	// block_index is the position of the block in the file (can be called from multiple threads)
+	bool next_block(vector<char>& block, size_t& block_index);
+	
+	// true if the file is corrupt or truncated (only valid after next_block returned false)
+	bool has_failed() const;
+	
+	// time the stream thread spent reading and decompressing, without waiting for free queue space
+	// (only valid after next_block returned false)
+	double get_decompress_time() const;
+	
+	// true if the file starts with a gzip or zlib header
+	static bool is_compressed(const char* filename);
+	
+protected:
+	FILE* file = nullptr;
+	bool opened = false;
+	const size_t block_size;
+	const size_t max_blocks;
+	
+	thread stream_thread;
+	mutable mutex queue_lock;
+	condition_variable block_available;
+	condition_variable space_available;
+	deque<vector<char>> blocks;
+	size_t next_block_index = 0;
+	bool finished = false;
+	bool failed = false;
+	bool stopped = false;
+	double decompress_time = 0.0;
+	double wait_time = 0.0; // only accessed by the stream thread
+	
+	void decompress();
+	bool push_block(vector<char>&& block);
+	
+	gz_line_stream(const gz_line_stream&) = delete;
+	gz_line_stream& operator=(const gz_line_stream&) = delete;
+	
+};
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "mesh_arena.h"
+
+unsigned char* mesh_arena::new_block(vector<unique_ptr<unsigned char[]>>& block_list, const size_t size) {
+	block_list.emplace_back(new unsigned char[size + alignment]);
+	allocated_size += size + alignment;
+	return (unsigned char*)(((uintptr_t)block_list.back().get() + alignment - 1) & ~(uintptr_t)(alignment - 1));
+}
+
+void* mesh_arena::alloc_bytes(const size_t size) {
+	if(size == 0) return nullptr;
+	const size_t aligned_size = (size + alignment - 1) & ~(alignment - 1);
+	
+	lock_guard<mutex> lock(arena_lock);
+	
+	// big arrays get a block of their own
+	if(aligned_size > block_size / 2) {
+		return new_block(large_blocks, aligned_size);
+	}
+	
+	if((size_t)(block_end - block_cur) < aligned_size) {
+		block_cur = new_block(blocks, block_size);
+		block_end = block_cur + block_size;
+	}
+	void* ptr = block_cur;
+	block_cur += aligned_size;
+	return ptr;
+}
@@ -0,0 +1,84 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_MESH_ARENA_H__
+#define __OBJ2A2M_MESH_ARENA_H__
+
+#include <a2e.h>
+#include <mutex>
+
+// bump allocator for the (trivially copyable) mesh arrays: allocations are carved out of large blocks
+// and are only freed all at once when the arena is destroyed (allocating is thread-safe)
+class mesh_arena {
+public:
+	mesh_arena(const size_t block_size = 4 * 1024 * 1024) : block_size(block_size) {}
+	
+	// returns uninitialized, 16-byte aligned memory for count elements
+	template <typename T> T* alloc(const size_t count) {
+		return (T*)alloc_bytes(count * sizeof(T));
+	}
+	
+	// total amount of memory that was allocated by this arena (in bytes)
+	size_t get_allocated_size() const {
+		lock_guard<mutex> lock(arena_lock);
+		return allocated_size;
+	}
+	
+protected:
+	static constexpr size_t alignment = 16;
+	const size_t block_size;
+	mutable mutex arena_lock;
+	
+	vector<unique_ptr<unsigned char[]>> blocks;
+	vector<unique_ptr<unsigned char[]>> large_blocks;
+	unsigned char* block_cur = nullptr; // free space of the current block
+	unsigned char* block_end = nullptr;
+	size_t allocated_size = 0;
+	
+	unsigned char* new_block(vector<unique_ptr<unsigned char[]>>& block_list, const size_t size);
+	void* alloc_bytes(const size_t size);
+	
+	mesh_arena(const mesh_arena&) = delete;
+	mesh_arena& operator=(const mesh_arena&) = delete;
+	
+};
+
+// fixed size array inside a mesh_arena
+template <typename T> class arena_array {
+public:
+	arena_array() {}
+	arena_array(mesh_arena& arena, const size_t count) : data(arena.alloc<T>(count)), count(count) {}
+	
+	T& operator[](const size_t index) { return data[index]; }
+	const T& operator[](const size_t index) const { return data[index]; }
+	
+	T* begin() { return data; }
+	T* end() { return data + count; }
+	const T* begin() const { return data; }
+	const T* end() const { return data + count; }
+	
+	size_t size() const { return count; }
+	bool empty() const { return (count == 0); }
+	
+protected:
+	T* data = nullptr;
+	size_t count = 0;
+	
+};
+
+#endif
@@ -0,0 +1,91 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "mesh_bounds.h"
+#include <cfloat>
+
+// rounds the (double) distance up to the next float
+static float conservative_radius(const double squared_distance) {
+	const double distance = sqrt(squared_distance);
+	const float radius = (float)distance;
+	return ((double)radius < distance ? nextafterf(radius, FLT_MAX) : radius);
+}
+
+template <typename vertex_getter> static bounding_sphere compute_sphere(const size_t count, const vertex_getter& get_vertex) {
+	bounding_sphere sphere;
+	if(count == 0) return sphere;
+	
+	float3 bounds_min = get_vertex(0), bounds_max = bounds_min;
+	for(size_t i = 1; i < count; i++) {
+		const float3 vertex = get_vertex(i);
+		bounds_min.x = std::min(bounds_min.x, vertex.x);
+		bounds_min.y = std::min(bounds_min.y, vertex.y);
+		bounds_min.z = std::min(bounds_min.z, vertex.z);
+		bounds_max.x = std::max(bounds_max.x, vertex.x);
+		bounds_max.y = std::max(bounds_max.y, vertex.y);
+		bounds_max.z = std::max(bounds_max.z, vertex.z);
+	}
+	sphere.center = float3((bounds_min.x + bounds_max.x) * 0.5f, (bounds_min.y + bounds_max.y) * 0.5f, (bounds_min.z + bounds_max.z) * 0.5f);
+	
+	double max_squared_distance = 0.0;
+	for(size_t i = 0; i < count; i++) {
+		const float3 vertex = get_vertex(i);
+		const double dx = (double)vertex.x - (double)sphere.center.x;
+		const double dy = (double)vertex.y - (double)sphere.center.y;
+		const double dz = (double)vertex.z - (double)sphere.center.z;
+		max_squared_distance = std::max(max_squared_distance, dx * dx + dy * dy + dz * dz);
+	}
+	sphere.radius = conservative_radius(max_squared_distance);
+	return sphere;
+}
+
+bounding_sphere compute_bounding_sphere(const float3* vertices, const size_t count, const bool rotate) {
+	return compute_sphere(count, [vertices, rotate](const size_t i) { return get_stored_vertex(vertices[i], rotate); });
+}
+
+bounding_sphere compute_bounding_sphere(const float3* vertices, const unsigned int* vertex_indices, const size_t count, const bool rotate) {
+	return compute_sphere(count, [vertices, vertex_indices, rotate](const size_t i) { return get_stored_vertex(vertices[vertex_indices[i]], rotate); });
+}
+
+bounding_sphere merge_bounding_spheres(const bounding_sphere& sphere_1, const bounding_sphere& sphere_2) {
+	const double dx = (double)sphere_2.center.x - (double)sphere_1.center.x;
+	const double dy = (double)sphere_2.center.y - (double)sphere_1.center.y;
+	const double dz = (double)sphere_2.center.z - (double)sphere_1.center.z;
+	const double distance = sqrt(dx * dx + dy * dy + dz * dz);
+	
+	// one sphere contains the other one
+	if(distance + (double)sphere_2.radius <= (double)sphere_1.radius) return sphere_1;
+	if(distance + (double)sphere_1.radius <= (double)sphere_2.radius) return sphere_2;
+	
+	const double radius = (distance + (double)sphere_1.radius + (double)sphere_2.radius) * 0.5;
+	const double t = (radius - (double)sphere_1.radius) / distance;
+	bounding_sphere merged;
+	merged.center = float3((float)((double)sphere_1.center.x + dx * t),
+						   (float)((double)sphere_1.center.y + dy * t),
+						   (float)((double)sphere_1.center.z + dz * t));
+	// the rounded center may be off a bit: grow the radius so that it contains both spheres from the actual center
+	double required_radius = 0.0;
+	for(const bounding_sphere* sphere : { &sphere_1, &sphere_2 }) {
+		const double cx = (double)sphere->center.x - (double)merged.center.x;
+		const double cy = (double)sphere->center.y - (double)merged.center.y;
+		const double cz = (double)sphere->center.z - (double)merged.center.z;
+		required_radius = std::max(required_radius, sqrt(cx * cx + cy * cy + cz * cz) + (double)sphere->radius);
+	}
+	merged.radius = conservative_radius(required_radius * required_radius);
+	return merged;
+}
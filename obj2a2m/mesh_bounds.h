@@ -0,0 +1,44 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_MESH_BOUNDS_H__
+#define __OBJ2A2M_MESH_BOUNDS_H__
+
+#include <a2e.h>
+
+struct bounding_sphere {
+	float3 center;
+	float radius = 0.0f;
+};
+
+// vertex as it is stored in the a2m file (see rotate_vertices)
+inline float3 get_stored_vertex(const float3& vertex, const bool rotate) {
+	return (rotate ? float3(vertex.x, vertex.z, -vertex.y) : vertex);
+}
+
+// sphere around the center of the aabb of the (optionally rotated) vertices that contains all of them
+// (the radius is rounded up, so that the float sphere is conservative)
+bounding_sphere compute_bounding_sphere(const float3* vertices, const size_t count, const bool rotate);
+
+// same for the vertices referenced by the given indices (vertices are only indexed, so they may be referenced multiple times)
+bounding_sphere compute_bounding_sphere(const float3* vertices, const unsigned int* vertex_indices, const size_t count, const bool rotate);
+
+// smallest sphere that contains both spheres (an empty sphere (radius 0 with no vertices) must not be merged)
+bounding_sphere merge_bounding_spheres(const bounding_sphere& sphere_1, const bounding_sphere& sphere_2);
+
+#endif
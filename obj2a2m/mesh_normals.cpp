@@ -0,0 +1,164 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "mesh_normals.h"
+#include <cfloat>
+
+static inline float3 cross(const float3& v1, const float3& v2) {
+	return float3(v1.y * v2.z - v1.z * v2.y, v1.z * v2.x - v1.x * v2.z, v1.x * v2.y - v1.y * v2.x);
+}
+
+static inline float dot(const float3& v1, const float3& v2) {
+	return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+}
+
+// returns the unit vector of v, or fallback if v has no (finite) length
+static inline float3 normalized(const float3& v, const float3& fallback) {
+	const float length = sqrtf(dot(v, v));
+	return (length > 0.0f && length < FLT_MAX ? v * (1.0f / length) : fallback);
+}
+
+// angle between the (non-normalized) edges e1 and e2
+static inline float corner_angle(const float3& e1, const float3& e2) {
+	const float length = sqrtf(dot(e1, e1) * dot(e2, e2));
+	if(!(length > 0.0f)) return 0.0f;
+	return acosf(std::max(-1.0f, std::min(1.0f, dot(e1, e2) / length)));
+}
+
+void compute_corner_normals(const float3* vertices, const size_t vertex_count, const s_index* indices, const size_t triangle_count,
+							const float3* obj_normals, const size_t obj_normal_count, const s_index* normal_indices,
+							const unsigned int* smoothing_groups, vector<float3>& corner_normals) {
+	static const float3 default_normal(0.0f, 1.0f, 0.0f);
+	corner_normals.resize(triangle_count * 3);
+	
+	// accumulated normal of each (vertex, smoothing group), the groups of a vertex are linked in the order of their first use
+	struct group_normal {
+		unsigned int group;
+		unsigned int next;
+		float3 normal;
+	};
+	vector<unsigned int> vertex_groups(vertex_count, ~0u);
+	vector<group_normal> group_normals;
+	group_normals.reserve(vertex_count);
+	// group normal of each corner (~0u if the corner doesn't use one)
+	vector<unsigned int> corner_groups(triangle_count * 3, ~0u);
+	
+	for(size_t i = 0; i < triangle_count; i++) {
+		const float3& v0 = vertices[indices[i].indices[0]];
+		const float3& v1 = vertices[indices[i].indices[1]];
+		const float3& v2 = vertices[indices[i].indices[2]];
+		const float3 face_normal = normalized(cross(v1 - v0, v2 - v0), float3(0.0f, 0.0f, 0.0f));
+		const float angles[3] {
+			corner_angle(v1 - v0, v2 - v0), corner_angle(v2 - v1, v0 - v1), corner_angle(v0 - v2, v1 - v2)
+		};
+		const unsigned int group = (smoothing_groups != nullptr ? smoothing_groups[i] : 1);
+		
+		for(unsigned int k = 0; k < 3; k++) {
+			const size_t corner = i * 3 + k;
+			const unsigned int normal_index = (normal_indices != nullptr ? normal_indices[i].indices[k] : ~0u);
+			if(normal_index < obj_normal_count) {
+				corner_normals[corner] = normalized(obj_normals[normal_index], normalized(face_normal, default_normal));
+				continue;
+			}
+			if(group == 0) {
+				corner_normals[corner] = normalized(face_normal, default_normal);
+				continue;
+			}
+			
+			unsigned int* link = &vertex_groups[indices[i].indices[k]];
+			while(*link != ~0u && group_normals[*link].group != group) {
+				link = &group_normals[*link].next;
+			}
+			unsigned int group_index = *link;
+			if(group_index == ~0u) {
+				// (link may point into group_normals, which can be reallocated by the push_back)
+				group_index = (unsigned int)group_normals.size();
+				*link = group_index;
+				group_normals.push_back(group_normal { group, ~0u, float3(0.0f, 0.0f, 0.0f) });
+			}
+			group_normals[group_index].normal += face_normal * angles[k];
+			corner_groups[corner] = group_index;
+		}
+	}
+	
+	for(auto& entry : group_normals) {
+		entry.normal = normalized(entry.normal, default_normal);
+	}
+	for(size_t i = 0; i < corner_groups.size(); i++) {
+		if(corner_groups[i] != ~0u) corner_normals[i] = group_normals[corner_groups[i]].normal;
+	}
+}
+
+void compute_tangents(const float* positions, const float* tex_coords, const float* normals, const size_t vertex_count,
+					  const s_index* indices, const size_t triangle_count, vector<vertex_tangent>& tangents) {
+	// per vertex sums of the triangle tangents (t) and bitangents (b), stored as flat component arrays
+	vector<float> sums(vertex_count * 6, 0.0f);
+	float* tx = sums.data();
+	float* ty = tx + vertex_count;
+	float* tz = ty + vertex_count;
+	float* bx = tz + vertex_count;
+	float* by = bx + vertex_count;
+	float* bz = by + vertex_count;
+	
+	for(size_t i = 0; i < triangle_count; i++) {
+		const unsigned int i0 = indices[i].indices[0], i1 = indices[i].indices[1], i2 = indices[i].indices[2];
+		const float e1[3] { positions[i1 * 3] - positions[i0 * 3], positions[i1 * 3 + 1] - positions[i0 * 3 + 1], positions[i1 * 3 + 2] - positions[i0 * 3 + 2] };
+		const float e2[3] { positions[i2 * 3] - positions[i0 * 3], positions[i2 * 3 + 1] - positions[i0 * 3 + 1], positions[i2 * 3 + 2] - positions[i0 * 3 + 2] };
+		const float du1 = tex_coords[i1 * 2] - tex_coords[i0 * 2], dv1 = tex_coords[i1 * 2 + 1] - tex_coords[i0 * 2 + 1];
+		const float du2 = tex_coords[i2 * 2] - tex_coords[i0 * 2], dv2 = tex_coords[i2 * 2 + 1] - tex_coords[i0 * 2 + 1];
+		const float det = du1 * dv2 - du2 * dv1;
+		// triangles without a texture mapping (or a degenerate one) don't contribute
+		if(!(fabsf(det) > 0.0f)) continue;
+		
+		const float r = 1.0f / det;
+		const float t[3] { (e1[0] * dv2 - e2[0] * dv1) * r, (e1[1] * dv2 - e2[1] * dv1) * r, (e1[2] * dv2 - e2[2] * dv1) * r };
+		const float b[3] { (e2[0] * du1 - e1[0] * du2) * r, (e2[1] * du1 - e1[1] * du2) * r, (e2[2] * du1 - e1[2] * du2) * r };
+		for(const unsigned int vertex : { i0, i1, i2 }) {
+			tx[vertex] += t[0];
+			ty[vertex] += t[1];
+			tz[vertex] += t[2];
+			bx[vertex] += b[0];
+			by[vertex] += b[1];
+			bz[vertex] += b[2];
+		}
+	}
+	
+	// gram-schmidt + handedness: a branch-free loop over the flat arrays (vectorizable)
+	tangents.resize(vertex_count);
+	for(size_t i = 0; i < vertex_count; i++) {
+		const float nx = normals[i * 3], ny = normals[i * 3 + 1], nz = normals[i * 3 + 2];
+		const float n_dot_t = nx * tx[i] + ny * ty[i] + nz * tz[i];
+		const float ox = tx[i] - nx * n_dot_t, oy = ty[i] - ny * n_dot_t, oz = tz[i] - nz * n_dot_t;
+		const float length_sq = ox * ox + oy * oy + oz * oz;
+		const float inv_length = (length_sq > 1.0e-30f ? 1.0f / sqrtf(length_sq) : 0.0f);
+		// cross(n, t) points along the bitangent for a right-handed mapping
+		const float cx = ny * oz - nz * oy, cy = nz * ox - nx * oz, cz = nx * oy - ny * ox;
+		const float handedness = (cx * bx[i] + cy * by[i] + cz * bz[i] < 0.0f ? -1.0f : 1.0f);
+		tangents[i] = vertex_tangent { ox * inv_length, oy * inv_length, oz * inv_length, handedness };
+	}
+	
+	// vertices without a usable mapping: any unit vector that is orthogonal to the normal
+	for(size_t i = 0; i < vertex_count; i++) {
+		vertex_tangent& tangent = tangents[i];
+		if(tangent.x != 0.0f || tangent.y != 0.0f || tangent.z != 0.0f) continue;
+		const float3 normal(normals[i * 3], normals[i * 3 + 1], normals[i * 3 + 2]);
+		const float3 axis = (fabsf(normal.x) < 0.9f ? float3(1.0f, 0.0f, 0.0f) : float3(0.0f, 1.0f, 0.0f));
+		const float3 fallback = normalized(axis - normal * dot(normal, axis), float3(1.0f, 0.0f, 0.0f));
+		tangent = vertex_tangent { fallback.x, fallback.y, fallback.z, 1.0f };
+	}
+}
@@ -0,0 +1,46 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_MESH_NORMALS_H__
+#define __OBJ2A2M_MESH_NORMALS_H__
+
+#include <a2e.h>
+#include "obj_model.h"
+
+// tangent of a vertex: xyz is a unit vector orthogonal to the normal, w (+1 or -1) is the handedness of the
+// tangent space (bitangent = w * cross(normal, tangent))
+struct vertex_tangent {
+	float x, y, z, w;
+};
+
+// computes the unit normal of every triangle corner (3 per triangle): corners with a valid .obj normal index keep
+// that (normalized) normal, all others get the angle-weighted average of the normals of the triangles that share their
+// vertex and smoothing group, triangles in smoothing group 0 ("s off") get their face normal. normal_indices and
+// smoothing_groups may be nullptr (no .obj normals, all triangles are smoothed)
+void compute_corner_normals(const float3* vertices, const size_t vertex_count, const s_index* indices, const size_t triangle_count,
+							const float3* obj_normals, const size_t obj_normal_count, const s_index* normal_indices,
+							const unsigned int* smoothing_groups, vector<float3>& corner_normals);
+
+// computes the tangent of every vertex from the texture coordinates of the triangles: the tangents and bitangents of
+// the triangles are accumulated per vertex and orthogonalized against the vertex normal (gram-schmidt). positions,
+// tex_coords and normals are flat arrays (3, 2 and 3 floats per vertex), vertices without a usable texture mapping
+// get an arbitrary tangent that is orthogonal to their normal
+void compute_tangents(const float* positions, const float* tex_coords, const float* normals, const size_t vertex_count,
+					  const s_index* indices, const size_t triangle_count, vector<vertex_tangent>& tangents);
+
+#endif
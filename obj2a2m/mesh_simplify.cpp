@@ -0,0 +1,365 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "mesh_simplify.h"
+
+// (not normalized) normal of the triangle, its length is twice the area
+static void triangle_normal(const float3& v0, const float3& v1, const float3& v2, double normal[3]) {
+	const double e1[3] { (double)v1.x - (double)v0.x, (double)v1.y - (double)v0.y, (double)v1.z - (double)v0.z };
+	const double e2[3] { (double)v2.x - (double)v0.x, (double)v2.y - (double)v0.y, (double)v2.z - (double)v0.z };
+	normal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+	normal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+	normal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+void mesh_simplifier::quadric::add_plane(const double nx, const double ny, const double nz, const double d, const double plane_weight) {
+	a00 += plane_weight * nx * nx;
+	a01 += plane_weight * nx * ny;
+	a02 += plane_weight * nx * nz;
+	a11 += plane_weight * ny * ny;
+	a12 += plane_weight * ny * nz;
+	a22 += plane_weight * nz * nz;
+	b0 += plane_weight * nx * d;
+	b1 += plane_weight * ny * d;
+	b2 += plane_weight * nz * d;
+	c += plane_weight * d * d;
+	weight += plane_weight;
+}
+
+void mesh_simplifier::quadric::add(const quadric& q) {
+	a00 += q.a00;
+	a01 += q.a01;
+	a02 += q.a02;
+	a11 += q.a11;
+	a12 += q.a12;
+	a22 += q.a22;
+	b0 += q.b0;
+	b1 += q.b1;
+	b2 += q.b2;
+	c += q.c;
+	weight += q.weight;
+}
+
+double mesh_simplifier::quadric::evaluate(const float3& position) const {
+	if(!(weight > 0.0)) return 0.0;
+	const double x = position.x, y = position.y, z = position.z;
+	const double error = (a00 * x * x + a11 * y * y + a22 * z * z +
+						  2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+						  2.0 * (b0 * x + b1 * y + b2 * z) + c);
+	// (rounding can make it slightly negative)
+	return std::max(error, 0.0) / weight;
+}
+
+mesh_simplifier::mesh_simplifier(const float3* vertices_, const size_t vertex_count, const s_index* indices_, const s_index* tex_indices_,
+								 const size_t triangle_count) : vertices(vertices_), quadrics(vertex_count) {
+	// triangles that use a vertex more than once (after welding) aren't visible and would break the edge topology
+	indices.reserve(triangle_count);
+	tex_indices.reserve(triangle_count);
+	for(size_t i = 0; i < triangle_count; i++) {
+		const unsigned int* triangle = indices_[i].indices;
+		if(triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2]) continue;
+		indices.push_back(indices_[i]);
+		tex_indices.push_back(tex_indices_[i]);
+	}
+	
+	// area weighted triangle planes
+	for(const auto& triangle : indices) {
+		const float3& v0 = vertices[triangle.indices[0]];
+		double normal[3];
+		triangle_normal(v0, vertices[triangle.indices[1]], vertices[triangle.indices[2]], normal);
+		const double length = sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		if(!(length > 0.0)) continue;
+		for(unsigned int k = 0; k < 3; k++) normal[k] /= length;
+		const double d = -(normal[0] * v0.x + normal[1] * v0.y + normal[2] * v0.z);
+		for(unsigned int k = 0; k < 3; k++) {
+			quadrics[triangle.indices[k]].add_plane(normal[0], normal[1], normal[2], d, length * 0.5);
+		}
+	}
+	
+	// planes through the open edges (perpendicular to their triangle), so that the borders keep their shape
+	update_topology();
+	for(const auto& triangle : indices) {
+		double normal[3];
+		triangle_normal(vertices[triangle.indices[0]], vertices[triangle.indices[1]], vertices[triangle.indices[2]], normal);
+		for(unsigned int k = 0; k < 3; k++) {
+			const unsigned int v0 = triangle.indices[k], v1 = triangle.indices[(k + 1) % 3];
+			if(count_directed_edges(v1, v0) != 0 || count_directed_edges(v0, v1) != 1) continue;
+			
+			const float3& p0 = vertices[v0];
+			const float3& p1 = vertices[v1];
+			const double edge[3] { (double)p1.x - (double)p0.x, (double)p1.y - (double)p0.y, (double)p1.z - (double)p0.z };
+			double plane_normal[3] {
+				edge[1] * normal[2] - edge[2] * normal[1],
+				edge[2] * normal[0] - edge[0] * normal[2],
+				edge[0] * normal[1] - edge[1] * normal[0],
+			};
+			const double length = sqrt(plane_normal[0] * plane_normal[0] + plane_normal[1] * plane_normal[1] + plane_normal[2] * plane_normal[2]);
+			if(!(length > 0.0)) continue;
+			for(unsigned int c = 0; c < 3; c++) plane_normal[c] /= length;
+			const double d = -(plane_normal[0] * p0.x + plane_normal[1] * p0.y + plane_normal[2] * p0.z);
+			const double plane_weight = (edge[0] * edge[0] + edge[1] * edge[1] + edge[2] * edge[2]) * MESH_SIMPLIFY_BORDER_WEIGHT;
+			quadrics[v0].add_plane(plane_normal[0], plane_normal[1], plane_normal[2], d, plane_weight);
+			quadrics[v1].add_plane(plane_normal[0], plane_normal[1], plane_normal[2], d, plane_weight);
+		}
+	}
+}
+
+unsigned int mesh_simplifier::count_directed_edges(const unsigned int from, const unsigned int to) const {
+	unsigned int count = 0;
+	for(unsigned int j = adjacency_offsets[from]; j < adjacency_offsets[from + 1]; j++) {
+		const unsigned int* triangle = indices[adjacency[j]].indices;
+		for(unsigned int k = 0; k < 3; k++) {
+			if(triangle[k] == from && triangle[(k + 1) % 3] == to) count++;
+		}
+	}
+	return count;
+}
+
+void mesh_simplifier::update_topology() {
+	const size_t vertex_count = quadrics.size();
+	const size_t triangle_count = indices.size();
+	
+	// triangles of each vertex
+	adjacency_offsets.assign(vertex_count + 1, 0);
+	for(const auto& triangle : indices) {
+		for(unsigned int k = 0; k < 3; k++) {
+			adjacency_offsets[triangle.indices[k] + 1]++;
+		}
+	}
+	for(size_t i = 0; i < vertex_count; i++) {
+		adjacency_offsets[i + 1] += adjacency_offsets[i];
+	}
+	adjacency.resize(triangle_count * 3);
+	vector<unsigned int> fill_offsets(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+	for(size_t i = 0; i < triangle_count; i++) {
+		for(unsigned int k = 0; k < 3; k++) {
+			adjacency[fill_offsets[indices[i].indices[k]]++] = (unsigned int)i;
+		}
+	}
+	
+	// an edge is manifold if it is used once in each direction, open if it is only used in one direction
+	vertex_flags.assign(vertex_count, 0);
+	for(const auto& triangle : indices) {
+		for(unsigned int k = 0; k < 3; k++) {
+			const unsigned int v0 = triangle.indices[k], v1 = triangle.indices[(k + 1) % 3];
+			const unsigned int twin_count = count_directed_edges(v1, v0);
+			if(twin_count > 1 || count_directed_edges(v0, v1) > 1) {
+				vertex_flags[v0] |= COMPLEX;
+				vertex_flags[v1] |= COMPLEX;
+			}
+			else if(twin_count == 0) {
+				vertex_flags[v0] |= BORDER;
+				vertex_flags[v1] |= BORDER;
+			}
+		}
+	}
+	removed_triangles.assign(triangle_count, false);
+}
+
+size_t mesh_simplifier::simplify(const size_t target_triangle_count) {
+	while(indices.size() > target_triangle_count && collapse_pass(target_triangle_count)) {
+		// next pass
+	}
+	return indices.size();
+}
+
+bool mesh_simplifier::collapse_pass(const size_t target_triangle_count) {
+	update_topology();
+	
+	// cheapest direction of every edge that may be collapsed
+	struct candidate {
+		unsigned int from;
+		unsigned int to;
+		double error;
+		double length; // squared edge length
+	};
+	vector<candidate> candidates;
+	candidates.reserve(indices.size() * 3 / 2);
+	for(const auto& triangle : indices) {
+		for(unsigned int k = 0; k < 3; k++) {
+			const unsigned int v0 = triangle.indices[k], v1 = triangle.indices[(k + 1) % 3];
+			const bool border_edge = (count_directed_edges(v1, v0) == 0);
+			// interior edges are seen from both of their triangles
+			if(!border_edge && v0 > v1) continue;
+			
+			candidate best { 0, 0, -1.0, 0.0 };
+			for(unsigned int direction = 0; direction < 2; direction++) {
+				const unsigned int from = (direction == 0 ? v0 : v1), to = (direction == 0 ? v1 : v0);
+				if((vertex_flags[from] & COMPLEX) != 0) continue;
+				// border vertices may only move along the border
+				if((vertex_flags[from] & BORDER) != 0 && !border_edge) continue;
+				
+				quadric q = quadrics[from];
+				q.add(quadrics[to]);
+				const double error = q.evaluate(vertices[to]);
+				if(best.error < 0.0 || error < best.error) best = candidate { from, to, error, 0.0 };
+			}
+			if(best.error < 0.0) continue;
+			const float3& p0 = vertices[v0];
+			const float3& p1 = vertices[v1];
+			best.length = (((double)p1.x - (double)p0.x) * ((double)p1.x - (double)p0.x) +
+						   ((double)p1.y - (double)p0.y) * ((double)p1.y - (double)p0.y) +
+						   ((double)p1.z - (double)p0.z) * ((double)p1.z - (double)p0.z));
+			candidates.push_back(best);
+		}
+	}
+	if(candidates.empty()) return false;
+	sort(candidates.begin(), candidates.end(), [](const candidate& c1, const candidate& c2) {
+		if(c1.error != c2.error) return (c1.error < c2.error);
+		// equal errors (e.g. flat areas): shorter edges first, so that the triangles stay evenly sized
+		if(c1.length != c2.length) return (c1.length < c2.length);
+		if(c1.from != c2.from) return (c1.from < c2.from);
+		return (c1.to < c2.to);
+	});
+	
+	// collapse the cheapest edges (at most one collapse per one-ring). an interior collapse removes two triangles, so
+	// about remove_count / 2 collapses are needed: edges that are much more expensive than the last of these are left
+	// for the next pass (with updated quadrics). rejected edges don't count, they would stall the simplification
+	const size_t triangle_count = indices.size();
+	const size_t remove_count = triangle_count - target_triangle_count;
+	size_t removed_count = 0, rejected_count = 0;
+	bool collapsed = false;
+	for(const auto& cur_candidate : candidates) {
+		if(removed_count >= remove_count) break;
+		const size_t limit_index = std::min(remove_count / 2 + rejected_count, candidates.size() - 1);
+		if(collapsed && cur_candidate.error > candidates[limit_index].error * 1.5) break;
+		if(((vertex_flags[cur_candidate.from] | vertex_flags[cur_candidate.to]) & TOUCHED) != 0) continue;
+		if(collapse(cur_candidate.from, cur_candidate.to, removed_count)) {
+			max_error = std::max(max_error, cur_candidate.error);
+			collapsed = true;
+		}
+		else rejected_count++;
+	}
+	
+	// remove the triangles of the collapsed edges
+	size_t kept = 0;
+	for(size_t i = 0; i < triangle_count; i++) {
+		if(removed_triangles[i]) continue;
+		indices[kept] = indices[i];
+		tex_indices[kept] = tex_indices[i];
+		kept++;
+	}
+	indices.resize(kept);
+	tex_indices.resize(kept);
+	return collapsed;
+}
+
+bool mesh_simplifier::collapse(const unsigned int from, const unsigned int to, size_t& removed_count) {
+	const unsigned int first = adjacency_offsets[from], last = adjacency_offsets[from + 1];
+	const auto find_corner = [](const s_index& triangle, const unsigned int vertex) {
+		for(unsigned int k = 0; k < 3; k++) {
+			if(triangle.indices[k] == vertex) return (int)k;
+		}
+		return -1;
+	};
+	
+	// the texture coordinates of "from" are mapped onto the ones of "to" by the triangles of the edge,
+	// every triangle of "from" must use one of these (otherwise "from" is on a seam that doesn't follow the edge)
+	coord_map.clear();
+	size_t edge_triangle_count = 0;
+	for(unsigned int j = first; j < last; j++) {
+		const unsigned int triangle = adjacency[j];
+		const int to_corner = find_corner(indices[triangle], to);
+		if(to_corner < 0) continue;
+		edge_triangle_count++;
+		const unsigned int from_coord = tex_indices[triangle].indices[find_corner(indices[triangle], from)];
+		const unsigned int to_coord = tex_indices[triangle].indices[to_corner];
+		bool mapped = false;
+		for(const auto& mapping : coord_map) {
+			if(mapping.first != from_coord) continue;
+			if(mapping.second != to_coord) return false;
+			mapped = true;
+		}
+		if(!mapped) coord_map.emplace_back(from_coord, to_coord);
+	}
+	if(edge_triangle_count == 0) return false;
+	const auto map_coord = [this](const unsigned int coord_index) {
+		for(const auto& mapping : coord_map) {
+			if(mapping.first == coord_index) return mapping.second;
+		}
+		return ~0u;
+	};
+	
+	// link condition: the only vertices that are adjacent to both must be the opposite vertices of the edge triangles,
+	// otherwise the collapse would create non-manifold edges
+	const auto gather_neighbors = [this](const unsigned int vertex, vector<unsigned int>& neighbors) {
+		neighbors.clear();
+		for(unsigned int j = adjacency_offsets[vertex]; j < adjacency_offsets[vertex + 1]; j++) {
+			for(const auto& index : indices[adjacency[j]].indices) {
+				if(index != vertex) neighbors.push_back(index);
+			}
+		}
+		sort(neighbors.begin(), neighbors.end());
+		neighbors.erase(unique(neighbors.begin(), neighbors.end()), neighbors.end());
+	};
+	gather_neighbors(from, from_neighbors);
+	gather_neighbors(to, to_neighbors);
+	size_t common_count = 0;
+	for(auto iter_1 = from_neighbors.cbegin(), iter_2 = to_neighbors.cbegin(); iter_1 != from_neighbors.cend() && iter_2 != to_neighbors.cend(); ) {
+		if(*iter_1 < *iter_2) ++iter_1;
+		else if(*iter_2 < *iter_1) ++iter_2;
+		else {
+			common_count++;
+			++iter_1;
+			++iter_2;
+		}
+	}
+	if(common_count != edge_triangle_count) return false;
+	
+	// the remaining triangles must keep their texture coordinates and must not flip (or become degenerate)
+	for(unsigned int j = first; j < last; j++) {
+		const s_index& triangle = indices[adjacency[j]];
+		if(find_corner(triangle, to) >= 0) continue;
+		const int from_corner = find_corner(triangle, from);
+		if(map_coord(tex_indices[adjacency[j]].indices[from_corner]) == ~0u) return false;
+		
+		float3 positions[3];
+		for(unsigned int k = 0; k < 3; k++) {
+			positions[k] = vertices[(int)k == from_corner ? to : triangle.indices[k]];
+		}
+		double old_normal[3], new_normal[3];
+		triangle_normal(vertices[triangle.indices[0]], vertices[triangle.indices[1]], vertices[triangle.indices[2]], old_normal);
+		triangle_normal(positions[0], positions[1], positions[2], new_normal);
+		const double old_length = sqrt(old_normal[0] * old_normal[0] + old_normal[1] * old_normal[1] + old_normal[2] * old_normal[2]);
+		const double new_length = sqrt(new_normal[0] * new_normal[0] + new_normal[1] * new_normal[1] + new_normal[2] * new_normal[2]);
+		const double normal_dot = old_normal[0] * new_normal[0] + old_normal[1] * new_normal[1] + old_normal[2] * new_normal[2];
+		if(!(new_length > 0.0) || normal_dot < MESH_SIMPLIFY_MIN_NORMAL_DOT * old_length * new_length) return false;
+	}
+	
+	// collapse: the edge triangles are removed, all other triangles of "from" use "to" instead
+	for(unsigned int j = first; j < last; j++) {
+		const unsigned int triangle = adjacency[j];
+		if(find_corner(indices[triangle], to) >= 0) {
+			removed_triangles[triangle] = true;
+			removed_count++;
+			continue;
+		}
+		const int from_corner = find_corner(indices[triangle], from);
+		indices[triangle].indices[from_corner] = to;
+		tex_indices[triangle].indices[from_corner] = map_coord(tex_indices[triangle].indices[from_corner]);
+	}
+	quadrics[to].add(quadrics[from]);
+	
+	// the one-ring of "from" changed, so its vertices can't be collapsed again in this pass
+	vertex_flags[from] |= TOUCHED;
+	vertex_flags[to] |= TOUCHED;
+	for(const auto& neighbor : from_neighbors) {
+		vertex_flags[neighbor] |= TOUCHED;
+	}
+	return true;
+}
@@ -0,0 +1,95 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_MESH_SIMPLIFY_H__
+#define __OBJ2A2M_MESH_SIMPLIFY_H__
+
+#include <a2e.h>
+#include "obj_model.h"
+
+// weight of the planes that keep open borders in place (relative to the area weighted triangle planes)
+#define MESH_SIMPLIFY_BORDER_WEIGHT 10.0
+// a collapse is rejected if it turns the normal of a remaining triangle by more than ~85 degrees
+#define MESH_SIMPLIFY_MIN_NORMAL_DOT 0.1
+
+// quadric error metric simplification (garland/heckbert) by half-edge collapses: a vertex is always collapsed onto one
+// of its neighbors, so the simplified triangles only reference the original vertices and texture coordinates.
+// uv seams are preserved: every texture coordinate of the collapsed vertex must be mapped onto a texture coordinate of
+// the target vertex by a triangle of the collapsed edge, so vertices on a seam can only move along the seam. vertices on
+// open borders can only move along the border, vertices on non-manifold edges are never collapsed.
+// the simplifier keeps its state, so that a lod chain can be built by simplifying further and further.
+class mesh_simplifier {
+public:
+	mesh_simplifier(const float3* vertices, const size_t vertex_count, const s_index* indices, const s_index* tex_indices,
+					const size_t triangle_count);
+	
+	// simplifies the current triangles until at most target_triangle_count triangles are left (or no more collapses
+	// are possible), returns the amount of triangles that are left
+	size_t simplify(const size_t target_triangle_count);
+	
+	const vector<s_index>& get_indices() const { return indices; }
+	const vector<s_index>& get_tex_indices() const { return tex_indices; }
+	// approximate distance of the simplified surface to the original one (max of all collapses so far)
+	float get_error() const { return (float)sqrt(max_error); }
+	
+protected:
+	// symmetric 4x4 matrix (a = upper 3x3, b = last column, c = last element) and the sum of the plane weights
+	struct quadric {
+		double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+		double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+		double c = 0.0;
+		double weight = 0.0;
+		
+		void add_plane(const double nx, const double ny, const double nz, const double d, const double plane_weight);
+		void add(const quadric& q);
+		// weighted mean squared distance of position to the planes
+		double evaluate(const float3& position) const;
+	};
+	
+	const float3* vertices;
+	vector<quadric> quadrics;
+	vector<s_index> indices;
+	vector<s_index> tex_indices;
+	double max_error = 0.0;
+	
+	// per-pass state
+	enum VERTEX_FLAG : unsigned char {
+		BORDER = 1,		// on an open edge
+		COMPLEX = 2,	// on a non-manifold edge
+		TOUCHED = 4,	// in the one-ring of a vertex that was collapsed in this pass
+	};
+	vector<unsigned char> vertex_flags;
+	vector<unsigned int> adjacency_offsets;
+	vector<unsigned int> adjacency;
+	vector<bool> removed_triangles;
+	vector<unsigned int> from_neighbors, to_neighbors;
+	vector<pair<unsigned int, unsigned int>> coord_map;
+	
+	// rebuilds the triangles of each vertex and the vertex flags
+	void update_topology();
+	// amount of triangles that contain the edge from -> to (in this winding)
+	unsigned int count_directed_edges(const unsigned int from, const unsigned int to) const;
+	bool collapse_pass(const size_t target_triangle_count);
+	bool collapse(const unsigned int from, const unsigned int to, size_t& removed_count);
+	
+	mesh_simplifier(const mesh_simplifier&) = delete;
+	mesh_simplifier& operator=(const mesh_simplifier&) = delete;
+	
+};
+
+#endif
@@ -0,0 +1,221 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "meshlets.h"
+
+// computes the bounding sphere and normal cone of the triangles of a meshlet (see meshlet)
+static void compute_meshlet_bounds(const float3* vertices, const bool rotate, const s_index* triangles,
+								   const vector<unsigned int>& meshlet_vertices, meshlet& cluster) {
+	cluster.sphere = compute_bounding_sphere(vertices, meshlet_vertices.data(), meshlet_vertices.size(), rotate);
+	
+	// normal cone: average of the unit normals, the cone angle is given by the normal that deviates most from it
+	vector<float3> normals;
+	normals.reserve(cluster.triangle_count);
+	float3 axis(0.0f, 0.0f, 0.0f);
+	for(uint32_t i = 0; i < cluster.triangle_count; i++) {
+		const s_index& triangle = triangles[cluster.first_triangle + i];
+		const float3 v0 = get_stored_vertex(vertices[triangle.indices[0]], rotate);
+		const float3 v1 = get_stored_vertex(vertices[triangle.indices[1]], rotate);
+		const float3 v2 = get_stored_vertex(vertices[triangle.indices[2]], rotate);
+		const float3 e1 = v1 - v0, e2 = v2 - v0;
+		float3 normal(e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x);
+		const float length = sqrtf(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+		// degenerate triangles are never visible and don't restrict the cone
+		if(!(length > 0.0f)) continue;
+		normal = normal * (1.0f / length);
+		normals.push_back(normal);
+		axis += normal;
+	}
+	const float axis_length = sqrtf(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+	float min_dot = 1.0f;
+	if(axis_length > 0.0f) {
+		axis = axis * (1.0f / axis_length);
+		for(const auto& normal : normals) {
+			min_dot = std::min(min_dot, normal.x * axis.x + normal.y * axis.y + normal.z * axis.z);
+		}
+	}
+	
+	// cones wider than ~168 degrees aren't useful (and make the apex computation below unstable)
+	if(normals.empty() || !(axis_length > 0.0f) || min_dot <= 0.1f) {
+		cluster.cone_apex = cluster.sphere.center;
+		cluster.cone_axis = float3(0.0f, 0.0f, 0.0f);
+		cluster.cone_cutoff = 1.0f;
+		return;
+	}
+	
+	// the apex is the point on the line center - t * axis that lies behind (or on) all triangle planes
+	float max_t = 0.0f;
+	size_t normal_index = 0;
+	for(uint32_t i = 0; i < cluster.triangle_count; i++) {
+		const s_index& triangle = triangles[cluster.first_triangle + i];
+		const float3 v0 = get_stored_vertex(vertices[triangle.indices[0]], rotate);
+		const float3 v1 = get_stored_vertex(vertices[triangle.indices[1]], rotate);
+		const float3 v2 = get_stored_vertex(vertices[triangle.indices[2]], rotate);
+		const float3 e1 = v1 - v0, e2 = v2 - v0;
+		const float3 normal(e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x);
+		if(!(sqrtf(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z) > 0.0f)) continue;
+		const float3& unit_normal = normals[normal_index++];
+		const float3 to_center = cluster.sphere.center - v0;
+		const float dc = to_center.x * unit_normal.x + to_center.y * unit_normal.y + to_center.z * unit_normal.z;
+		const float dn = axis.x * unit_normal.x + axis.y * unit_normal.y + axis.z * unit_normal.z;
+		max_t = std::max(max_t, dc / dn);
+	}
+	cluster.cone_apex = cluster.sphere.center - axis * max_t;
+	cluster.cone_axis = axis;
+	// the normals lie within acos(min_dot) of the axis -> the view directions from which all triangles are back-facing
+	// lie within 90 - acos(min_dot) degrees of the axis, cos(90 - a) = sin(a)
+	cluster.cone_cutoff = sqrtf(1.0f - min_dot * min_dot);
+}
+
+void build_meshlets(const float3* vertices, const size_t vertex_count, const bool rotate,
+					s_index* indices, s_index* tex_indices, const size_t triangle_count, vector<meshlet>& meshlets,
+					s_index* corner_indices, const size_t corner_count) {
+	meshlets.clear();
+	if(triangle_count == 0) return;
+	
+	// the meshlets are grown over the unified corners if there are any
+	const s_index* cluster_indices = (corner_indices != nullptr ? corner_indices : indices);
+	const size_t cluster_vertex_count = (corner_indices != nullptr ? corner_count : vertex_count);
+	
+	// triangles of each vertex
+	vector<unsigned int> adjacency_offsets(cluster_vertex_count + 1, 0);
+	for(size_t i = 0; i < triangle_count; i++) {
+		for(unsigned int k = 0; k < 3; k++) {
+			adjacency_offsets[cluster_indices[i].indices[k] + 1]++;
+		}
+	}
+	for(size_t i = 0; i < cluster_vertex_count; i++) {
+		adjacency_offsets[i + 1] += adjacency_offsets[i];
+	}
+	vector<unsigned int> adjacency(triangle_count * 3);
+	{
+		vector<unsigned int> fill_offsets(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+		for(size_t i = 0; i < triangle_count; i++) {
+			for(unsigned int k = 0; k < 3; k++) {
+				adjacency[fill_offsets[cluster_indices[i].indices[k]]++] = (unsigned int)i;
+			}
+		}
+	}
+	
+	vector<bool> used_triangles(triangle_count, false);
+	// meshlet (+ 1) that currently contains the vertex, 0 = none
+	vector<uint32_t> vertex_meshlets(cluster_vertex_count, 0);
+	vector<unsigned int> order;
+	order.reserve(triangle_count);
+	vector<unsigned int> candidates, meshlet_vertices;
+	size_t next_seed = 0;
+	while(order.size() < triangle_count) {
+		const uint32_t meshlet_id = (uint32_t)meshlets.size() + 1;
+		meshlet cluster;
+		cluster.first_triangle = (uint32_t)order.size();
+		cluster.triangle_count = 0;
+		candidates.clear();
+		meshlet_vertices.clear();
+		
+		const auto get_new_vertex_count = [&](const unsigned int triangle) {
+			unsigned int count = 0;
+			for(unsigned int k = 0; k < 3; k++) {
+				const unsigned int vertex = cluster_indices[triangle].indices[k];
+				if(vertex_meshlets[vertex] != meshlet_id &&
+				   (k == 0 || vertex != cluster_indices[triangle].indices[0]) &&
+				   (k < 2 || vertex != cluster_indices[triangle].indices[1])) {
+					count++;
+				}
+			}
+			return count;
+		};
+		const auto add_triangle = [&](const unsigned int triangle) {
+			used_triangles[triangle] = true;
+			order.push_back(triangle);
+			cluster.triangle_count++;
+			for(unsigned int k = 0; k < 3; k++) {
+				const unsigned int vertex = cluster_indices[triangle].indices[k];
+				if(vertex_meshlets[vertex] == meshlet_id) continue;
+				vertex_meshlets[vertex] = meshlet_id;
+				meshlet_vertices.push_back(vertex);
+				for(unsigned int j = adjacency_offsets[vertex]; j < adjacency_offsets[vertex + 1]; j++) {
+					if(!used_triangles[adjacency[j]]) candidates.push_back(adjacency[j]);
+				}
+			}
+		};
+		
+		while(used_triangles[next_seed]) next_seed++;
+		add_triangle((unsigned int)next_seed);
+		while(cluster.triangle_count < MESHLET_MAX_TRIANGLES) {
+			// adjacent triangle that adds the fewest vertices (the earliest one on ties), used triangles are dropped
+			unsigned int best_triangle = ~0u, best_new_vertices = 4;
+			size_t kept = 0;
+			for(size_t i = 0; i < candidates.size(); i++) {
+				const unsigned int triangle = candidates[i];
+				if(used_triangles[triangle]) continue;
+				candidates[kept++] = triangle;
+				const unsigned int new_vertices = get_new_vertex_count(triangle);
+				if(meshlet_vertices.size() + new_vertices > MESHLET_MAX_VERTICES) continue;
+				if(new_vertices < best_new_vertices || (new_vertices == best_new_vertices && triangle < best_triangle)) {
+					best_triangle = triangle;
+					best_new_vertices = new_vertices;
+				}
+			}
+			candidates.resize(kept);
+			
+			// nothing adjacent fits: continue with the next unused triangle (triangle soups, disconnected parts)
+			if(best_triangle == ~0u && candidates.empty()) {
+				while(next_seed < triangle_count && used_triangles[next_seed]) next_seed++;
+				if(next_seed < triangle_count && meshlet_vertices.size() + get_new_vertex_count((unsigned int)next_seed) <= MESHLET_MAX_VERTICES) {
+					best_triangle = (unsigned int)next_seed;
+				}
+			}
+			if(best_triangle == ~0u) break;
+			add_triangle(best_triangle);
+		}
+		cluster.vertex_count = (uint32_t)meshlet_vertices.size();
+		meshlets.push_back(cluster);
+		if(next_seed < triangle_count && used_triangles[next_seed]) next_seed++;
+	}
+	
+	// store the triangles in meshlet order
+	vector<s_index> ordered_indices(triangle_count), ordered_tex_indices(triangle_count);
+	for(size_t i = 0; i < triangle_count; i++) {
+		ordered_indices[i] = indices[order[i]];
+		ordered_tex_indices[i] = tex_indices[order[i]];
+	}
+	copy(ordered_indices.begin(), ordered_indices.end(), indices);
+	copy(ordered_tex_indices.begin(), ordered_tex_indices.end(), tex_indices);
+	if(corner_indices != nullptr) {
+		for(size_t i = 0; i < triangle_count; i++) {
+			ordered_indices[i] = corner_indices[order[i]];
+		}
+		copy(ordered_indices.begin(), ordered_indices.end(), corner_indices);
+	}
+	
+	// bounds and cones of the final triangle ranges
+	vertex_meshlets.assign(vertex_count, 0);
+	for(auto& cluster : meshlets) {
+		meshlet_vertices.clear();
+		const uint32_t meshlet_id = (uint32_t)(&cluster - meshlets.data()) + 1;
+		for(uint32_t i = 0; i < cluster.triangle_count; i++) {
+			for(unsigned int k = 0; k < 3; k++) {
+				const unsigned int vertex = indices[cluster.first_triangle + i].indices[k];
+				if(vertex_meshlets[vertex] == meshlet_id) continue;
+				vertex_meshlets[vertex] = meshlet_id;
+				meshlet_vertices.push_back(vertex);
+			}
+		}
+		compute_meshlet_bounds(vertices, rotate, indices, meshlet_vertices, cluster);
+	}
+}
@@ -0,0 +1,53 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_MESHLETS_H__
+#define __OBJ2A2M_MESHLETS_H__
+
+#include <a2e.h>
+#include "obj_model.h"
+#include "mesh_bounds.h"
+
+// max amount of vertices and triangles of a meshlet (the usual mesh shader limits)
+#define MESHLET_MAX_VERTICES 64u
+#define MESHLET_MAX_TRIANGLES 124u
+
+// triangle cluster of a sub-object: a contiguous range of its triangles with a bounding sphere and a normal cone.
+// the whole meshlet faces away from a camera at position p if dot(normalize(cone_apex - p), cone_axis) >= cone_cutoff
+// (meshlets whose normals spread too much have a zero axis and a cutoff of 1, so that they are never culled)
+struct meshlet {
+	uint32_t first_triangle; // relative to the first triangle of the sub-object
+	uint32_t triangle_count;
+	uint32_t vertex_count; // unique vertices
+	bounding_sphere sphere;
+	float3 cone_apex;
+	float3 cone_axis;
+	float cone_cutoff;
+};
+
+// partitions the triangles (with vertex indices into vertices) into meshlets of at most MESHLET_MAX_VERTICES
+// vertices and MESHLET_MAX_TRIANGLES triangles: meshlets are grown from the first unused triangle (in the current
+// triangle order) by adding the adjacent triangle that adds the fewest new vertices. the triangles (vertex and texture
+// coordinate indices) are reordered so that every meshlet is a contiguous range. bounds and cones are computed from the
+// (optionally rotated) vertices as they are stored. if corner_indices are given (corner_count unified vertex + texture
+// coordinate pairs, see -interleaved), the vertex limit and vertex_count refer to these instead (they are reordered as well)
+void build_meshlets(const float3* vertices, const size_t vertex_count, const bool rotate,
+					s_index* indices, s_index* tex_indices, const size_t triangle_count, vector<meshlet>& meshlets,
+					s_index* corner_indices = nullptr, const size_t corner_count = 0);
+
+#endif
@@ -51,322 +51,239 @@
  * 		[INDEX COUNT - 4 bytes]
  * 		[INDICES - 4 bytes * 3 * INDEX COUNT]
  * 		[END OF MODEL]
+ *
+ *
+ * A2E static model format v3 (-a2m_v3), meant to be memory-mapped:
+ * all values are little endian, all sections start at a 16 byte aligned offset (padded with zeros)
+ *
+ * [A2EMODEL - 8 bytes]
+ * [VERSION - 4 bytes (unsigned int) = 0x00000003]
+ * [FLAGS - 4 bytes (0x02 = has a collision model, 0x04 = compact encoding, 0x08 = interleaved encoding, 0x10 = normals, 0x20 = tangents)]
+ * [HEADER SIZE - 4 bytes = 64]
+ * [SECTION COUNT - 4 bytes]
+ * [SECTION TABLE OFFSET - 8 bytes]
+ * [FILE SIZE - 8 bytes]
+ * [RESERVED - 24 bytes]
+ * [FOR EACH SECTION] (section table)
+ * 		[TYPE - 4 bytes (see A2M_V3_SECTION)]
+ * 		[FLAGS - 4 bytes (0x01 = zlib compressed)]
+ * 		[OFFSET - 8 bytes]
+ * 		[SIZE - 8 bytes]
+ * 		[ELEMENT COUNT - 8 bytes]
+ * [END FOR]
+ * [SECTIONS]
+ * 		[IF !(FLAGS & 0x0C)]
+ * 			VERTICES: 4 bytes * 3 * VERTEX COUNT
+ * 			TEX_COORDS: 4 bytes * 2 * TEXTURE COORDINATE COUNT
+ * 		OBJECTS: OBJECT COUNT * [NAME OFFSET - 4 bytes] [NAME LENGTH - 4 bytes] [FIRST TRIANGLE - 4 bytes] [TRIANGLE COUNT - 4 bytes]
+ * 		[IF FLAGS & 0x08] (interleaved encoding, -interleaved)
+ * 			INTERLEAVED_VERTICES: 20, 32 or 48 bytes * INTERLEAVED VERTEX COUNT ([POSITION - 4 bytes * 3] [TEXTURE COORDINATE - 4 bytes * 2]
+ * 			                      [IF FLAGS & 0x10] [NORMAL - 4 bytes * 3] [IF FLAGS & 0x20] [TANGENT - 4 bytes * 4 (xyz + handedness)])
+ * 			INTERLEAVED_OBJECTS: OBJECT COUNT * a2m_v3_interleaved_object (16 bytes: vertex range, index block offset and size)
+ * 			INTERLEAVED_INDICES: per object: INDEX SIZE * 3 * TRIANGLE COUNT, relative to the first vertex of the object, 4 byte aligned
+ * 		[IF !(FLAGS & 0x0C)]
+ * 			INDICES: 4 bytes * 3 * TRIANGLE COUNT (all objects)
+ * 			TEX_INDICES: 4 bytes * 3 * TRIANGLE COUNT (all objects)
+ * 		[IF FLAGS & 0x04] (compact encoding, -compact)
+ * 			QUANTIZED_VERTICES: 2 bytes * 3 * VERTEX COUNT (unsigned, relative to the aabb of the sub-object)
+ * 			HALF_TEX_COORDS: 2 bytes * 2 * TEXTURE COORDINATE COUNT (half floats)
+ * 			COMPACT_OBJECTS: OBJECT COUNT * a2m_v3_compact_object (vertex/coord ranges, index block offsets and sizes, aabb)
+ * 			COMPACT_INDICES: per object: INDEX SIZE * 3 * TRIANGLE COUNT, relative to the first vertex of the object, 4 byte aligned
+ * 			COMPACT_TEX_INDICES: per object: TEX INDEX SIZE * 3 * TRIANGLE COUNT, relative to the first coord of the object, 4 byte aligned
+ * 		STRINGS: 0-terminated object names
+ * 		[OPTIONAL] OBJECT_BOUNDS: OBJECT COUNT * a2m_v3_object_bounds (48 bytes: aabb, bounding sphere, meshlet range)
+ * 		[OPTIONAL] MESHLETS: 52 bytes * MESHLET COUNT (see a2m_v3_meshlet, -meshlets)
+ * 		[OPTIONAL] (-lod)
+ * 			LODS: LOD COUNT * OBJECT COUNT * a2m_v3_lod (16 bytes: first triangle, triangle count, ratio, error)
+ * 			LOD_INDICES: 4 bytes * 3 * LOD TRIANGLE COUNT (all lods)
+ * 			[IF !(FLAGS & 0x08)] LOD_TEX_INDICES: 4 bytes * 3 * LOD TRIANGLE COUNT (all lods)
+ * 		[IF FLAGS & 0x02]
+ * 			COLLISION_VERTICES: 4 bytes * 3 * COLLISION VERTEX COUNT
+ * 			COLLISION_INDICES: 4 bytes * 3 * COLLISION TRIANGLE COUNT
+ * 			[OPTIONAL] COLLISION_BVH: 32 bytes * NODE COUNT (see collision_bvh_node, -collision_bvh)
+ *
+ * collision bvh (-collision_bvh, v3 only): a binned sah bvh over the collision triangles, stored as a flattened node array
+ * in depth-first order. an inner node is directly followed by its first child and stores the index of its second child,
+ * a leaf stores the first triangle and triangle count of a contiguous range of COLLISION_INDICES (the collision triangles
+ * are stored in leaf order). every node stores its aabb: [MIN - 4 bytes * 3] [OFFSET - 4 bytes] [MAX - 4 bytes * 3]
+ * [TRIANGLE COUNT - 4 bytes (0 = inner node)]
+ *
+ * culling data (v3 only): OBJECT_BOUNDS is always written and contains the aabb and a bounding sphere of the stored
+ * (rotated) vertices of each sub-object. with -meshlets, the triangles of each sub-object are partitioned into meshlets
+ * of at most 64 vertices and 124 triangles (see build_meshlets), the triangles are stored in meshlet order, so that every
+ * meshlet is a contiguous range of INDICES/TEX_INDICES: [FIRST TRIANGLE - 4 bytes] [TRIANGLE COUNT - 2 bytes]
+ * [VERTEX COUNT - 2 bytes] [SPHERE CENTER - 4 bytes * 3] [SPHERE RADIUS - 4 bytes] [CONE APEX - 4 bytes * 3]
+ * [CONE AXIS - 4 bytes * 3] [CONE CUTOFF - 4 bytes]. a meshlet faces away from a camera at position p (and can be culled)
+ * if dot(normalize(CONE APEX - p), CONE AXIS) >= CONE CUTOFF (meshlets with a wide normal cone have a cutoff of 1).
+ * the meshlets of a sub-object are given by FIRST MESHLET and MESHLET COUNT of its OBJECT_BOUNDS entry.
+ *
+ * lod chain (-lod ratio,ratio,..., v3 only): every sub-object is simplified to the given (decreasing) ratios of its
+ * triangle count with quadric error metrics (see mesh_simplifier), each lod is simplified further from the previous one.
+ * vertices are only collapsed onto other vertices, so the lod triangles index the full resolution VERTICES and
+ * TEX_COORDS (global 4 byte indices, also with the compact encoding). uv seams and open borders are preserved, the
+ * simplification stops early if nothing else can be collapsed. the LODS entries are ordered by lod, then by sub-object,
+ * ERROR is the approximate max distance to the full resolution surface (in model units). not supported with -out_of_core.
+ *
+ * interleaved encoding (-interleaved, v3 only): the vertex and texture coordinate indices of the triangle corners are
+ * unified offline, every distinct (position, texture coordinate) pair of a sub-object becomes one interleaved vertex (in
+ * the order of its first use), so that a renderer can upload INTERLEAVED_VERTICES and the (16 or 32 bit) index block of
+ * each sub-object as they are. meshlets respect the vertex limit in interleaved vertices, LOD_INDICES index the
+ * INTERLEAVED_VERTICES (globally). can't be combined with -compact, not supported with -out_of_core.
+ *
+ * normals and tangents (-normals, -tangents, imply -interleaved): "vn" normals of the .obj are kept (normals of a vertex
+ * only merge if they are equal), missing normals are generated: angle-weighted smooth normals per vertex and smoothing
+ * group ("s" statements, triangles before the first "s" are smoothed, "s off" / "s 0" triangles are flat shaded).
+ * -tangents additionally stores a tangent frame per interleaved vertex, computed from the texture coordinates and
+ * orthogonalized against the normal (w is the bitangent handedness, +1 or -1). the .obj is always memory mapped with
+ * -normals (see -mmap), not supported with -to_obj.
+ *
+ * zlib compressed sections (-compress) are split into chunks that can be decompressed independently (and in parallel),
+ * SIZE in the section table is the compressed size:
+ * [RAW SIZE - 8 bytes]
+ * [CHUNK SIZE - 4 bytes (uncompressed size of all but the last chunk)]
+ * [CHUNK COUNT - 4 bytes]
+ * [COMPRESSED CHUNK SIZE - 4 bytes * CHUNK COUNT]
+ * [ZLIB STREAMS]
+ *
+ *
+ * out-of-core conversion (-out_of_core, -memory_budget MB): for .obj files that don't fit into memory. the .obj data is
+ * streamed into temporary spill files next to the output, the sub-objects are reduced in bounded batches and the output
+ * is written from the spill files (v2 and v3 output, -to_obj, -compact, -interleaved, -compress and -lod are not supported).
+ *
+ * incremental conversion (-incremental): every conversion is recorded in "obj2a2m.manifest" next to the output
+ * (crc32 + size of the .obj, the collision .obj and the mtllib (relative to the .obj), the options and the output
+ * size). once a manifest exists, outputs whose inputs and options didn't change are skipped (this also applies to batch
+ * mode), -force converts them anyway.
+ *
+ * conversion statistics (-stats or --stats=text, --stats=json): the wall clock time of each phase (read, parse, reduce,
+ * sort, weld, dedup, index, write, mat_mapping, bvh, meshlets, lod, normals - sort, weld, dedup, meshlets, lod and
+ * normals are summed over all reduce tasks),
+ * the token/face/quad counts, the welded vertices, the merged texture coordinates and the peak rss of the process.
+ * text stats are logged, json stats are written to "<output>.stats.json".
+ *
+ * verification (-verify): after the conversion (or if the output is up-to-date), the a2m file is read back (see
+ * read_a2m, all versions and encodings are supported) and compared against the .obj (see verify_a2m_model, the normals
+ * against the "vn" normals and smoothing groups, see verify_a2m_normals). with -out_of_core, the .obj is loaded into
+ * memory again for this.
+ *
+ * debug .obj output (-to_obj): instead of the a2m file, the reduced model is written to "<output>.obj" (the a2m filename
+ * with an .obj extension). floats are written with the shortest representation that reads back exactly (see
+ * obj_number::format_float), so the output of repeated runs can be diffed and converting it again is lossless.
  */
 
-pair<string, string> get_face_indices(string face_str) {
-	string vertex_index, coord_index;
-	size_t first_slash, last_slash;
-	// check if face string contains a '/', if not, only a vertex index is specified
-	if((first_slash = face_str.find("/")) != string::npos) {
-		vertex_index = face_str.substr(0, first_slash);
-		
-		// check for second '/', this happens if there is also a normal index specified
-		last_slash = face_str.find_last_of("/");
-		if(first_slash == last_slash-1) {
-			coord_index = "1";
-		}
-		else if(first_slash != last_slash) {
-			coord_index = face_str.substr(first_slash+1, last_slash - first_slash - 1);
-		}
-		else {
-			coord_index = face_str.substr(first_slash+1, face_str.length() - first_slash);
-		}
-	}
-	else {
-		vertex_index = face_str;
-		coord_index = "1";
-		a2e_error("face contains no texture coordinate index - using \"1\"!");
-	}
-	
-	return pair<string, string>(vertex_index, coord_index);
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// batch mode
+
+static bool has_suffix(const string& str, const string& suffix) {
+	return (str.size() > suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0);
 }
 
-inline bool is_number(string str) {
-	if(!(str[0] >= '0' && str[0] <= '9') && str[0] != '-') return false;
-	return true;
+// returns the .a2m filename for a .obj or .obj.gz filename
+static string make_a2m_filename(const string& obj_filename) {
+	string base = obj_filename;
+	if(has_suffix(base, ".gz")) base.erase(base.size() - 3);
+	if(has_suffix(base, ".obj")) base.erase(base.size() - 4);
+	return base + ".a2m";
 }
 
-bool load_obj_data(bool collision_obj, const char* filename, vector<float3*>* vertices, vector<coord*>* tex_coords, map<unsigned int, vector<s_index*>>* indices, map<unsigned int, vector<s_index*>>* tex_indices, map<unsigned int, string>* obj_names, map<unsigned int, string>* obj_mats) {
-	int cur_subobj = -1;
-	bool uvw_texcoord = true;
-	bool quad_face = false;
-	bool init_uvw_check = false;
-	bool set_word = false;
-	
-	// read and store obj data
-	file_io f(filename, file_io::OPEN_TYPE::READ_BINARY);
-	if(!f.is_open()) {
-		a2e_error("couldn't open obj file \"%s\"!", filename);
+bool make_batch_from_list(const string& list_filename, const conversion_options& defaults, vector<conversion_options>& batch) {
+	stringstream buffer;
+	if(!file_io::file_to_buffer(list_filename, buffer)) {
+		a2e_error("couldn't open batch list \"%s\"!", list_filename);
 		return false;
 	}
 	
-	stringstream buffer(stringstream::in | stringstream::out);
-	core::reset(buffer);
-	f.read_file(&buffer);
-	f.close();
-	
-	buffer.seekp(0);
-	buffer.seekg(0);
-	
-	string cur_word, val1, val2, val3, val4;
-	cur_word.reserve(256);
-	val1.reserve(256);
-	val2.reserve(256);
-	val3.reserve(256);
-	val4.reserve(256);
-	
-	map<string, size_t> object_mats;
-	
-	buffer >> cur_word;
-	bool is_word = !buffer.fail();
-	while(is_word && !buffer.eof()) {
-		// vertex
-		if(cur_word == "v") {
-			buffer >> val1;
-			buffer >> val2;
-			buffer >> val3;
-			
-			vertices->push_back(new float3(string2float(val1), string2float(val2), string2float(val3)));
-		}
-		// texture coordinate
-		else if(cur_word == "vt") {
-			buffer >> val1;
-			buffer >> val2;
-			
-			// some .obj files use uvw texture coordinates instead of uv coordinates, do a check at the first occurrence of vt
-			if(!init_uvw_check) {
-				string next_val = buffer.str().substr(1 + buffer.tellg(), 4);
-				if(!is_number(next_val)) {
-					uvw_texcoord = false;
-				}
-				init_uvw_check = true;
-			}
-			
-			if(uvw_texcoord) buffer >> val3; // ignored
-			
-			tex_coords->push_back(new coord());
-			tex_coords->back()->u = string2float(val1);
-			tex_coords->back()->v = string2float(val2);
-		}
-		// normal - ignore
-		else if(cur_word == "vn") {
-		}
-		// smooth group - ignore
-		else if(cur_word == "s") {
-		}
-		// usemtl
-		else if(cur_word == "usemtl") {
-			if(join_mat_objects) {
-				buffer >> val1;
-				if(object_mats.count(val1) == 0) {
-					cur_subobj = obj_names->size();
-					object_mats[val1] = cur_subobj;
-					(*obj_names)[cur_subobj] = val1;
-					if(obj_mats != NULL) {
-						(*obj_mats)[cur_subobj] = val1;
-					}
-				}
-				else {
-					// if join_mat_objects is specified, reuse to sub-object id, thus merging all data for one material
-					cur_subobj = object_mats[val1];
-				}
-			}
-			else {
-				if(obj_mats != NULL) {
-					(*obj_mats)[cur_subobj] = val1;
-				}
-			}
-		}
-		// mtllib
-		else if(cur_word == "mtllib") {
-			buffer >> val1;
-			mtllib = val1;
-		}
-		// face / triangle
-		else if(cur_word == "f") {
-			if(cur_subobj < 0) {
-				a2e_error("invalid obj-format - no sub-object specified!");
-				return false;
-			}
-			
-			buffer >> val1;
-			buffer >> val2;
-			buffer >> val3;
-			buffer >> val4;
-			quad_face = true;
-			
-			// since the .obj format allows mixed triangle and quad faces, we have to check this each time ...
-			if(!is_number(val4)) {
-				cur_word = val4;
-				quad_face = false;
-				set_word = true;
-			}
-			
-			pair<string, string> i1 = get_face_indices(val1);
-			pair<string, string> i2 = get_face_indices(val2);
-			pair<string, string> i3 = get_face_indices(val3);
-			
-			(*indices)[cur_subobj].push_back(new s_index());
-			(*indices)[cur_subobj].back()->indices[0] = string2uint(i1.first) - 1;
-			(*indices)[cur_subobj].back()->indices[1] = string2uint(i2.first) - 1;
-			(*indices)[cur_subobj].back()->indices[2] = string2uint(i3.first) - 1;
-			(*tex_indices)[cur_subobj].push_back(new s_index());
-			(*tex_indices)[cur_subobj].back()->indices[0] = string2uint(i1.second) - 1;
-			(*tex_indices)[cur_subobj].back()->indices[1] = string2uint(i2.second) - 1;
-			(*tex_indices)[cur_subobj].back()->indices[2] = string2uint(i3.second) - 1;
-			
-			// if we have quad faces, add another triangle
-			if(quad_face) {
-				pair<string, string> i4 = get_face_indices(val4);				
-				(*indices)[cur_subobj].push_back(new s_index());
-				(*indices)[cur_subobj].back()->indices[0] = string2uint(i1.first) - 1;
-				(*indices)[cur_subobj].back()->indices[1] = string2uint(i3.first) - 1;
-				(*indices)[cur_subobj].back()->indices[2] = string2uint(i4.first) - 1;
-				(*tex_indices)[cur_subobj].push_back(new s_index());
-				(*tex_indices)[cur_subobj].back()->indices[0] = string2uint(i1.second) - 1;
-				(*tex_indices)[cur_subobj].back()->indices[1] = string2uint(i3.second) - 1;
-				(*tex_indices)[cur_subobj].back()->indices[2] = string2uint(i4.second) - 1;
-			}
-		}
-		// sub-object
-		else if(cur_word == "g") {
-			if(buffer >> val1 && val1[0] != '#') {
-				if(!collision_obj && val1 == "collision") {
-					a2e_error("old obj-format - no sub-object with the name \"collision\" allowed!");
-					return false;
-				}
-				
-				if(!join_mat_objects) {
-					cur_subobj = obj_names->size();
-					(*obj_names)[cur_subobj] = val1;
-					if(obj_mats != NULL) {
-						(*obj_mats)[cur_subobj] = "";
-					}
-				}
-			}
-		}
+	// one conversion per line: [options] model.obj[.gz] [model.a2m] (the command line options are the defaults)
+	string line;
+	size_t line_number = 0;
+	while(getline(buffer, line)) {
+		line_number++;
+		stringstream line_buffer(line);
+		vector<string> args;
+		string arg;
+		while(line_buffer >> arg) {
+			if(arg[0] == '#') break;
+			args.push_back(arg);
+		}
+		if(args.empty()) continue;
 		
-		// if set_word is set, don't get a new one (a word was already set)
-		if(!set_word) {
-			buffer >> cur_word;
-			is_word = !buffer.fail();
-		}
-		else set_word = false;
+		conversion_options options = defaults;
+		vector<string> filenames;
+		if(!parse_conversion_args(args, options, filenames) || filenames.empty() || filenames.size() > 2) {
+			a2e_error("invalid line #%u in batch list \"%s\"!", line_number, list_filename);
+			return false;
+		}
+		options.obj_filename = filenames[0];
+		options.a2m_filename = (filenames.size() == 2 ? filenames[1] : make_a2m_filename(filenames[0]));
+		batch.push_back(options);
 	}
-	
-	if(tex_coords->empty()) {
-		a2e_error("obj doesn't contain texture coordinates - using dummy coordinates!");
-		tex_coords->push_back(new coord());
-		tex_coords->back()->u = 0.0f;
-		tex_coords->back()->v = 0.0f;
-	}
-	
 	return true;
 }
 
-void create_mat_mapping() {
-	if(!mat_mapping) return;
-	if(mtllib == "") {
-		a2e_error("-mat_mapping specified, but no mtllib is specified inside the .obj file!");
-		return;
-	}
-	
-	stringstream buffer;
-	file_io f;
-	if(!f.file_to_buffer(mtllib.c_str(), buffer)) {
-		a2e_error("-mat_mapping specified, but couldn't open mtllib!");
-		return;
-	}
-	
-	// create mtl_name -> id mapping
-	map<string, size_t> mat_mapping;
-	try {
-		string cur_word, val1;
-		cur_word.reserve(256);
-		val1.reserve(256);
+bool make_batch_from_directory(const string& directory, const conversion_options& defaults, vector<conversion_options>& batch) {
+	string path = directory;
+	if(!path.empty() && path.back() != '/' && path.back() != '\\') path += "/";
+	
+	// all .obj and .obj.gz files in the directory (not recursive)
+	for(const auto& file : core::get_file_list(path)) {
+		const string& name = file.first;
+		if(name.empty() || name[0] == '.') continue;
+		if(!has_suffix(name, ".obj") && !has_suffix(name, ".obj.gz")) continue;
 		
-		buffer >> cur_word;
-		bool is_word = !buffer.fail();
-		bool set_word = false;
-		while(is_word && !buffer.eof()) {
-			// newmtl
-			if(cur_word == "newmtl") {
-				buffer >> val1;
-				size_t id = mat_mapping.size();
-				mat_mapping[val1] = id;
-			}
-			// ignore everything else
-			
-			// if set_word is set, don't get a new one (a word was already set)
-			if(!set_word) {
-				buffer >> cur_word;
-				is_word = !buffer.fail();
-			}
-			else set_word = false;
-		}
+		conversion_options options = defaults;
+		options.obj_filename = path + name;
+		options.a2m_filename = path + make_a2m_filename(name);
+		batch.push_back(options);
 	}
-	catch(...) {
-		a2e_error("error while reading mtl file!");
-		return;
-	}
-	
-	// create and write mapping
-	string mapping_fname = string(a2m_filename) + ".mapping.txt";
-	if(!f.open(mapping_fname.c_str(), file_io::OPEN_TYPE::WRITE)) {
-		return;
-	}
-	
-	fstream& file = *f.get_filestream();
-	file << "\t<material_mapping>" << endl;
-	for(map<unsigned int, string>::const_iterator mat_iter = model_mat_names.begin(); mat_iter != model_mat_names.end(); mat_iter++) {
-		if(mat_mapping.count(mat_iter->second) == 0) {
-			a2e_error("material %s doesn't exist in .mtl file!", mat_iter->second);
-			file << "\t\t<object material_id=\"0\" />" << endl;
-			continue;
-		}
-		file << "\t\t<object material_id=\"" << mat_mapping[mat_iter->second] << "\" />" << endl;
+	if(batch.empty()) {
+		a2e_error("no .obj files found in \"%s\"!", directory);
+		return false;
 	}
-	file << "\t</material_mapping>" << endl;
-	
-	f.close();
+	return true;
 }
 
-struct s_cmp_coord {
-	bool operator() (coord* c1, coord* c2) const {
-		if(c1->u < c2->u) return true;
-		else if(c1->u > c2->u) return false;
-		else { // ==
-			if(c1->v < c2->v) return true;
-			else if(c1->v > c2->v) return false;
-			else return false;
-		}
-	}
-} cmp_coord;
-
-bool equal_vertex(const float3* v1, const float3* v2) {
-	const static float epsilon = 0.001f;
-	if(((v1->x - epsilon) < v2->x) && (v2->x < (v1->x + epsilon))) {
-		if(((v1->y - epsilon) < v2->y) && (v2->y < (v1->y + epsilon))) {
-			if(((v1->z - epsilon) < v2->z) && (v2->z < (v1->z + epsilon))) {
-				return true;
-			}
-			else return false;
+// converts all files of the batch on job_count tasks and prints a summary, returns false if any conversion failed
+bool run_batch(const vector<conversion_options>& batch, const unsigned int job_count) {
+	a2e_log("converting %u files (%u jobs, %u threads per job) ...", batch.size(), job_count, (batch.empty() ? 0 : batch[0].thread_count));
+	const auto batch_start_time = chrono::high_resolution_clock::now();
+	vector<conversion_result> results(batch.size());
+	parallel_for(batch.size(), job_count, [&batch, &results](const size_t i) {
+		obj2a2m_conversion conversion(batch[i]);
+		if(!conversion.convert()) {
+			a2e_error("failed to convert \"%s\"!", batch[i].obj_filename);
+		}
+		results[i] = conversion.get_result();
+	});
+	const double batch_time = chrono::duration<double>(chrono::high_resolution_clock::now() - batch_start_time).count();
+	
+	// summary table
+	size_t failed_count = 0, skipped_count = 0;
+	stringstream table;
+	table << fixed << setprecision(3) << endl;
+	table << left << setw(40) << "file" << " " << setw(7) << "status" << right << setw(10) << "time (s)" << setw(12) << "triangles"
+		  << setw(12) << "obj verts" << setw(12) << "a2m verts" << setw(10) << "reduced" << setw(12) << "obj coords" << setw(12) << "a2m coords" << endl;
+	for(size_t i = 0; i < batch.size(); i++) {
+		const conversion_result& result = results[i];
+		table << left << setw(40) << batch[i].obj_filename << " " << setw(7) << (!result.success ? "FAILED" : (result.skipped ? "skipped" : "ok")) << right;
+		if(!result.success || result.skipped) {
+			if(!result.success) failed_count++;
+			else skipped_count++;
+			table << endl;
+			continue;
 		}
-		else return false;
+		const double reduction = (result.obj_vertex_count > 0 ?
+								  100.0 - (double)result.vertex_count * 100.0 / (double)result.obj_vertex_count : 0.0);
+		table << setw(10) << result.time << setw(12) << result.triangle_count << setw(12) << result.obj_vertex_count
+			  << setw(12) << result.vertex_count << setprecision(1) << setw(9) << reduction << "%" << setprecision(3) << setw(12) << result.obj_coord_count
+			  << setw(12) << result.coord_count << endl;
 	}
-	return false;
+	a2e_log("%s", table.str());
+	a2e_log("converted %u of %u files in %fs (%u up-to-date, %u failed)", batch.size() - failed_count - skipped_count, batch.size(), batch_time,
+			skipped_count, failed_count);
+	return (failed_count == 0);
 }
 
-bool equal_coord(coord* c1, coord* c2) {
-	const static float epsilon = 0.000001f;
-	if(((c1->u - epsilon) < c2->u) && (c2->u < (c1->u + epsilon))) {
-		if(((c1->v - epsilon) < c2->v) && (c2->v < (c1->v + epsilon))) {
-			return true;
-		}
-		else return false;
-	}
-	return false;
-}
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 int main(int argc, char *argv[]) {
 	logger::init();
@@ -377,11 +294,10 @@ int main(int argc, char *argv[]) {
 	gettimeofday(&start_time, NULL);
 #endif
 	
-	file_io f;
-	
 	a2e_log("obj2a2m v%u.%u.%u - %s %s", OBJ2A2M_MAJOR_VERSION, OBJ2A2M_MINOR_VERSION, OBJ2A2M_REVISION_VERSION, OBJ2A2M_BUILT_DATE, OBJ2A2M_BUILT_TIME);
 	
-	string usage = "usage: obj2a2m [-rotate | -rotate_model | -rotate_collision] [-collision collision.obj] [-to_obj] [-join_mat_objects] [-mat_mapping] model.obj model.a2m";
+	string usage = "usage: obj2a2m [-rotate | -rotate_model | -rotate_collision] [-collision collision.obj[.gz]] [-collision_bvh] [-to_obj] [-join_mat_objects] [-mat_mapping] [-mmap] [-threads count] [-write_mode buffered|writev|mmap] [-a2m_v3] [-compact] [-interleaved] [-normals] [-tangents] [-compress] [-optimize_cache] [-meshlets] [-lod ratio,ratio,...] [-out_of_core] [-memory_budget MB] [-incremental] [-force] [-stats | --stats=text|json] [-verify] model.obj[.gz] model.a2m\n"
+	"       obj2a2m [options] [-jobs count] -batch list.txt | -batch_dir directory";
 	if(argc == 1) {
 		a2e_error("no .obj and .a2m file specified!\n%s", usage.c_str());
 		return 0;
@@ -391,355 +307,56 @@ int main(int argc, char *argv[]) {
 		return 0;
 	}
 	
-	unsigned int used_args = 0;
-	for(int i = 0; i < argc; i++) {
-		if(strcmp(argv[i], "-rotate") == 0) {
-			rotate_obj = true;
-			rotate_model = true;
-			rotate_collision = true;
-			used_args++;
-		}
-		else if(strcmp(argv[i], "-rotate_model") == 0) {
-			rotate_model = true;
-			used_args++;
-		}
-		else if(strcmp(argv[i], "-rotate_collision") == 0) {
-			rotate_collision = true;
-			used_args++;
-		}
-		else if(strcmp(argv[i], "-to_obj") == 0) {
-			to_obj = true;
-			used_args++;
-		}
-		else if(strcmp(argv[i], "-collision") == 0) {
-			used_args++;
-			i++;
-			if(i < argc) {
-				collision_filename = argv[i];
-				collision_object = true;
-				used_args++;
-			}
-		}
-		else if(strcmp(argv[i], "-join_mat_objects") == 0) {
-			join_mat_objects = true;
-			used_args++;
-		}
-		else if(strcmp(argv[i], "-mat_mapping") == 0) {
-			mat_mapping = true;
-			used_args++;
-		}
-	}
-
-	if(used_args + 3 > (unsigned int)argc) {
-		a2e_error("too few arguments!\n%s", usage.c_str());
-		return -1;
+	// batch arguments
+	string batch_list = "", batch_dir = "";
+	unsigned int job_count = 0;
+	vector<string> args;
+	for(int i = 1; i < argc; i++) {
+		if(strcmp(argv[i], "-batch") == 0 && i + 1 < argc) batch_list = argv[++i];
+		else if(strcmp(argv[i], "-batch_dir") == 0 && i + 1 < argc) batch_dir = argv[++i];
+		else if(strcmp(argv[i], "-jobs") == 0 && i + 1 < argc) job_count = std::max(string2uint(argv[++i]), 1u);
+		else args.push_back(argv[i]);
 	}
+	const bool batch_mode = (batch_list != "" || batch_dir != "");
 	
-	obj_filename = argv[argc-2];
-	a2m_filename = argv[argc-1];
-
-	a2e_debug("converting \"%s\" to \"%s\" ...", obj_filename, a2m_filename);
+	// in batch mode, the threads are split between the concurrent conversions by default (-threads overrides this)
+	conversion_options options;
+	if(batch_mode) {
+		if(job_count == 0) job_count = default_thread_count();
+		options.thread_count = std::max(default_thread_count() / job_count, 1u);
+	}
 	
-	// read and store obj data
-	a2e_debug("loading obj ...");
-	if(!load_obj_data(false, obj_filename, &model_vertices, &model_tex_coords, &model_indices, &model_tex_indices, &model_obj_names, &model_mat_names)) {
+	vector<string> filenames;
+	if(!parse_conversion_args(args, options, filenames)) {
+		a2e_error("%s", usage.c_str());
 		return -1;
 	}
 	
-	if(collision_object) {
-		a2e_debug("loading collision obj ...");
-		if(!load_obj_data(true, collision_filename, &collision_vertices, &collision_tex_coords, &collision_indices, &collision_tex_indices, &collision_obj_names, NULL)) {
+	bool success = false;
+	if(batch_mode) {
+		vector<conversion_options> batch;
+		if(!filenames.empty()) {
+			a2e_error("no .obj/.a2m files may be specified in batch mode!\n%s", usage.c_str());
 			return -1;
 		}
-		
-		if(collision_obj_names.size() > 1) {
-			a2e_error("collision model contains too many sub-objects - only one sub-object allowed!");
-			return -1;
-		}
-		else if(collision_obj_names.size() == 0) {
-			a2e_error("collision model has no object data!");
-			return -1;
-		}
-	}
-	
-	// reduce data
-	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	// load data
-	a2e_debug("reducing data ...");
-	object_count = model_obj_names.size();
-	sub_objects = new sub_object[object_count];
-	multimap<unsigned int, pair<float3*, coord*>> data_map;
-	bool coord_found = false;
-	float3* cur_vertex;
-	for(unsigned int i = 0; i < object_count; i++) {
-		data_map.clear();
-		for(unsigned int j = 0; j < model_indices[i].size(); j++) {
-			sub_objects[i].faces.push_back(new face());
-			
-			// first index
-			for(unsigned int k = 0; k < 3; k++) {
-				if(data_map.count(model_indices[i][j]->indices[k]) == 0) {
-					// add vertex and texture coordinate to container
-					sub_objects[i].vertices.push_back(new float3(model_vertices[model_indices[i][j]->indices[k]]));
-					sub_objects[i].faces.back()->vertices[k] = sub_objects[i].vertices.back();
-					sub_objects[i].coords.push_back(new coord());
-					*sub_objects[i].coords.back() = *model_tex_coords[model_tex_indices[i][j]->indices[k]];
-					sub_objects[i].faces.back()->coords[k] = sub_objects[i].coords.back();
-					data_map.insert(pair<unsigned int, pair<float3*, coord*>>(model_indices[i][j]->indices[k], pair<float3*, coord*>(sub_objects[i].vertices.back(), sub_objects[i].coords.back())));
-				}
-				else {
-					// vertex already exists, only add texture coordinate (if it doesn't exist already)
-					cur_vertex = data_map.equal_range(model_indices[i][j]->indices[k]).first->second.first; // sick, but working ...
-					sub_objects[i].faces.back()->vertices[k] = cur_vertex;
-					coord_found = false;
-					for(multimap<unsigned int, pair<float3*, coord*>>::iterator diter = data_map.equal_range(model_indices[i][j]->indices[k]).first;
-						diter != data_map.equal_range(model_indices[i][j]->indices[k]).second; diter++) {
-						if(equal_coord(diter->second.second, model_tex_coords[model_tex_indices[i][j]->indices[k]])) {
-							coord_found = true;
-							sub_objects[i].faces.back()->coords[k] = diter->second.second;
-						}
-					}
-					// if coord doesn't exist already, add new one
-					if(!coord_found) {
-						sub_objects[i].coords.push_back(new coord());
-						*sub_objects[i].coords.back() = *model_tex_coords[model_tex_indices[i][j]->indices[k]];
-						sub_objects[i].faces.back()->coords[k] = sub_objects[i].coords.back();
-						data_map.insert(pair<unsigned int, pair<float3*, coord*>>(model_indices[i][j]->indices[k], pair<float3*, coord*>(cur_vertex, sub_objects[i].coords.back())));
-					}
-				}
-			}
-		}
-	}
-	
-	// sort vertices in each sub-object
-	a2e_debug("sorting vertices ...");
-	for(unsigned int i = 0; i < object_count; i++) {
-		sort(sub_objects[i].vertices.begin(), sub_objects[i].vertices.end(), cmp_vertex);
-	}
-	
-	// look for equal vertices and remove duplicates
-	a2e_debug("removing duplicate vertices ...");
-	float3* equal_vert;
-	float3* cur_vert;
-	unordered_map<float3*, float3*> replace_vertices;
-	for(unsigned int i = 0; i < object_count; i++) {
-		unsigned int j = 0;
-		unsigned int vertices_size = sub_objects[i].vertices.size() - 1; // -1, b/c a vertex is always compared with the next one (-> not needed by the last)
-		while(j < vertices_size) {
-			// if the current and next vertex are equal ...
-			if(equal_vertex(sub_objects[i].vertices[j], sub_objects[i].vertices[j+1])) {
-				cur_vert = sub_objects[i].vertices[j];
-				equal_vert = sub_objects[i].vertices[j+1];
-				replace_vertices[equal_vert] = cur_vert;
-				
-				// delete next vertex
-				sub_objects[i].vertices.erase(sub_objects[i].vertices.begin() + j + 1);
-				vertices_size--; // size was decreased by one ...
-				
-				// don't increase j here, b/c the next vertex might be the same again ...
-			}
-			else j++;
-		}
-		
-		// replace vertex pointers
-		a2e_debug("in sub-object #%u ...", i);
-		unsigned int fcnt = 0;
-		for(vector<face*>::iterator fiter = sub_objects[i].faces.begin(); fiter != sub_objects[i].faces.end(); fiter++) {
-			for(unordered_map<float3*, float3*>::const_iterator rv_iter = replace_vertices.cbegin(); rv_iter != replace_vertices.cend(); rv_iter++) {
-				if((*fiter)->vertices[0] == rv_iter->first) (*fiter)->vertices[0] = rv_iter->second;
-				if((*fiter)->vertices[1] == rv_iter->first) (*fiter)->vertices[1] = rv_iter->second;
-				if((*fiter)->vertices[2] == rv_iter->first) (*fiter)->vertices[2] = rv_iter->second;
-			}
-			fcnt++;
-			
-			if((fcnt % 10000) == 0) cout << (fcnt / 10000) << "0k ";
-		}
-		if(fcnt > 10000) cout << endl;
-	}
-	
-	// make indices
-	a2e_debug("creating new indices ...");
-	map<float3*, unsigned int> vertex_indices;
-	map<coord*, unsigned int> tex_indices;
-	unsigned int v_index = 0;
-	unsigned int tc_index = 0;
-	for(unsigned int i = 0; i < object_count; i++) {
-		for(unsigned int j = 0; j < sub_objects[i].vertices.size(); j++) {
-			vertex_indices[sub_objects[i].vertices[j]] = v_index;
-			v_index++;
-		}
-		for(unsigned int j = 0; j < sub_objects[i].coords.size(); j++) {
-			tex_indices[sub_objects[i].coords[j]] = tc_index;
-			tc_index++;
-		}
-	}
-	
-	for(unsigned int i = 0; i < object_count; i++) {
-		for(vector<face*>::iterator fiter = sub_objects[i].faces.begin(); fiter != sub_objects[i].faces.end(); fiter++) {
-			(*fiter)->vertex_indices.indices[0] = vertex_indices[(*fiter)->vertices[0]];
-			(*fiter)->vertex_indices.indices[1] = vertex_indices[(*fiter)->vertices[1]];
-			(*fiter)->vertex_indices.indices[2] = vertex_indices[(*fiter)->vertices[2]];
-			(*fiter)->tex_indices.indices[0] = tex_indices[(*fiter)->coords[0]];
-			(*fiter)->tex_indices.indices[1] = tex_indices[(*fiter)->coords[1]];
-			(*fiter)->tex_indices.indices[2] = tex_indices[(*fiter)->coords[2]];
-		}
-	}
-	
-	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	
-	// debug output to new .obj
-	if(to_obj) {
-		string debug_obj = string(a2m_filename).substr(0, strlen(a2m_filename)-3) + "obj";
-		a2e_debug("saving to %s ...", debug_obj.c_str());
-		
-		if(!f.open(debug_obj.c_str(), file_io::OPEN_TYPE::WRITE_BINARY)) {
-			a2e_error("couldn't open/write obj file \"%s\"!", debug_obj.c_str());
+		if((batch_list != "" && !make_batch_from_list(batch_list, options, batch)) ||
+		   (batch_dir != "" && !make_batch_from_directory(batch_dir, options, batch))) {
 			return -1;
 		}
-		
-		fstream* fs = f.get_filestream();
-		
-		for(unsigned int i = 0; i < object_count; i++) {
-			*fs << "# vc " << i << ": " << sub_objects[i].vertices.size() << endl;
-			*fs << "# tc " << i << ": " << sub_objects[i].coords.size() << endl;
-			*fs << "# fc " << i << ": " << sub_objects[i].faces.size() << endl;
-		}
-		
-		for(unsigned int i = 0; i < object_count; i++) {
-			for(unsigned int j = 0; j < sub_objects[i].vertices.size(); j++) {
-				if(!rotate_model) {
-					*fs << "v " << sub_objects[i].vertices[j]->x << " " << sub_objects[i].vertices[j]->y << " " << sub_objects[i].vertices[j]->z << endl;
-				}
-				else {
-					*fs << "v " << sub_objects[i].vertices[j]->x << " " << sub_objects[i].vertices[j]->z << " " << -sub_objects[i].vertices[j]->y << endl;
-				}
-			}
-		}
-		for(unsigned int i = 0; i < object_count; i++) {
-			for(unsigned int j = 0; j < sub_objects[i].coords.size(); j++) {
-				*fs << "vt " << sub_objects[i].coords[j]->u << " " << sub_objects[i].coords[j]->v << endl;
-			}
-		}
-		
-		for(unsigned int i = 0; i < object_count; i++) {
-			*fs << "g " << model_obj_names[i] << endl;
-			*fs << "usemtl " << model_mat_names[i] << endl;
-			
-			for(vector<face*>::iterator fiter = sub_objects[i].faces.begin(); fiter != sub_objects[i].faces.end(); fiter++) {
-				*fs << "f " << ((*fiter)->vertex_indices.indices[0]+1) << "/" << ((*fiter)->tex_indices.indices[0]+1) << " " << ((*fiter)->vertex_indices.indices[1]+1) << "/" << ((*fiter)->tex_indices.indices[1]+1)
-				<< " " << ((*fiter)->vertex_indices.indices[2]+1) << "/" << ((*fiter)->tex_indices.indices[2]+1) << endl;
-			}
-			*fs << endl;
-		}
-		*fs << endl;
-		
-		f.close();
+		success = run_batch(batch, job_count);
 	}
-	
-	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	
-	unsigned int total_vertex_count = 0;
-	unsigned int total_coord_count = 0;
-	for(unsigned int i = 0; i < object_count; i++) {
-		total_vertex_count += sub_objects[i].vertices.size();
-		total_coord_count += sub_objects[i].coords.size();
-	}
-	
-	// convert obj data to a2m, save a2m
-	if(!to_obj) {
-		a2e_debug("saving a2m ...");
-		if(!f.open(a2m_filename, file_io::OPEN_TYPE::WRITE_BINARY)) {
-			a2e_error("couldn't open/write a2m file \"%s\"!", a2m_filename);
+	else {
+		if(filenames.size() < 2) {
+			a2e_error("too few arguments!\n%s", usage.c_str());
 			return -1;
 		}
+		options.obj_filename = filenames[filenames.size() - 2];
+		options.a2m_filename = filenames[filenames.size() - 1];
 		
-		f.write_block("A2EMODEL", 8);
-		f.write_uint(A2M_VERSION);
-		f.write_char(collision_object ? 0x02 : 0x00);
-		
-		f.write_uint(total_vertex_count);
-		f.write_uint(total_coord_count);
-		
-		for(unsigned int i = 0; i < object_count; i++) {
-			for(unsigned int j = 0; j < sub_objects[i].vertices.size(); j++) {
-				if(!rotate_model) {
-					f.write_float(sub_objects[i].vertices[j]->x);
-					f.write_float(sub_objects[i].vertices[j]->y);
-					f.write_float(sub_objects[i].vertices[j]->z);
-				}
-				else {
-					f.write_float(sub_objects[i].vertices[j]->x);
-					f.write_float(sub_objects[i].vertices[j]->z);
-					f.write_float(-sub_objects[i].vertices[j]->y);
-				}
-			}
-		}
-		for(unsigned int i = 0; i < object_count; i++) {
-			for(unsigned int j = 0; j < sub_objects[i].coords.size(); j++) {
-				f.write_float(sub_objects[i].coords[j]->u);
-				f.write_float(sub_objects[i].coords[j]->v);
-			}
-		}
-		
-		f.write_uint(object_count);
-		for(map<unsigned int, string>::iterator oiter = model_obj_names.begin(); oiter != model_obj_names.end(); oiter++) {
-			f.write_terminated_block(oiter->second, 0xFF);
-		}
-		
-		for(unsigned int i = 0; i < object_count; i++) {
-			f.write_uint(sub_objects[i].faces.size());
-			for(vector<face*>::iterator fiter = sub_objects[i].faces.begin(); fiter != sub_objects[i].faces.end(); fiter++) {
-				f.write_uint((*fiter)->vertex_indices.indices[0]);
-				f.write_uint((*fiter)->vertex_indices.indices[1]);
-				f.write_uint((*fiter)->vertex_indices.indices[2]);
-			}
-			for(vector<face*>::iterator fiter = sub_objects[i].faces.begin(); fiter != sub_objects[i].faces.end(); fiter++) {
-				f.write_uint((*fiter)->tex_indices.indices[0]);
-				f.write_uint((*fiter)->tex_indices.indices[1]);
-				f.write_uint((*fiter)->tex_indices.indices[2]);
-			}
-		}
-		
-		if(collision_object) {
-			f.write_uint(collision_vertices.size());
-			for(vector<float3*>::iterator viter = collision_vertices.begin(); viter != collision_vertices.end(); viter++) {
-				if(!rotate_collision) {
-					f.write_float((*viter)->x);
-					f.write_float((*viter)->y);
-					f.write_float((*viter)->z);
-				}
-				else {
-					f.write_float((*viter)->x);
-					f.write_float((*viter)->z);
-					f.write_float(-(*viter)->y);
-				}
-			}
-			
-			f.write_uint(collision_indices[0].size());
-			for(vector<s_index*>::iterator iiter = model_indices[0].begin(); iiter != model_indices[0].end(); iiter++) {
-				f.write_uint((*iiter)->indices[0]);
-				f.write_uint((*iiter)->indices[1]);
-				f.write_uint((*iiter)->indices[2]);
-			}
-		}
-		
-		f.close();
+		obj2a2m_conversion conversion(options);
+		success = conversion.convert();
 	}
 	
-	//
-	create_mat_mapping();
-
-	// done!
-	int reduced_vertices = model_vertices.size() - total_vertex_count;
-	int reduced_tex_coords = model_tex_coords.size() - total_coord_count;
-	if(reduced_vertices > 0) a2e_debug("reduced model by %u vertices!", reduced_vertices);
-	if(reduced_tex_coords > 0) a2e_debug("reduced model by %u texture coordinates!", reduced_tex_coords);
-	a2e_debug("successfully converted \"%s\" to \"%s\" (%u sub-object%s, %u vertices, %u texture coordinates)!",
-			 obj_filename, a2m_filename, model_obj_names.size(), (model_obj_names.size() == 1 ? "" : "s"), total_vertex_count, total_coord_count);
-
 #ifdef WIN32
 	stop_time = GetTickCount();
 	a2e_debug("time needed: %ds / %ums", (stop_time - start_time)/1000, stop_time - start_time);
@@ -750,5 +367,5 @@ int main(int argc, char *argv[]) {
 
 	logger::destroy();
 
-	return 0;
+	return (success ? 0 : -1);
 }
@@ -0,0 +1,1960 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2010 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "obj2a2m_conversion.h"
+
+pair<string, string> get_face_indices(string face_str) {
+	string vertex_index, coord_index;
+	size_t first_slash, last_slash;
+	// check if face string contains a '/', if not, only a vertex index is specified
+	if((first_slash = face_str.find("/")) != string::npos) {
+		vertex_index = face_str.substr(0, first_slash);
+		
+		// check for second '/', this happens if there is also a normal index specified
+		last_slash = face_str.find_last_of("/");
+		if(first_slash == last_slash-1) {
+			coord_index = "1";
+		}
+		else if(first_slash != last_slash) {
+			coord_index = face_str.substr(first_slash+1, last_slash - first_slash - 1);
+		}
+		else {
+			coord_index = face_str.substr(first_slash+1, face_str.length() - first_slash);
+		}
+	}
+	else {
+		vertex_index = face_str;
+		coord_index = "1";
+		a2e_error("face contains no texture coordinate index - using \"1\"!");
+	}
+	
+	return pair<string, string>(vertex_index, coord_index);
+}
+
+inline bool is_number(string str) {
+	if(!(str[0] >= '0' && str[0] <= '9') && str[0] != '-') return false;
+	return true;
+}
+
+bool obj2a2m_conversion::load_obj_data(bool collision_obj, const char* filename, obj_model& model) {
+	// compressed .obj files are always streamed, normals are only loaded by the mapped and compressed loaders
+	const bool load_normals = (normals && !collision_obj);
+	if(gz_line_stream::is_compressed(filename)) {
+		return load_obj_data_gz(collision_obj, join_mat_objects, load_normals, thread_count, filename, mtllib, model, &stats);
+	}
+	if(mapped_obj || load_normals) {
+		return load_obj_data_mapped(collision_obj, join_mat_objects, load_normals, thread_count, filename, mtllib, model, &stats);
+	}
+	
+	int cur_subobj = -1;
+	bool uvw_texcoord = true;
+	bool quad_face = false;
+	bool init_uvw_check = false;
+	bool set_word = false;
+	
+	// read and store obj data
+	phase_timer read_timer(&stats, CONVERSION_PHASE::READ);
+	file_io f(filename, file_io::OPEN_TYPE::READ_BINARY);
+	if(!f.is_open()) {
+		a2e_error("couldn't open obj file \"%s\"!", filename);
+		return false;
+	}
+	
+	stringstream buffer(stringstream::in | stringstream::out);
+	core::reset(buffer);
+	f.read_file(&buffer);
+	f.close();
+	
+	buffer.seekp(0);
+	buffer.seekg(0);
+	read_timer.stop();
+	phase_timer parse_timer(&stats, CONVERSION_PHASE::PARSE);
+	
+	string cur_word, val1, val2, val3, val4;
+	cur_word.reserve(256);
+	val1.reserve(256);
+	val2.reserve(256);
+	val3.reserve(256);
+	val4.reserve(256);
+	
+	map<string, size_t> object_mats;
+	
+	// all data in file order, this is copied into the model arrays at the end
+	vector<float3> vertices;
+	vector<coord> tex_coords;
+	vector<s_index> indices, tex_indices;
+	vector<unsigned int> triangle_objects; // sub-object of each triangle
+	vector<size_t> object_triangle_counts;
+	size_t token_count = 0, face_count = 0, quad_count = 0;
+	
+	buffer >> cur_word;
+	bool is_word = !buffer.fail();
+	while(is_word && !buffer.eof()) {
+		token_count++;
+		
+		// vertex
+		if(cur_word == "v") {
+			buffer >> val1;
+			buffer >> val2;
+			buffer >> val3;
+			token_count += 3;
+			
+			vertices.emplace_back(string2float(val1), string2float(val2), string2float(val3));
+		}
+		// texture coordinate
+		else if(cur_word == "vt") {
+			buffer >> val1;
+			buffer >> val2;
+			token_count += 2;
+			
+			// some .obj files use uvw texture coordinates instead of uv coordinates, do a check at the first occurrence of vt
+			if(!init_uvw_check) {
+				string next_val = buffer.str().substr(1 + buffer.tellg(), 4);
+				if(!is_number(next_val)) {
+					uvw_texcoord = false;
+				}
+				init_uvw_check = true;
+			}
+			
+			if(uvw_texcoord) {
+				buffer >> val3; // ignored
+				token_count++;
+			}
+			
+			tex_coords.emplace_back();
+			tex_coords.back().u = string2float(val1);
+			tex_coords.back().v = string2float(val2);
+		}
+		// normal - ignore
+		else if(cur_word == "vn") {
+		}
+		// smooth group - ignore
+		else if(cur_word == "s") {
+		}
+		// usemtl
+		else if(cur_word == "usemtl") {
+			token_count++;
+			if(join_mat_objects) {
+				buffer >> val1;
+				if(object_mats.count(val1) == 0) {
+					cur_subobj = model.obj_names.size();
+					object_mats[val1] = cur_subobj;
+					model.obj_names[cur_subobj] = val1;
+					model.obj_mats[cur_subobj] = val1;
+					object_triangle_counts.push_back(0);
+				}
+				else {
+					// if join_mat_objects is specified, reuse to sub-object id, thus merging all data for one material
+					cur_subobj = object_mats[val1];
+				}
+			}
+			else {
+				buffer >> val1;
+				if(cur_subobj >= 0) {
+					model.obj_mats[cur_subobj] = val1;
+				}
+			}
+		}
+		// mtllib
+		else if(cur_word == "mtllib") {
+			buffer >> val1;
+			mtllib = val1;
+			token_count++;
+		}
+		// face / triangle
+		else if(cur_word == "f") {
+			if(cur_subobj < 0) {
+				a2e_error("invalid obj-format - no sub-object specified!");
+				return false;
+			}
+			
+			buffer >> val1;
+			buffer >> val2;
+			buffer >> val3;
+			buffer >> val4;
+			quad_face = true;
+			face_count++;
+			
+			// since the .obj format allows mixed triangle and quad faces, we have to check this each time ...
+			// (a non-index val4 is the next keyword and is counted as a token once it is handled)
+			if(!is_number(val4)) {
+				cur_word = val4;
+				quad_face = false;
+				set_word = true;
+				token_count += 3;
+			}
+			else {
+				quad_count++;
+				token_count += 4;
+			}
+			
+			pair<string, string> i1 = get_face_indices(val1);
+			pair<string, string> i2 = get_face_indices(val2);
+			pair<string, string> i3 = get_face_indices(val3);
+			
+			indices.push_back(s_index {{ string2uint(i1.first) - 1, string2uint(i2.first) - 1, string2uint(i3.first) - 1 }});
+			tex_indices.push_back(s_index {{ string2uint(i1.second) - 1, string2uint(i2.second) - 1, string2uint(i3.second) - 1 }});
+			triangle_objects.push_back(cur_subobj);
+			object_triangle_counts[cur_subobj]++;
+			
+			// if we have quad faces, add another triangle
+			if(quad_face) {
+				pair<string, string> i4 = get_face_indices(val4);
+				indices.push_back(s_index {{ string2uint(i1.first) - 1, string2uint(i3.first) - 1, string2uint(i4.first) - 1 }});
+				tex_indices.push_back(s_index {{ string2uint(i1.second) - 1, string2uint(i3.second) - 1, string2uint(i4.second) - 1 }});
+				triangle_objects.push_back(cur_subobj);
+				object_triangle_counts[cur_subobj]++;
+			}
+		}
+		// sub-object
+		else if(cur_word == "g") {
+			if(buffer >> val1 && val1[0] != '#') {
+				token_count++;
+				if(!collision_obj && val1 == "collision") {
+					a2e_error("old obj-format - no sub-object with the name \"collision\" allowed!");
+					return false;
+				}
+				
+				if(!join_mat_objects) {
+					cur_subobj = model.obj_names.size();
+					model.obj_names[cur_subobj] = val1;
+					model.obj_mats[cur_subobj] = "";
+					object_triangle_counts.push_back(0);
+				}
+			}
+		}
+		
+		// if set_word is set, don't get a new one (a word was already set)
+		if(!set_word) {
+			buffer >> cur_word;
+			is_word = !buffer.fail();
+		}
+		else set_word = false;
+	}
+	
+	stats.token_count += token_count;
+	stats.face_count += face_count;
+	stats.quad_count += quad_count;
+	
+	if(tex_coords.empty()) {
+		a2e_error("obj doesn't contain texture coordinates - using dummy coordinates!");
+		tex_coords.emplace_back();
+		tex_coords.back().u = 0.0f;
+		tex_coords.back().v = 0.0f;
+	}
+	
+	// copy everything into the model arrays, sorting the triangles by sub-object (keeping the file order inside each sub-object)
+	model.vertices = arena_array<float3>(model.arena, vertices.size());
+	copy(vertices.cbegin(), vertices.cend(), model.vertices.begin());
+	model.tex_coords = arena_array<coord>(model.arena, tex_coords.size());
+	copy(tex_coords.cbegin(), tex_coords.cend(), model.tex_coords.begin());
+	
+	model.alloc_triangles(object_triangle_counts);
+	vector<size_t> object_positions(model.object_offsets.cbegin(), model.object_offsets.cend() - 1);
+	for(size_t i = 0; i < indices.size(); i++) {
+		const size_t position = object_positions[triangle_objects[i]]++;
+		model.indices[position] = indices[i];
+		model.tex_indices[position] = tex_indices[i];
+	}
+	
+	return true;
+}
+
+void obj2a2m_conversion::create_mat_mapping() {
+	if(!mat_mapping) return;
+	if(mtllib == "") {
+		a2e_error("-mat_mapping specified, but no mtllib is specified inside the .obj file!");
+		return;
+	}
+	
+	stringstream buffer;
+	file_io f;
+	if(!f.file_to_buffer(mtllib.c_str(), buffer)) {
+		a2e_error("-mat_mapping specified, but couldn't open mtllib!");
+		return;
+	}
+	
+	// create mtl_name -> id mapping
+	map<string, size_t> mat_mapping;
+	try {
+		string cur_word, val1;
+		cur_word.reserve(256);
+		val1.reserve(256);
+		
+		buffer >> cur_word;
+		bool is_word = !buffer.fail();
+		bool set_word = false;
+		while(is_word && !buffer.eof()) {
+			// newmtl
+			if(cur_word == "newmtl") {
+				buffer >> val1;
+				size_t id = mat_mapping.size();
+				mat_mapping[val1] = id;
+			}
+			// ignore everything else
+			
+			// if set_word is set, don't get a new one (a word was already set)
+			if(!set_word) {
+				buffer >> cur_word;
+				is_word = !buffer.fail();
+			}
+			else set_word = false;
+		}
+	}
+	catch(...) {
+		a2e_error("error while reading mtl file!");
+		return;
+	}
+	
+	// create and write mapping
+	string mapping_fname = string(a2m_filename) + ".mapping.txt";
+	if(!f.open(mapping_fname.c_str(), file_io::OPEN_TYPE::WRITE)) {
+		return;
+	}
+	
+	fstream& file = *f.get_filestream();
+	file << "\t<material_mapping>" << endl;
+	for(map<unsigned int, string>::const_iterator mat_iter = model.obj_mats.begin(); mat_iter != model.obj_mats.end(); mat_iter++) {
+		if(mat_mapping.count(mat_iter->second) == 0) {
+			a2e_error("material %s doesn't exist in .mtl file!", mat_iter->second);
+			file << "\t\t<object material_id=\"0\" />" << endl;
+			continue;
+		}
+		file << "\t\t<object material_id=\"" << mat_mapping[mat_iter->second] << "\" />" << endl;
+	}
+	file << "\t</material_mapping>" << endl;
+	
+	f.close();
+}
+
+struct s_cmp_vertex {
+	bool operator() (const float3& v1, const float3& v2) const {
+		if(v1.x < v2.x) return true;
+		else if(v1.x > v2.x) return false;
+		else { // ==
+			if(v1.y < v2.y) return true;
+			else if(v1.y > v2.y) return false;
+			else { // ==
+				if(v1.z < v2.z) return true;
+				else if(v1.z > v2.z) return false;
+				else return false;
+			}
+		}
+	}
+} cmp_vertex;
+
+struct s_cmp_coord {
+	bool operator() (coord* c1, coord* c2) const {
+		if(c1->u < c2->u) return true;
+		else if(c1->u > c2->u) return false;
+		else { // ==
+			if(c1->v < c2->v) return true;
+			else if(c1->v > c2->v) return false;
+			else return false;
+		}
+	}
+} cmp_coord;
+
+// reduces the data of sub-object #object: removes duplicate vertices and texture coordinates, sorts the vertices
+// and creates the (sub-object local) indices
+size_t obj2a2m_conversion::reduce_sub_object(const unsigned int object, reduce_scratch& scratch) {
+	return reduce_triangles(object, model.get_indices(object), model.get_tex_indices(object), model.get_triangle_count(object),
+							model.vertices.begin(), model.tex_coords.begin(), sub_objects[object], sub_object_arena, scratch,
+							model.get_normal_indices(object), model.get_smoothing_groups(object));
+}
+
+// -normals: computes the normal of every triangle corner of the (welded) sub_obj and folds it into the texture coordinate
+// of the corner: scratch.coords are split where the normals of their corners differ and sub_obj.normals is allocated
+// in parallel to them, so that every following triangle reorder keeps the normals
+void obj2a2m_conversion::add_sub_object_normals(const s_index* normal_indices, const unsigned int* smoothing_groups, sub_object& sub_obj,
+												mesh_arena& arena, reduce_scratch& scratch) {
+	phase_timer normal_timer(&stats, CONVERSION_PHASE::NORMALS);
+	const size_t triangle_count = sub_obj.vertex_indices.size();
+	compute_corner_normals(sub_obj.vertices.begin(), sub_obj.vertices.size(), sub_obj.vertex_indices.begin(), triangle_count,
+						   model.normals.begin(), model.normals.size(), normal_indices, smoothing_groups, scratch.corner_normals);
+	
+	// unique (texture coordinate, normal) pairs, the pairs of each coordinate are linked in the order of their first use
+	scratch.coord_links.assign(scratch.coords.size(), ~0u);
+	scratch.normal_coords.clear();
+	scratch.coord_normals.clear();
+	scratch.normal_coord_links.clear();
+	for(size_t i = 0; i < triangle_count; i++) {
+		for(unsigned int k = 0; k < 3; k++) {
+			const float3& normal = scratch.corner_normals[i * 3 + k];
+			unsigned int& coord_index = sub_obj.tex_indices[i].indices[k];
+			unsigned int* link = &scratch.coord_links[coord_index];
+			while(*link != ~0u && memcmp(&scratch.coord_normals[*link], &normal, sizeof(float3)) != 0) {
+				link = &scratch.normal_coord_links[*link];
+			}
+			if(*link != ~0u) {
+				coord_index = *link;
+				continue;
+			}
+			
+			// (link may point into normal_coord_links, which can be reallocated by the push_back)
+			const unsigned int normal_coord = (unsigned int)scratch.normal_coords.size();
+			*link = normal_coord;
+			scratch.normal_coords.push_back(scratch.coords[coord_index]);
+			scratch.coord_normals.push_back(normal);
+			scratch.normal_coord_links.push_back(~0u);
+			coord_index = normal_coord;
+		}
+	}
+	scratch.coords.swap(scratch.normal_coords);
+	sub_obj.normals = arena_array<float3>(arena, scratch.coord_normals.size());
+	copy(scratch.coord_normals.cbegin(), scratch.coord_normals.cend(), sub_obj.normals.begin());
+}
+
+// reduces triangle_count triangles of sub-object #object (indices into vertices and tex_coords) into sub_obj,
+// returns the amount of welded vertices
+size_t obj2a2m_conversion::reduce_triangles(const unsigned int object, const s_index* indices, const s_index* tex_indices, const size_t triangle_count,
+											const float3* vertices, const coord* tex_coords, sub_object& sub_obj, mesh_arena& arena,
+											reduce_scratch& scratch, const s_index* normal_indices, const unsigned int* smoothing_groups) {
+	sub_obj.vertex_indices = arena_array<s_index>(arena, triangle_count);
+	sub_obj.tex_indices = arena_array<s_index>(arena, triangle_count);
+	
+	// load data
+	phase_timer dedup_timer(&stats, CONVERSION_PHASE::DEDUP);
+	coord_dedup_table& data_table = scratch.data_table;
+	data_table.reset(triangle_count * 3);
+	scratch.vertices.clear();
+	scratch.coords.clear();
+	scratch.coord_sources.clear();
+	size_t merged_coord_count = 0;
+	for(size_t j = 0; j < triangle_count; j++) {
+		for(unsigned int k = 0; k < 3; k++) {
+			const unsigned int vertex_index = indices[j].indices[k];
+			const unsigned int coord_index = tex_indices[j].indices[k];
+			const coord& tex_coord = tex_coords[coord_index];
+			
+			// vertex already exists -> only add texture coordinate (if it doesn't exist already)
+			unsigned int cur_coord = coord_dedup_table::invalid_index;
+			unsigned int cur_vertex = data_table.find_vertex(vertex_index);
+			if(cur_vertex != coord_dedup_table::invalid_index) {
+				cur_coord = data_table.find_coord(vertex_index, tex_coord);
+				if(cur_coord != coord_dedup_table::invalid_index && scratch.coord_sources[cur_coord] != coord_index) {
+					merged_coord_count++;
+				}
+			}
+			else {
+				cur_vertex = (unsigned int)scratch.vertices.size();
+				scratch.vertices.push_back(vertices[vertex_index]);
+				data_table.add_vertex(vertex_index, cur_vertex);
+			}
+			
+			if(cur_coord == coord_dedup_table::invalid_index) {
+				cur_coord = (unsigned int)scratch.coords.size();
+				scratch.coords.push_back(tex_coord);
+				scratch.coord_sources.push_back(coord_index);
+				data_table.add_coord(vertex_index, cur_coord, tex_coord);
+			}
+			
+			sub_obj.vertex_indices[j].indices[k] = cur_vertex;
+			sub_obj.tex_indices[j].indices[k] = cur_coord;
+		}
+	}
+	
+	dedup_timer.stop();
+	stats.merged_coord_count += merged_coord_count;
+	
+	// sort vertices
+	phase_timer sort_timer(&stats, CONVERSION_PHASE::SORT);
+	const size_t vertex_count = scratch.vertices.size();
+	scratch.vertex_order.resize(vertex_count);
+	for(size_t i = 0; i < vertex_count; i++) {
+		scratch.vertex_order[i] = (unsigned int)i;
+	}
+	sort(scratch.vertex_order.begin(), scratch.vertex_order.end(), [&scratch](const unsigned int& v1, const unsigned int& v2) {
+		return cmp_vertex(scratch.vertices[v1], scratch.vertices[v2]);
+	});
+	scratch.sorted_vertices.resize(vertex_count);
+	for(size_t i = 0; i < vertex_count; i++) {
+		scratch.sorted_vertices[i] = scratch.vertices[scratch.vertex_order[i]];
+	}
+	sort_timer.stop();
+	
+	// look for equal vertices and remove duplicates
+	phase_timer weld_timer(&stats, CONVERSION_PHASE::WELD);
+	const size_t welded_count = weld_vertices(scratch.sorted_vertices, scratch.sorted_remap);
+	scratch.vertex_remap.resize(vertex_count);
+	for(size_t i = 0; i < vertex_count; i++) {
+		scratch.vertex_remap[scratch.vertex_order[i]] = scratch.sorted_remap[i];
+	}
+	stats.weld_vertex_count += vertex_count;
+	stats.welded_vertex_count += welded_count;
+	
+	// store the reduced data and make indices
+	sub_obj.vertices = arena_array<float3>(arena, scratch.sorted_vertices.size());
+	copy(scratch.sorted_vertices.cbegin(), scratch.sorted_vertices.cend(), sub_obj.vertices.begin());
+	for(auto& triangle : sub_obj.vertex_indices) {
+		for(unsigned int k = 0; k < 3; k++) {
+			triangle.indices[k] = scratch.vertex_remap[triangle.indices[k]];
+		}
+	}
+	weld_timer.stop();
+	
+	// normals are computed on the welded vertices
+	if(normals) add_sub_object_normals(normal_indices, smoothing_groups, sub_obj, arena, scratch);
+	sub_obj.coords = arena_array<coord>(arena, scratch.coords.size());
+	copy(scratch.coords.cbegin(), scratch.coords.cend(), sub_obj.coords.begin());
+	
+	// reorder the triangles for the post-transform vertex cache and the vertices/coords for fetch locality
+	if(optimize_cache) {
+		const vertex_cache_stats before = measure_vertex_cache(sub_obj.vertex_indices.begin(), triangle_count, sub_obj.vertices.size());
+		optimize_vertex_cache(sub_obj.vertex_indices.begin(), sub_obj.tex_indices.begin(), triangle_count, sub_obj.vertices.size());
+		reorder_first_use(sub_obj.vertex_indices.begin(), triangle_count, sub_obj.vertices.begin(), sub_obj.vertices.size());
+		if(!sub_obj.normals.empty()) {
+			// the normals belong to the texture coordinates (the new order only depends on the indices)
+			vector<s_index> coord_order(sub_obj.tex_indices.begin(), sub_obj.tex_indices.end());
+			reorder_first_use(coord_order.data(), triangle_count, sub_obj.normals.begin(), sub_obj.normals.size());
+		}
+		reorder_first_use(sub_obj.tex_indices.begin(), triangle_count, sub_obj.coords.begin(), sub_obj.coords.size());
+		const vertex_cache_stats after = measure_vertex_cache(sub_obj.vertex_indices.begin(), triangle_count, sub_obj.vertices.size());
+		
+		const auto name = model.obj_names.find(object);
+		a2e_debug("vertex cache of sub-object #%u \"%s\": ACMR %f -> %f, ATVR %f -> %f", object,
+				  (name != model.obj_names.end() ? name->second.c_str() : ""),
+				  before.acmr, after.acmr, before.atvr, after.atvr);
+	}
+	
+	// cluster the triangles for culling (meshlets are grown in the current triangle order, so the locality is kept)
+	if(meshlets) {
+		phase_timer meshlet_timer(&stats, CONVERSION_PHASE::MESHLETS);
+		if(!interleaved) {
+			build_meshlets(sub_obj.vertices.begin(), sub_obj.vertices.size(), rotate_model,
+						   sub_obj.vertex_indices.begin(), sub_obj.tex_indices.begin(), triangle_count, sub_obj.meshlets);
+		}
+		else {
+			// the meshlet limits apply to the interleaved vertices that will be stored (see add_interleaved_sections)
+			interleaved_builder interleaver(sub_obj.vertices.begin(), sub_obj.vertices.size(), 0, sub_obj.coords.begin(),
+											(sub_obj.normals.empty() ? nullptr : sub_obj.normals.begin()), 0, rotate_model);
+			vector<s_index> corner_indices(triangle_count);
+			interleaver.add_triangles(sub_obj.vertex_indices.begin(), sub_obj.tex_indices.begin(), triangle_count, corner_indices.data());
+			build_meshlets(sub_obj.vertices.begin(), sub_obj.vertices.size(), rotate_model,
+						   sub_obj.vertex_indices.begin(), sub_obj.tex_indices.begin(), triangle_count, sub_obj.meshlets,
+						   corner_indices.data(), interleaver.get_vertices().size());
+		}
+	}
+	
+	// lod chain: every lod is simplified further from the previous one
+	sub_obj.lods.clear();
+	if(!lod_ratios.empty()) {
+		phase_timer lod_timer(&stats, CONVERSION_PHASE::LOD);
+		mesh_simplifier simplifier(sub_obj.vertices.begin(), sub_obj.vertices.size(),
+								   sub_obj.vertex_indices.begin(), sub_obj.tex_indices.begin(), triangle_count);
+		stringstream lod_info;
+		for(const auto& ratio : lod_ratios) {
+			simplifier.simplify((size_t)((double)triangle_count * (double)ratio));
+			sub_object_lod lod;
+			lod.vertex_indices = simplifier.get_indices();
+			lod.tex_indices = simplifier.get_tex_indices();
+			lod.error = simplifier.get_error();
+			if(optimize_cache) {
+				optimize_vertex_cache(lod.vertex_indices.data(), lod.tex_indices.data(), lod.vertex_indices.size(), sub_obj.vertices.size());
+			}
+			lod_info << " -> " << lod.vertex_indices.size() << " (" << lod.error << ")";
+			sub_obj.lods.push_back(move(lod));
+		}
+		
+		const auto name = model.obj_names.find(object);
+		a2e_debug("lods of sub-object #%u \"%s\": %u triangles%s", object,
+				  (name != model.obj_names.end() ? name->second.c_str() : ""), triangle_count, lod_info.str());
+	}
+	
+	return welded_count;
+}
+
+// serializes the reduced model into a2m v2 buffers (see the format specification in obj2a2m.cpp)
+vector<a2m_buffer> obj2a2m_conversion::make_a2m_v2_sections(const unsigned int total_vertex_count, const unsigned int total_coord_count) {
+	enum A2M_SECTION : unsigned int {
+		HEADER,
+		VERTICES,
+		TEX_COORDS,
+		OBJECTS,
+		INDICES,
+		COLLISION,
+		__MAX_A2M_SECTION
+	};
+	vector<a2m_buffer> sections(__MAX_A2M_SECTION);
+	
+	a2m_buffer& header = sections[HEADER];
+	header.put_block("A2EMODEL", 8);
+	header.put_uint(A2M_VERSION);
+	header.put_char(collision_object ? 0x02 : 0x00);
+	header.put_uint(total_vertex_count);
+	header.put_uint(total_coord_count);
+	
+	sections[VERTICES].reserve(total_vertex_count * sizeof(float3));
+	for(unsigned int i = 0; i < object_count; i++) {
+		sections[VERTICES].put_vertices(sub_objects[i].vertices.begin(), sub_objects[i].vertices.size(), rotate_model);
+	}
+	sections[TEX_COORDS].reserve(total_coord_count * sizeof(float) * 2);
+	for(unsigned int i = 0; i < object_count; i++) {
+		sections[TEX_COORDS].put_floats((const float*)sub_objects[i].coords.begin(), sub_objects[i].coords.size() * 2);
+	}
+	
+	sections[OBJECTS].put_uint(object_count);
+	for(map<unsigned int, string>::iterator oiter = model.obj_names.begin(); oiter != model.obj_names.end(); oiter++) {
+		sections[OBJECTS].put_terminated_block(oiter->second, 0xFF);
+	}
+	
+	size_t index_size = 0;
+	for(unsigned int i = 0; i < object_count; i++) {
+		index_size += sizeof(unsigned int) + sub_objects[i].vertex_indices.size() * sizeof(s_index) * 2;
+	}
+	sections[INDICES].reserve(index_size);
+	for(unsigned int i = 0; i < object_count; i++) {
+		sections[INDICES].put_uint((unsigned int)sub_objects[i].vertex_indices.size());
+		sections[INDICES].put_uints((const unsigned int*)sub_objects[i].vertex_indices.begin(), sub_objects[i].vertex_indices.size() * 3);
+		sections[INDICES].put_uints((const unsigned int*)sub_objects[i].tex_indices.begin(), sub_objects[i].tex_indices.size() * 3);
+	}
+	
+	if(collision_object) {
+		a2m_buffer& collision = sections[COLLISION];
+		collision.put_uint((unsigned int)collision_model.vertices.size());
+		collision.put_vertices(collision_model.vertices.begin(), collision_model.vertices.size(), rotate_collision);
+		
+		collision.put_uint((unsigned int)collision_model.get_triangle_count(0));
+		collision.put_uints((const unsigned int*)collision_model.get_indices(0), collision_model.get_triangle_count(0) * 3);
+	}
+	
+	return sections;
+}
+
+// adds the compactly encoded vertices, texture coordinates and indices to the a2m v3 builder (see the format specification in obj2a2m.cpp)
+void obj2a2m_conversion::add_compact_sections(a2m_v3_builder& builder, const unsigned int total_vertex_count, const unsigned int total_coord_count) {
+	a2m_buffer vertices, tex_coords, objects, indices, tex_indices;
+	vertices.reserve(total_vertex_count * sizeof(uint16_t) * 3);
+	tex_coords.reserve(total_coord_count * sizeof(uint16_t) * 2);
+	objects.reserve(object_count * sizeof(a2m_v3_compact_object));
+	
+	float max_vertex_error = 0.0f, max_coord_error = 0.0f;
+	size_t triangle_count = 0, index16_objects = 0;
+	unsigned int first_vertex = 0, first_coord = 0;
+	for(unsigned int i = 0; i < object_count; i++) {
+		const sub_object& sub_obj = sub_objects[i];
+		const unsigned int vertex_count = (unsigned int)sub_obj.vertices.size();
+		const unsigned int coord_count = (unsigned int)sub_obj.coords.size();
+		
+		float3 bounds_min, bounds_max;
+		compute_bounds(sub_obj.vertices.begin(), vertex_count, rotate_model, bounds_min, bounds_max);
+		max_vertex_error = std::max(max_vertex_error,
+									put_quantized_vertices(vertices, sub_obj.vertices.begin(), vertex_count, rotate_model, bounds_min, bounds_max));
+		max_coord_error = std::max(max_coord_error, put_half_coords(tex_coords, sub_obj.coords.begin(), coord_count));
+		
+		// the indices are stored relative to the first vertex/coord of the sub-object
+		const a2m_v3_compact_object object {
+			first_vertex, vertex_count, first_coord, coord_count,
+			(uint32_t)indices.size(), (uint32_t)tex_indices.size(),
+			(uint16_t)(vertex_count <= A2M_COMPACT_MAX_INDEX16_COUNT ? 2 : 4),
+			(uint16_t)(coord_count <= A2M_COMPACT_MAX_INDEX16_COUNT ? 2 : 4),
+			{ bounds_min.x, bounds_min.y, bounds_min.z },
+			{ bounds_max.x, bounds_max.y, bounds_max.z },
+		};
+		objects.put_block(&object, sizeof(a2m_v3_compact_object));
+		put_compact_indices(indices, sub_obj.vertex_indices.begin(), sub_obj.vertex_indices.size(), first_vertex, object.index_size);
+		put_compact_indices(tex_indices, sub_obj.tex_indices.begin(), sub_obj.tex_indices.size(), first_coord, object.tex_index_size);
+		
+		if(object.index_size == 2) index16_objects++;
+		triangle_count += sub_obj.vertex_indices.size();
+		first_vertex += vertex_count;
+		first_coord += coord_count;
+	}
+	
+	// report the savings compared to the uncompressed v3 sections
+	const size_t float_index_size = triangle_count * sizeof(s_index);
+	a2e_debug("compact vertices: %u KB -> %u KB (max error %f)",
+			  (total_vertex_count * sizeof(float3)) / 1024, vertices.size() / 1024, max_vertex_error);
+	a2e_debug("compact texture coordinates: %u KB -> %u KB (max error %f)",
+			  (total_coord_count * sizeof(coord)) / 1024, tex_coords.size() / 1024, max_coord_error);
+	a2e_debug("compact indices: %u KB -> %u KB (%u of %u sub-objects with 16 bit indices)",
+			  float_index_size / 1024, indices.size() / 1024, index16_objects, object_count);
+	a2e_debug("compact texture coordinate indices: %u KB -> %u KB",
+			  float_index_size / 1024, tex_indices.size() / 1024);
+	
+	builder.add_section(A2M_V3_SECTION::QUANTIZED_VERTICES, move(vertices), total_vertex_count);
+	builder.add_section(A2M_V3_SECTION::HALF_TEX_COORDS, move(tex_coords), total_coord_count);
+	builder.add_section(A2M_V3_SECTION::COMPACT_OBJECTS, move(objects), object_count);
+	builder.add_section(A2M_V3_SECTION::COMPACT_INDICES, move(indices), triangle_count);
+	builder.add_section(A2M_V3_SECTION::COMPACT_TEX_INDICES, move(tex_indices), triangle_count);
+}
+
+// adds the interleaved vertices and single-indexed triangles (-interleaved) to the a2m v3 builder (see the format
+// specification in obj2a2m.cpp). the corners of the lod triangles are remapped to the interleaved vertices as well
+void obj2a2m_conversion::add_interleaved_sections(a2m_v3_builder& builder) {
+	const auto interleave_start_time = chrono::high_resolution_clock::now();
+	vector<unsigned int> first_vertices(object_count), first_coords(object_count);
+	unsigned int first_vertex = 0, first_coord = 0;
+	for(unsigned int i = 0; i < object_count; i++) {
+		first_vertices[i] = first_vertex;
+		first_coords[i] = first_coord;
+		first_vertex += (unsigned int)sub_objects[i].vertices.size();
+		first_coord += (unsigned int)sub_objects[i].coords.size();
+	}
+	
+	// unify the triangle corners of each sub-object and store its vertices in the interleaved layout (in parallel)
+	const size_t vertex_floats = interleaved_vertex_floats(normals, tangents);
+	vector<vector<float>> object_vertices(object_count);
+	vector<vector<s_index>> object_indices(object_count);
+	parallel_for(object_count, thread_count, [&](const size_t i) {
+		sub_object& sub_obj = sub_objects[i];
+		interleaved_builder interleaver(sub_obj.vertices.begin(), sub_obj.vertices.size(), first_vertices[i], sub_obj.coords.begin(),
+										(sub_obj.normals.empty() ? nullptr : sub_obj.normals.begin()), first_coords[i], rotate_model);
+		const size_t object_triangle_count = sub_obj.vertex_indices.size();
+		object_indices[i].resize(object_triangle_count);
+		interleaver.add_triangles(sub_obj.vertex_indices.begin(), sub_obj.tex_indices.begin(), object_triangle_count,
+								  object_indices[i].data());
+		for(auto& lod : sub_obj.lods) {
+			vector<s_index> lod_indices(lod.vertex_indices.size());
+			interleaver.add_triangles(lod.vertex_indices.data(), lod.tex_indices.data(), lod.vertex_indices.size(), lod_indices.data());
+			lod.vertex_indices.swap(lod_indices);
+			lod.tex_indices.clear();
+		}
+		
+		const vector<interleaved_vertex>& unified_vertices = interleaver.get_vertices();
+		const vector<float3>& unified_normals = interleaver.get_normals();
+		const size_t unified_count = unified_vertices.size();
+		vector<vertex_tangent> unified_tangents;
+		if(tangents) {
+			// (from the full resolution triangles only)
+			vector<float> positions(unified_count * 3), tex_coords(unified_count * 2);
+			for(size_t j = 0; j < unified_count; j++) {
+				memcpy(&positions[j * 3], unified_vertices[j].position, sizeof(float) * 3);
+				memcpy(&tex_coords[j * 2], unified_vertices[j].tex_coord, sizeof(float) * 2);
+			}
+			compute_tangents(positions.data(), tex_coords.data(), (const float*)unified_normals.data(), unified_count,
+							 object_indices[i].data(), object_triangle_count, unified_tangents);
+		}
+		
+		vector<float>& vertex_data = object_vertices[i];
+		vertex_data.resize(unified_count * vertex_floats);
+		for(size_t j = 0; j < unified_count; j++) {
+			float* vertex = &vertex_data[j * vertex_floats];
+			memcpy(vertex, &unified_vertices[j], sizeof(interleaved_vertex));
+			vertex += sizeof(interleaved_vertex) / sizeof(float);
+			if(normals) {
+				memcpy(vertex, &unified_normals[j], sizeof(float) * 3);
+				vertex += 3;
+			}
+			if(tangents) memcpy(vertex, &unified_tangents[j], sizeof(vertex_tangent));
+		}
+	});
+	
+	a2m_buffer vertices, objects, indices;
+	size_t vertex_count = 0, triangle_count = 0, index16_objects = 0;
+	for(unsigned int i = 0; i < object_count; i++) {
+		const size_t object_vertex_count = object_vertices[i].size() / vertex_floats;
+		const a2m_v3_interleaved_object object {
+			(uint32_t)vertex_count, (uint32_t)object_vertex_count, (uint32_t)indices.size(),
+			(uint16_t)(object_vertex_count <= A2M_COMPACT_MAX_INDEX16_COUNT ? 2 : 4), 0
+		};
+		objects.put_block(&object, sizeof(a2m_v3_interleaved_object));
+		vertices.put_block(object_vertices[i].data(), object_vertices[i].size() * sizeof(float));
+		put_compact_indices(indices, object_indices[i].data(), object_indices[i].size(), 0, object.index_size);
+		
+		// lod triangles index the interleaved vertices globally
+		for(auto& lod : sub_objects[i].lods) {
+			for(auto& triangle : lod.vertex_indices) {
+				for(unsigned int k = 0; k < 3; k++) {
+					triangle.indices[k] += (unsigned int)vertex_count;
+				}
+			}
+		}
+		
+		if(object.index_size == 2) index16_objects++;
+		vertex_count += object_vertex_count;
+		triangle_count += object_indices[i].size();
+		vector<float>().swap(object_vertices[i]);
+		vector<s_index>().swap(object_indices[i]);
+	}
+	a2e_debug("interleaved %u vertices and %u texture coordinates into %u vertices (%u of %u sub-objects with 16 bit indices) in %fs",
+			  first_vertex, first_coord, vertex_count, index16_objects, object_count,
+			  chrono::duration<double>(chrono::high_resolution_clock::now() - interleave_start_time).count());
+	
+	builder.add_section(A2M_V3_SECTION::INTERLEAVED_VERTICES, move(vertices), vertex_count);
+	builder.add_section(A2M_V3_SECTION::INTERLEAVED_OBJECTS, move(objects), object_count);
+	builder.add_section(A2M_V3_SECTION::INTERLEAVED_INDICES, move(indices), triangle_count);
+}
+
+// adds the bounds of the (reduced) sub_obj to the culling data of sub-object #object and its meshlets, whose triangles
+// start at first_triangle. a sub-object may be added in multiple parts (in triangle order, see convert_out_of_core)
+void obj2a2m_conversion::add_culling_data(const unsigned int object, const sub_object& sub_obj, const size_t first_triangle) {
+	if(object_bounds.size() != object_count) {
+		object_bounds.assign(object_count, a2m_v3_object_bounds {});
+		object_has_bounds.assign(object_count, false);
+	}
+	a2m_v3_object_bounds& bounds = object_bounds[object];
+	
+	const size_t vertex_count = sub_obj.vertices.size();
+	if(vertex_count > 0) {
+		float3 bounds_min, bounds_max;
+		compute_bounds(sub_obj.vertices.begin(), vertex_count, rotate_model, bounds_min, bounds_max);
+		bounding_sphere sphere = compute_bounding_sphere(sub_obj.vertices.begin(), vertex_count, rotate_model);
+		if(object_has_bounds[object]) {
+			bounds_min = float3(std::min(bounds_min.x, bounds.bounds_min[0]), std::min(bounds_min.y, bounds.bounds_min[1]),
+								std::min(bounds_min.z, bounds.bounds_min[2]));
+			bounds_max = float3(std::max(bounds_max.x, bounds.bounds_max[0]), std::max(bounds_max.y, bounds.bounds_max[1]),
+								std::max(bounds_max.z, bounds.bounds_max[2]));
+			bounding_sphere prev_sphere;
+			prev_sphere.center = float3(bounds.sphere_center[0], bounds.sphere_center[1], bounds.sphere_center[2]);
+			prev_sphere.radius = bounds.sphere_radius;
+			sphere = merge_bounding_spheres(prev_sphere, sphere);
+		}
+		bounds.bounds_min[0] = bounds_min.x;
+		bounds.bounds_min[1] = bounds_min.y;
+		bounds.bounds_min[2] = bounds_min.z;
+		bounds.bounds_max[0] = bounds_max.x;
+		bounds.bounds_max[1] = bounds_max.y;
+		bounds.bounds_max[2] = bounds_max.z;
+		bounds.sphere_center[0] = sphere.center.x;
+		bounds.sphere_center[1] = sphere.center.y;
+		bounds.sphere_center[2] = sphere.center.z;
+		bounds.sphere_radius = sphere.radius;
+		object_has_bounds[object] = true;
+	}
+	
+	for(const auto& sub_meshlet : sub_obj.meshlets) {
+		const a2m_v3_meshlet stored_meshlet {
+			(uint32_t)(first_triangle + sub_meshlet.first_triangle),
+			(uint16_t)sub_meshlet.triangle_count, (uint16_t)sub_meshlet.vertex_count,
+			{ sub_meshlet.sphere.center.x, sub_meshlet.sphere.center.y, sub_meshlet.sphere.center.z },
+			sub_meshlet.sphere.radius,
+			{ sub_meshlet.cone_apex.x, sub_meshlet.cone_apex.y, sub_meshlet.cone_apex.z },
+			{ sub_meshlet.cone_axis.x, sub_meshlet.cone_axis.y, sub_meshlet.cone_axis.z },
+			sub_meshlet.cone_cutoff,
+		};
+		object_meshlets.push_back(stored_meshlet);
+	}
+	bounds.meshlet_count += (uint32_t)sub_obj.meshlets.size();
+}
+
+// adds the OBJECT_BOUNDS section and (with -meshlets) the MESHLETS section to the a2m v3 builder
+void obj2a2m_conversion::add_culling_sections(a2m_v3_builder& builder) {
+	if(object_bounds.size() != object_count) {
+		object_bounds.assign(object_count, a2m_v3_object_bounds {});
+	}
+	
+	// the meshlets are stored in sub-object order
+	uint32_t first_meshlet = 0;
+	for(auto& bounds : object_bounds) {
+		bounds.first_meshlet = first_meshlet;
+		first_meshlet += bounds.meshlet_count;
+	}
+	
+	a2m_buffer bounds_data;
+	bounds_data.put_block(object_bounds.data(), object_bounds.size() * sizeof(a2m_v3_object_bounds));
+	builder.add_section(A2M_V3_SECTION::OBJECT_BOUNDS, move(bounds_data), object_bounds.size());
+	if(meshlets) {
+		size_t meshlet_triangle_count = 0;
+		for(const auto& stored_meshlet : object_meshlets) {
+			meshlet_triangle_count += stored_meshlet.triangle_count;
+		}
+		a2m_buffer meshlet_data;
+		meshlet_data.put_block(object_meshlets.data(), object_meshlets.size() * sizeof(a2m_v3_meshlet));
+		builder.add_section(A2M_V3_SECTION::MESHLETS, move(meshlet_data), object_meshlets.size());
+		a2e_debug("built %u meshlets (%f triangles per meshlet)", object_meshlets.size(),
+				  (object_meshlets.empty() ? 0.0 : (double)meshlet_triangle_count / (double)object_meshlets.size()));
+	}
+}
+
+// adds the LODS, LOD_INDICES and LOD_TEX_INDICES sections (-lod) to the a2m v3 builder
+// (there is no LOD_TEX_INDICES section with -interleaved, see add_interleaved_sections)
+void obj2a2m_conversion::add_lod_sections(a2m_v3_builder& builder) {
+	a2m_buffer lods, indices, tex_indices;
+	size_t triangle_count = 0;
+	for(size_t level = 0; level < lod_ratios.size(); level++) {
+		size_t level_triangle_count = 0;
+		for(unsigned int i = 0; i < object_count; i++) {
+			const sub_object_lod& lod = sub_objects[i].lods[level];
+			const a2m_v3_lod entry {
+				(uint32_t)triangle_count, (uint32_t)lod.vertex_indices.size(), lod_ratios[level], lod.error
+			};
+			lods.put_block(&entry, sizeof(a2m_v3_lod));
+			indices.put_block(lod.vertex_indices.data(), lod.vertex_indices.size() * sizeof(s_index));
+			tex_indices.put_block(lod.tex_indices.data(), lod.tex_indices.size() * sizeof(s_index));
+			triangle_count += lod.vertex_indices.size();
+			level_triangle_count += lod.vertex_indices.size();
+		}
+		a2e_debug("lod #%u (ratio %f): %u triangles", level + 1, lod_ratios[level], level_triangle_count);
+	}
+	builder.add_section(A2M_V3_SECTION::LODS, move(lods), lod_ratios.size() * object_count);
+	builder.add_section(A2M_V3_SECTION::LOD_INDICES, move(indices), triangle_count);
+	if(!interleaved) builder.add_section(A2M_V3_SECTION::LOD_TEX_INDICES, move(tex_indices), triangle_count);
+}
+
+// serializes the reduced model into a2m v3 buffers (see the format specification in obj2a2m.cpp)
+vector<a2m_buffer> obj2a2m_conversion::make_a2m_v3_sections(const unsigned int total_vertex_count, const unsigned int total_coord_count) {
+	a2m_v3_builder builder;
+	
+	if(!compact_encoding && !interleaved) {
+		a2m_buffer vertices;
+		vertices.reserve(total_vertex_count * sizeof(float3));
+		for(unsigned int i = 0; i < object_count; i++) {
+			vertices.put_vertices(sub_objects[i].vertices.begin(), sub_objects[i].vertices.size(), rotate_model);
+		}
+		builder.add_section(A2M_V3_SECTION::VERTICES, move(vertices), total_vertex_count);
+		
+		a2m_buffer tex_coords;
+		tex_coords.reserve(total_coord_count * sizeof(float) * 2);
+		for(unsigned int i = 0; i < object_count; i++) {
+			tex_coords.put_floats((const float*)sub_objects[i].coords.begin(), sub_objects[i].coords.size() * 2);
+		}
+		builder.add_section(A2M_V3_SECTION::TEX_COORDS, move(tex_coords), total_coord_count);
+	}
+	
+	// object table + string table
+	a2m_buffer objects, strings;
+	size_t triangle_count = 0;
+	for(unsigned int i = 0; i < object_count; i++) {
+		const string& name = model.obj_names[i];
+		const a2m_v3_object object {
+			(uint32_t)strings.size(), (uint32_t)name.size(),
+			(uint32_t)triangle_count, (uint32_t)sub_objects[i].vertex_indices.size()
+		};
+		objects.put_block(&object, sizeof(a2m_v3_object));
+		strings.put_terminated_block(name, 0);
+		add_culling_data(i, sub_objects[i], triangle_count);
+		triangle_count += sub_objects[i].vertex_indices.size();
+	}
+	builder.add_section(A2M_V3_SECTION::OBJECTS, move(objects), object_count);
+	
+	if(interleaved) add_interleaved_sections(builder);
+	else if(!compact_encoding) {
+		a2m_buffer indices, tex_indices;
+		indices.reserve(triangle_count * sizeof(s_index));
+		tex_indices.reserve(triangle_count * sizeof(s_index));
+		for(unsigned int i = 0; i < object_count; i++) {
+			indices.put_block(sub_objects[i].vertex_indices.begin(), sub_objects[i].vertex_indices.size() * sizeof(s_index));
+			tex_indices.put_block(sub_objects[i].tex_indices.begin(), sub_objects[i].tex_indices.size() * sizeof(s_index));
+		}
+		builder.add_section(A2M_V3_SECTION::INDICES, move(indices), triangle_count);
+		builder.add_section(A2M_V3_SECTION::TEX_INDICES, move(tex_indices), triangle_count);
+	}
+	else add_compact_sections(builder, total_vertex_count, total_coord_count);
+	builder.add_section(A2M_V3_SECTION::STRINGS, move(strings), object_count);
+	add_culling_sections(builder);
+	if(!lod_ratios.empty()) add_lod_sections(builder);
+	
+	if(collision_object) add_collision_sections(builder);
+	
+	if(compress_sections) {
+		const auto compress_start_time = chrono::high_resolution_clock::now();
+		builder.compress(A2M_V3_DEFAULT_COMPRESSION_LEVEL, thread_count);
+		a2e_debug("compressed sections in %fs", chrono::duration<double>(chrono::high_resolution_clock::now() - compress_start_time).count());
+	}
+	
+	return builder.finish((collision_object ? A2M_V3_FLAG_COLLISION : 0x00) | (compact_encoding ? A2M_V3_FLAG_COMPACT : 0x00) |
+						  (interleaved ? A2M_V3_FLAG_INTERLEAVED : 0x00) | (normals ? A2M_V3_FLAG_NORMALS : 0x00) |
+						  (tangents ? A2M_V3_FLAG_TANGENTS : 0x00));
+}
+
+// hashes the inputs and options into output_entry and checks them against the manifest entry of the output
+bool obj2a2m_conversion::is_up_to_date(const conversion_manifest& manifest, conversion_manifest::entry& output_entry) {
+	output_entry.options = make_options_string(*this);
+	if(!hash_file(obj_filename, thread_count, output_entry.obj_hash)) return false;
+	if(collision_object && !hash_file(collision_filename, thread_count, output_entry.collision_hash)) return false;
+	
+	conversion_manifest::entry recorded_entry;
+	if(force || !manifest.find(a2m_filename, recorded_entry)) return false;
+	if(output_entry.obj_hash != recorded_entry.obj_hash ||
+	   output_entry.collision_hash != recorded_entry.collision_hash ||
+	   output_entry.options != recorded_entry.options) {
+		return false;
+	}
+	
+	// the mtllib is only known after parsing the .obj, but an unchanged .obj still references the recorded mtllib
+	// (relative to the directory of the .obj)
+	file_hash mtllib_hash;
+	hash_file(get_referenced_path(obj_filename, recorded_entry.mtllib), thread_count, mtllib_hash);
+	if(mtllib_hash != recorded_entry.mtllib_hash) return false;
+	
+	// the outputs must still exist and must not have been modified
+	uint64_t output_size = 0;
+	if(!get_file_size(a2m_filename, output_size) || output_size != recorded_entry.output_size) return false;
+	if(mat_mapping && !get_file_size(a2m_filename + ".mapping.txt", output_size)) return false;
+	return true;
+}
+
+bool obj2a2m_conversion::convert() {
+	a2e_debug("converting \"%s\" to \"%s\" ...", obj_filename.c_str(), a2m_filename.c_str());
+	const auto conversion_start_time = chrono::high_resolution_clock::now();
+	if(collision_bvh && !collision_object) {
+		a2e_error("-collision_bvh requires a collision model (-collision)!");
+		return false;
+	}
+	if(interleaved && compact_encoding) {
+		a2e_error("-interleaved and -compact can't be combined!");
+		return false;
+	}
+	if(normals && to_obj) {
+		a2e_error("-normals and -tangents aren't supported with -to_obj!");
+		return false;
+	}
+	
+	// incremental conversion (-incremental, or if a manifest already exists next to the output)
+	shared_ptr<conversion_manifest> manifest;
+	conversion_manifest::entry output_entry;
+	if(!to_obj) {
+		manifest = conversion_manifest::get(a2m_filename, incremental);
+		if(manifest != nullptr && is_up_to_date(*manifest, output_entry)) {
+			a2e_log("\"%s\" is up-to-date (inputs and options didn't change since the last conversion) - skipping conversion of \"%s\"",
+					a2m_filename, obj_filename);
+			result.success = true;
+			result.skipped = true;
+			result.time = chrono::duration<double>(chrono::high_resolution_clock::now() - conversion_start_time).count();
+			if(verify && !verify_output()) {
+				result.success = false;
+				return false;
+			}
+			return true;
+		}
+	}
+	
+	if(!(out_of_core ? convert_out_of_core() : convert_in_memory())) {
+		return false;
+	}
+	
+	//
+	phase_timer mat_mapping_timer(&stats, CONVERSION_PHASE::MAT_MAPPING);
+	create_mat_mapping();
+	mat_mapping_timer.stop();
+	
+	if(manifest != nullptr) {
+		// a missing mtllib is recorded as an empty hash
+		output_entry.mtllib = mtllib;
+		hash_file(get_referenced_path(obj_filename, mtllib), thread_count, output_entry.mtllib_hash);
+		get_file_size(a2m_filename, output_entry.output_size);
+		manifest->update(a2m_filename, output_entry);
+	}
+
+	// done!
+	if(result.obj_vertex_count > result.vertex_count) a2e_debug("reduced model by %u vertices!", result.obj_vertex_count - result.vertex_count);
+	if(result.obj_coord_count > result.coord_count) a2e_debug("reduced model by %u texture coordinates!", result.obj_coord_count - result.coord_count);
+	a2e_debug("successfully converted \"%s\" to \"%s\" (%u sub-object%s, %u vertices, %u texture coordinates)!",
+			 obj_filename.c_str(), a2m_filename.c_str(), model.obj_names.size(), (model.obj_names.size() == 1 ? "" : "s"), result.vertex_count, result.coord_count);
+	
+	result.success = true;
+	result.time = chrono::duration<double>(chrono::high_resolution_clock::now() - conversion_start_time).count();
+	
+	if(stats_output == STATS_OUTPUT::TEXT) log_stats();
+	else if(stats_output == STATS_OUTPUT::JSON && !write_stats_json()) return false;
+	
+	if(verify && !verify_output()) {
+		result.success = false;
+		return false;
+	}
+	return true;
+}
+
+bool obj2a2m_conversion::verify_output() {
+	if(to_obj) {
+		a2e_error("-verify isn't supported with -to_obj!");
+		return false;
+	}
+	a2e_debug("verifying \"%s\" ...", a2m_filename);
+	a2m_model a2m;
+	if(!read_a2m(a2m_filename, a2m, A2M_READ_MODE::MMAP, thread_count)) {
+		return false;
+	}
+	
+	// the in-memory conversion still has the obj data, otherwise (out-of-core, up-to-date output) the obj is loaded again
+	// (with its normals and smoothing groups, which verify_a2m_normals checks the a2m normals against)
+	auto load_obj = [this](const bool collision_obj, const string& filename, obj_model& obj) {
+		string obj_mtllib = "";
+		const bool load_normals = (normals && !collision_obj);
+		if(gz_line_stream::is_compressed(filename.c_str())) {
+			return load_obj_data_gz(collision_obj, join_mat_objects, load_normals, thread_count, filename.c_str(), obj_mtllib, obj);
+		}
+		return load_obj_data_mapped(collision_obj, join_mat_objects, load_normals, thread_count, filename.c_str(), obj_mtllib, obj);
+	};
+	obj_model verify_model, verify_collision_model;
+	const obj_model* src_model = &model;
+	const obj_model* src_collision_model = (collision_object ? &collision_model : nullptr);
+	if(out_of_core || result.skipped) {
+		if(!load_obj(false, obj_filename, verify_model)) return false;
+		src_model = &verify_model;
+	}
+	if(collision_object && result.skipped) {
+		if(!load_obj(true, collision_filename, verify_collision_model)) return false;
+		src_collision_model = &verify_collision_model;
+	}
+	
+	if(!verify_a2m_model(a2m, *src_model, src_collision_model, rotate_model, rotate_collision)) {
+		a2e_error("verification of \"%s\" failed!", a2m_filename);
+		return false;
+	}
+	// (a stored bvh has already been validated by read_a2m)
+	if(collision_bvh && a2m.collision_bvh.empty() && !a2m.collision_indices.empty()) {
+		a2e_error("verification of \"%s\" failed: the collision bvh is missing!", a2m_filename);
+		return false;
+	}
+	if(!a2m.collision_bvh.empty()) a2e_log("verify: collision bvh (%u nodes) is valid", a2m.collision_bvh.size());
+	
+	if((a2m_v3 && !a2m.has_bounds) || (meshlets && a2m.meshlets.empty() && !a2m.indices.empty())) {
+		a2e_error("verification of \"%s\" failed: the culling data is missing!", a2m_filename);
+		return false;
+	}
+	if(!verify_a2m_culling_data(a2m)) {
+		a2e_error("verification of \"%s\" failed!", a2m_filename);
+		return false;
+	}
+	
+	if(a2m.lods.size() != lod_ratios.size() * a2m.objects.size()) {
+		a2e_error("verification of \"%s\" failed: the a2m contains %u lods, expected %u!", a2m_filename,
+				  (a2m.objects.empty() ? 0 : a2m.lods.size() / a2m.objects.size()), lod_ratios.size());
+		return false;
+	}
+	if(!verify_a2m_lods(a2m)) {
+		a2e_error("verification of \"%s\" failed!", a2m_filename);
+		return false;
+	}
+	
+	if(interleaved != a2m.interleaved) {
+		a2e_error("verification of \"%s\" failed: the a2m %s interleaved!", a2m_filename, (a2m.interleaved ? "is" : "isn't"));
+		return false;
+	}
+	if(!verify_a2m_interleaved(a2m)) {
+		a2e_error("verification of \"%s\" failed!", a2m_filename);
+		return false;
+	}
+	
+	if(normals == a2m.normals.empty() || tangents == a2m.tangents.empty()) {
+		a2e_error("verification of \"%s\" failed: the normals or tangents are missing or unexpected!", a2m_filename);
+		return false;
+	}
+	if(!verify_a2m_normals(a2m, *src_model, rotate_model)) {
+		a2e_error("verification of \"%s\" failed!", a2m_filename);
+		return false;
+	}
+	return true;
+}
+
+// welding throughput of the reduce phase (the weld time is summed over all reduce tasks)
+void obj2a2m_conversion::log_weld_stats() const {
+	const double weld_time = stats.get_time(CONVERSION_PHASE::WELD);
+	a2e_debug("welded %u of %u vertices in %fs (%f Mvertices/s)", (size_t)stats.welded_vertex_count, (size_t)stats.weld_vertex_count,
+			  weld_time, (weld_time > 0.0 ? (double)stats.weld_vertex_count / weld_time / 1.0e6 : 0.0));
+}
+
+void obj2a2m_conversion::log_stats() const {
+	stringstream table;
+	table << fixed << setprecision(3);
+	table << "conversion stats of \"" << obj_filename << "\":" << endl;
+	for(unsigned int i = 0; i < (unsigned int)CONVERSION_PHASE::__MAX_CONVERSION_PHASE; i++) {
+		const CONVERSION_PHASE phase = (CONVERSION_PHASE)i;
+		table << "\t" << left << setw(12) << conversion_stats::get_phase_name(phase) << right << setw(10) << stats.get_time(phase) << "s" << endl;
+	}
+	table << "\t" << left << setw(12) << "total" << right << setw(10) << result.time << "s" << endl;
+	table << "\ttokens: " << stats.token_count << ", faces: " << stats.face_count << " (" << stats.quad_count << " quads split)" << endl;
+	table << "\ttriangles: " << result.triangle_count << ", vertices: " << result.obj_vertex_count << " -> " << result.vertex_count
+		  << " (" << stats.welded_vertex_count << " welded), texture coordinates: " << result.obj_coord_count << " -> " << result.coord_count
+		  << " (" << stats.merged_coord_count << " uv duplicates merged)" << endl;
+	table << "\tpeak rss: " << (get_peak_rss() / (1024 * 1024)) << " MB";
+	a2e_log("%s", table.str());
+}
+
+// escapes a string for json output
+static string json_string(const string& str) {
+	stringstream escaped;
+	escaped << "\"";
+	for(const auto& ch : str) {
+		switch(ch) {
+			case '"': escaped << "\\\""; break;
+			case '\\': escaped << "\\\\"; break;
+			case '\n': escaped << "\\n"; break;
+			case '\r': escaped << "\\r"; break;
+			case '\t': escaped << "\\t"; break;
+			default:
+				if((unsigned char)ch < 0x20) {
+					escaped << "\\u" << hex << setw(4) << setfill('0') << (unsigned int)(unsigned char)ch << dec << setfill(' ');
+				}
+				else escaped << ch;
+				break;
+		}
+	}
+	escaped << "\"";
+	return escaped.str();
+}
+
+bool obj2a2m_conversion::write_stats_json() const {
+	const string stats_filename = a2m_filename + ".stats.json";
+	file_io f;
+	if(!f.open(stats_filename.c_str(), file_io::OPEN_TYPE::WRITE_BINARY)) {
+		a2e_error("couldn't open/write stats file \"%s\"!", stats_filename);
+		return false;
+	}
+	
+	fstream* fs = f.get_filestream();
+	*fs << setprecision(6) << fixed;
+	*fs << "{" << endl;
+	*fs << "\t\"obj\": " << json_string(obj_filename) << "," << endl;
+	*fs << "\t\"a2m\": " << json_string(a2m_filename) << "," << endl;
+	*fs << "\t\"total_time\": " << result.time << "," << endl;
+	*fs << "\t\"phases\": {" << endl;
+	for(unsigned int i = 0; i < (unsigned int)CONVERSION_PHASE::__MAX_CONVERSION_PHASE; i++) {
+		const CONVERSION_PHASE phase = (CONVERSION_PHASE)i;
+		*fs << "\t\t\"" << conversion_stats::get_phase_name(phase) << "\": " << stats.get_time(phase);
+		*fs << (i + 1 < (unsigned int)CONVERSION_PHASE::__MAX_CONVERSION_PHASE ? "," : "") << endl;
+	}
+	*fs << "\t}," << endl;
+	*fs << "\t\"counters\": {" << endl;
+	*fs << "\t\t\"tokens\": " << stats.token_count << "," << endl;
+	*fs << "\t\t\"faces\": " << stats.face_count << "," << endl;
+	*fs << "\t\t\"quads_split\": " << stats.quad_count << "," << endl;
+	*fs << "\t\t\"triangles\": " << result.triangle_count << "," << endl;
+	*fs << "\t\t\"obj_vertices\": " << result.obj_vertex_count << "," << endl;
+	*fs << "\t\t\"a2m_vertices\": " << result.vertex_count << "," << endl;
+	*fs << "\t\t\"vertices_welded\": " << stats.welded_vertex_count << "," << endl;
+	*fs << "\t\t\"obj_tex_coords\": " << result.obj_coord_count << "," << endl;
+	*fs << "\t\t\"a2m_tex_coords\": " << result.coord_count << "," << endl;
+	*fs << "\t\t\"uv_duplicates_merged\": " << stats.merged_coord_count << endl;
+	*fs << "\t}," << endl;
+	*fs << "\t\"peak_rss\": " << get_peak_rss() << endl;
+	*fs << "}" << endl;
+	f.close();
+	return true;
+}
+
+bool obj2a2m_conversion::load_collision_model() {
+	a2e_debug("loading collision obj ...");
+	if(!load_obj_data(true, collision_filename.c_str(), collision_model)) {
+		return false;
+	}
+	
+	if(collision_model.obj_names.size() > 1) {
+		a2e_error("collision model contains too many sub-objects - only one sub-object allowed!");
+		return false;
+	}
+	else if(collision_model.obj_names.size() == 0) {
+		a2e_error("collision model has no object data!");
+		return false;
+	}
+	
+	// the bvh is built over the vertices as they are stored (rotated with -rotate_collision)
+	if(collision_bvh) {
+		a2e_debug("building collision bvh ...");
+		phase_timer bvh_timer(&stats, CONVERSION_PHASE::BVH);
+		vector<float3> vertices(collision_model.vertices.begin(), collision_model.vertices.end());
+		if(rotate_collision) rotate_vertices((float*)vertices.data(), vertices.size());
+		vector<s_index> triangles(collision_model.get_indices(0), collision_model.get_indices(0) + collision_model.get_triangle_count(0));
+		build_collision_bvh(vertices.data(), triangles, collision_bvh_nodes);
+		copy(triangles.begin(), triangles.end(), collision_model.indices.begin() + collision_model.object_offsets[0]);
+		a2e_debug("built collision bvh: %u nodes for %u triangles", collision_bvh_nodes.size(), triangles.size());
+	}
+	return true;
+}
+
+void obj2a2m_conversion::add_collision_sections(a2m_v3_builder& builder) {
+	a2m_buffer collision_vertices, collision_indices;
+	collision_vertices.put_vertices(collision_model.vertices.begin(), collision_model.vertices.size(), rotate_collision);
+	collision_indices.put_block(collision_model.get_indices(0), collision_model.get_triangle_count(0) * sizeof(s_index));
+	builder.add_section(A2M_V3_SECTION::COLLISION_VERTICES, move(collision_vertices), collision_model.vertices.size());
+	builder.add_section(A2M_V3_SECTION::COLLISION_INDICES, move(collision_indices), collision_model.get_triangle_count(0));
+	if(collision_bvh) {
+		a2m_buffer bvh_nodes;
+		bvh_nodes.put_block(collision_bvh_nodes.data(), collision_bvh_nodes.size() * sizeof(collision_bvh_node));
+		builder.add_section(A2M_V3_SECTION::COLLISION_BVH, move(bvh_nodes), collision_bvh_nodes.size());
+	}
+}
+
+bool obj2a2m_conversion::write_debug_obj(const string& filename) {
+	// the output is split into jobs of at most OBJ2A2M_OBJ_CHUNK_LINES lines, which are formatted in parallel
+	enum class OBJ_SECTION { HEADER, VERTICES, COORDS, FACES };
+	struct obj_job {
+		OBJ_SECTION section;
+		unsigned int object;
+		size_t first;
+		size_t count;
+	};
+	vector<obj_job> jobs;
+	const unsigned int object_count = (unsigned int)sub_objects.size();
+	const auto add_jobs = [&jobs](const OBJ_SECTION section, const unsigned int object, const size_t count) {
+		size_t first = 0;
+		do {
+			const size_t job_count = std::min(count - first, (size_t)OBJ2A2M_OBJ_CHUNK_LINES);
+			jobs.push_back(obj_job { section, object, first, job_count });
+			first += job_count;
+		} while(first < count);
+	};
+	jobs.push_back(obj_job { OBJ_SECTION::HEADER, 0, 0, object_count });
+	for(unsigned int i = 0; i < object_count; i++) {
+		if(!sub_objects[i].vertices.empty()) add_jobs(OBJ_SECTION::VERTICES, i, sub_objects[i].vertices.size());
+	}
+	for(unsigned int i = 0; i < object_count; i++) {
+		if(!sub_objects[i].coords.empty()) add_jobs(OBJ_SECTION::COORDS, i, sub_objects[i].coords.size());
+	}
+	// (every object gets at least one face job, which writes its name and material)
+	for(unsigned int i = 0; i < object_count; i++) {
+		add_jobs(OBJ_SECTION::FACES, i, sub_objects[i].vertex_indices.size());
+	}
+	
+	return write_text_chunks(filename, jobs.size(), thread_count, [this, &jobs, &object_count](const size_t job_index, obj_text_chunk& chunk) {
+		const obj_job& job = jobs[job_index];
+		const sub_object& sub_obj = sub_objects[job.object];
+		switch(job.section) {
+			case OBJ_SECTION::HEADER:
+				for(unsigned int i = 0; i < object_count; i++) {
+					chunk.put("# vc ");
+					chunk.put_uint(i);
+					chunk.put(": ");
+					chunk.put_uint((uint32_t)sub_objects[i].vertices.size());
+					chunk.put("\n# tc ");
+					chunk.put_uint(i);
+					chunk.put(": ");
+					chunk.put_uint((uint32_t)sub_objects[i].coords.size());
+					chunk.put("\n# fc ");
+					chunk.put_uint(i);
+					chunk.put(": ");
+					chunk.put_uint((uint32_t)sub_objects[i].vertex_indices.size());
+					chunk.put('\n');
+				}
+				if(object_count == 0) chunk.put('\n');
+				break;
+			case OBJ_SECTION::VERTICES:
+				chunk.reserve(job.count * 32);
+				for(size_t j = job.first; j < job.first + job.count; j++) {
+					const float3& vertex = sub_obj.vertices[j];
+					chunk.put("v ");
+					chunk.put_float(vertex.x);
+					chunk.put(' ');
+					if(!rotate_model) {
+						chunk.put_float(vertex.y);
+						chunk.put(' ');
+						chunk.put_float(vertex.z);
+					}
+					else {
+						chunk.put_float(vertex.z);
+						chunk.put(' ');
+						chunk.put_float(-vertex.y);
+					}
+					chunk.put('\n');
+				}
+				break;
+			case OBJ_SECTION::COORDS:
+				chunk.reserve(job.count * 24);
+				for(size_t j = job.first; j < job.first + job.count; j++) {
+					chunk.put("vt ");
+					chunk.put_float(sub_obj.coords[j].u);
+					chunk.put(' ');
+					chunk.put_float(sub_obj.coords[j].v);
+					chunk.put('\n');
+				}
+				break;
+			case OBJ_SECTION::FACES:
+				chunk.reserve(job.count * 48);
+				if(job.first == 0) {
+					// (no operator[] here, the maps are shared by all jobs)
+					const auto name = model.obj_names.find(job.object);
+					const auto mat = model.obj_mats.find(job.object);
+					chunk.put("g ");
+					if(name != model.obj_names.end()) chunk.put(name->second);
+					chunk.put("\nusemtl ");
+					if(mat != model.obj_mats.end()) chunk.put(mat->second);
+					chunk.put('\n');
+				}
+				for(size_t j = job.first; j < job.first + job.count; j++) {
+					chunk.put('f');
+					for(unsigned int k = 0; k < 3; k++) {
+						chunk.put(' ');
+						chunk.put_uint(sub_obj.vertex_indices[j].indices[k] + 1);
+						chunk.put('/');
+						chunk.put_uint(sub_obj.tex_indices[j].indices[k] + 1);
+					}
+					chunk.put('\n');
+				}
+				// blank line after each object, one more at the end of the file
+				if(job.first + job.count == sub_obj.vertex_indices.size()) {
+					chunk.put('\n');
+					if(job.object + 1 == object_count) chunk.put('\n');
+				}
+				break;
+		}
+	});
+}
+
+bool obj2a2m_conversion::convert_in_memory() {
+	// read and store obj data
+	a2e_debug("loading obj ...");
+	if(!load_obj_data(false, obj_filename.c_str(), model)) {
+		return false;
+	}
+	
+	if(collision_object && !load_collision_model()) {
+		return false;
+	}
+	
+	// reduce data
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	a2e_debug("reducing data ...");
+	const auto reduce_start_time = chrono::high_resolution_clock::now();
+	phase_timer reduce_timer(&stats, CONVERSION_PHASE::REDUCE);
+	object_count = model.obj_names.size();
+	sub_objects.resize(object_count);
+	
+	// all sub-objects are reduced independently -> reduce them in parallel, biggest ones first
+	vector<unsigned int> reduce_order(object_count);
+	for(unsigned int i = 0; i < object_count; i++) {
+		reduce_order[i] = i;
+	}
+	stable_sort(reduce_order.begin(), reduce_order.end(), [this](const unsigned int& obj1, const unsigned int& obj2) {
+		return (model.get_triangle_count(obj1) > model.get_triangle_count(obj2));
+	});
+	
+	atomic<size_t> welded_vertex_count { 0 };
+	vector<unique_ptr<reduce_scratch>> scratch_pool;
+	mutex scratch_pool_lock;
+	parallel_for(object_count, thread_count, [&](const size_t job) {
+		unique_ptr<reduce_scratch> scratch;
+		{
+			lock_guard<mutex> lock(scratch_pool_lock);
+			if(!scratch_pool.empty()) {
+				scratch = move(scratch_pool.back());
+				scratch_pool.pop_back();
+			}
+		}
+		if(!scratch) scratch.reset(new reduce_scratch());
+		
+		welded_vertex_count += reduce_sub_object(reduce_order[job], *scratch);
+		
+		lock_guard<mutex> lock(scratch_pool_lock);
+		scratch_pool.push_back(move(scratch));
+	});
+	scratch_pool.clear();
+	reduce_timer.stop();
+	
+	// make indices: the global vertex/coord offset of each sub-object is the vertex/coord count of all previous sub-objects
+	a2e_debug("creating new indices ...");
+	phase_timer index_timer(&stats, CONVERSION_PHASE::INDEX);
+	vector<unsigned int> vertex_offsets(object_count + 1, 0);
+	vector<unsigned int> coord_offsets(object_count + 1, 0);
+	for(unsigned int i = 0; i < object_count; i++) {
+		vertex_offsets[i + 1] = vertex_offsets[i] + (unsigned int)sub_objects[i].vertices.size();
+		coord_offsets[i + 1] = coord_offsets[i] + (unsigned int)sub_objects[i].coords.size();
+	}
+	parallel_for(object_count, thread_count, [this, &vertex_offsets, &coord_offsets](const size_t i) {
+		for(auto& triangle : sub_objects[i].vertex_indices) {
+			for(unsigned int k = 0; k < 3; k++) {
+				triangle.indices[k] += vertex_offsets[i];
+			}
+		}
+		for(auto& triangle : sub_objects[i].tex_indices) {
+			for(unsigned int k = 0; k < 3; k++) {
+				triangle.indices[k] += coord_offsets[i];
+			}
+		}
+		for(auto& lod : sub_objects[i].lods) {
+			for(auto& triangle : lod.vertex_indices) {
+				for(unsigned int k = 0; k < 3; k++) {
+					triangle.indices[k] += vertex_offsets[i];
+				}
+			}
+			for(auto& triangle : lod.tex_indices) {
+				for(unsigned int k = 0; k < 3; k++) {
+					triangle.indices[k] += coord_offsets[i];
+				}
+			}
+		}
+	});
+	index_timer.stop();
+	const double reduce_time = chrono::duration<double>(chrono::high_resolution_clock::now() - reduce_start_time).count();
+	a2e_debug("reduced data in %fs (welded %u vertices, %u KB of model data, %u KB of reduced data)", reduce_time, (size_t)welded_vertex_count,
+			  model.arena.get_allocated_size() / 1024, sub_object_arena.get_allocated_size() / 1024);
+	log_weld_stats();
+	
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	
+	// debug output to new .obj
+	if(to_obj) {
+		string debug_obj = a2m_filename.substr(0, a2m_filename.size() - 3) + "obj";
+		a2e_debug("saving to %s ...", debug_obj.c_str());
+		phase_timer write_timer(&stats, CONVERSION_PHASE::WRITE);
+		
+		if(!write_debug_obj(debug_obj)) return false;
+	}
+	
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	
+	unsigned int total_vertex_count = 0;
+	unsigned int total_coord_count = 0;
+	for(unsigned int i = 0; i < object_count; i++) {
+		total_vertex_count += sub_objects[i].vertices.size();
+		total_coord_count += sub_objects[i].coords.size();
+	}
+	
+	// convert obj data to a2m, save a2m
+	if(!to_obj) {
+		a2e_debug("saving a2m ...");
+		const auto save_start_time = chrono::high_resolution_clock::now();
+		phase_timer write_timer(&stats, CONVERSION_PHASE::WRITE);
+		
+		// serialize each section into its own buffer, these are written with a few large writes
+		vector<a2m_buffer> sections = (a2m_v3 ?
+									   make_a2m_v3_sections(total_vertex_count, total_coord_count) :
+									   make_a2m_v2_sections(total_vertex_count, total_coord_count));
+		if(!write_a2m_buffers(a2m_filename.c_str(), sections, write_mode)) {
+			return false;
+		}
+		write_timer.stop();
+		const double save_time = chrono::duration<double>(chrono::high_resolution_clock::now() - save_start_time).count();
+		size_t a2m_size = 0;
+		for(const auto& section : sections) {
+			a2m_size += section.size();
+		}
+		a2e_debug("saved %u KB in %fs (%f MB/s)", a2m_size / 1024, save_time, (save_time > 0.0 ? (double)a2m_size / save_time / (1024.0 * 1024.0) : 0.0));
+	}
+	
+	result.obj_vertex_count = model.vertices.size();
+	result.obj_coord_count = model.tex_coords.size();
+	result.triangle_count = model.indices.size();
+	result.vertex_count = total_vertex_count;
+	result.coord_count = total_coord_count;
+	return true;
+}
+
+// out-of-core conversion (-out_of_core / -memory_budget): the .obj data is streamed into spill files next to the output,
+// the sub-objects are reduced in batches of a bounded triangle count and the reduced (already encoded) data is spilled
+// again in batch order, the output is then written directly from the spill files. apart from the page cache of the
+// mapped spill files, the memory use stays within the budget. vertices that are shared by two batches of a sub-object
+// are stored once per batch.
+bool obj2a2m_conversion::convert_out_of_core() {
+	if(to_obj || compact_encoding || interleaved || compress_sections || !lod_ratios.empty()) {
+		a2e_error("-to_obj, -compact, -interleaved, -compress and -lod are not supported in out-of-core mode!");
+		return false;
+	}
+	
+	// a parse round holds worker_count blocks of text plus their parsed data, the other half of the budget is used
+	// by the batches that are reduced (or wait for their turn to be spilled) at the same time
+	const size_t budget = (size_t)memory_budget * 1024u * 1024u;
+	const size_t worker_count = std::max(thread_count, 1u);
+	const size_t block_size = std::min(std::max(budget / (worker_count * 8), (size_t)OBJ2A2M_MIN_BLOCK_SIZE), (size_t)OBJ2A2M_MAX_BLOCK_SIZE);
+	const size_t batch_triangle_count = std::max(budget / (2 * worker_count * OBJ2A2M_BATCH_TRIANGLE_SIZE), (size_t)OBJ2A2M_MIN_BATCH_TRIANGLE_COUNT);
+	a2e_debug("out-of-core conversion: %u MB memory budget, %u KB blocks, %u triangles per batch",
+			  memory_budget, block_size / 1024, batch_triangle_count);
+	
+	// stream the obj data into spill files
+	a2e_debug("loading obj ...");
+	obj_spill_model spill_model;
+	if(!spill_model.open(a2m_filename + ".spill") ||
+	   !load_obj_data_streamed(false, join_mat_objects, thread_count, block_size, obj_filename.c_str(), mtllib, spill_model, &stats)) {
+		return false;
+	}
+	model.obj_names = spill_model.obj_names;
+	model.obj_mats = spill_model.obj_mats;
+	object_count = model.obj_names.size();
+	
+	if(collision_object && !load_collision_model()) {
+		return false;
+	}
+	
+	// reduce data
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	struct reduce_batch {
+		unsigned int object;
+		size_t first_triangle;
+		size_t triangle_count;
+	};
+	vector<reduce_batch> batches;
+	vector<size_t> object_first_triangles(object_count, 0);
+	for(unsigned int i = 0; i < object_count; i++) {
+		const size_t triangle_count = spill_model.object_triangle_counts[i];
+		if(i + 1 < object_count) object_first_triangles[i + 1] = object_first_triangles[i] + triangle_count;
+		for(size_t first = 0; first < triangle_count; first += batch_triangle_count) {
+			batches.push_back(reduce_batch { i, first, std::min(batch_triangle_count, triangle_count - first) });
+		}
+	}
+	a2e_debug("reducing data (%u batches) ...", batches.size());
+	const auto reduce_start_time = chrono::high_resolution_clock::now();
+	phase_timer reduce_timer(&stats, CONVERSION_PHASE::REDUCE);
+	
+	spill_file reduced_vertices, reduced_coords, reduced_indices, reduced_tex_indices;
+	if(!reduced_vertices.open(a2m_filename + ".spill.reduced_vertices") ||
+	   !reduced_coords.open(a2m_filename + ".spill.reduced_tex_coords") ||
+	   !reduced_indices.open(a2m_filename + ".spill.reduced_indices") ||
+	   !reduced_tex_indices.open(a2m_filename + ".spill.reduced_tex_indices")) {
+		return false;
+	}
+	
+	const float3* vertices = (const float3*)spill_model.vertices.data();
+	const coord* tex_coords = (const coord*)spill_model.tex_coords.data();
+	atomic<size_t> welded_vertex_count { 0 };
+	vector<unique_ptr<reduce_scratch>> scratch_pool;
+	mutex scratch_pool_lock;
+	// the batches are spilled in order, each one once all previous batches have been spilled
+	mutex spill_lock;
+	condition_variable spill_cv;
+	size_t next_spill_batch = 0;
+	unsigned int vertex_offset = 0, coord_offset = 0;
+	bool spill_failed = false;
+	parallel_for(batches.size(), thread_count, [&](const size_t job) {
+		const reduce_batch& batch = batches[job];
+		unique_ptr<reduce_scratch> scratch;
+		{
+			lock_guard<mutex> lock(scratch_pool_lock);
+			if(!scratch_pool.empty()) {
+				scratch = move(scratch_pool.back());
+				scratch_pool.pop_back();
+			}
+		}
+		if(!scratch) scratch.reset(new reduce_scratch());
+		
+		mesh_arena batch_arena;
+		sub_object batch_obj;
+		{
+			vector<s_index> indices(batch.triangle_count), tex_indices(batch.triangle_count);
+			spill_model.get_triangles(batch.object, batch.first_triangle, batch.triangle_count, indices.data(), tex_indices.data());
+			welded_vertex_count += reduce_triangles(batch.object, indices.data(), tex_indices.data(), batch.triangle_count,
+													vertices, tex_coords, batch_obj, batch_arena, *scratch);
+		}
+		{
+			lock_guard<mutex> lock(scratch_pool_lock);
+			scratch_pool.push_back(move(scratch));
+		}
+		
+		a2m_buffer vertex_data, coord_data, index_data, tex_index_data;
+		vertex_data.put_vertices(batch_obj.vertices.begin(), batch_obj.vertices.size(), rotate_model);
+		coord_data.put_floats((const float*)batch_obj.coords.begin(), batch_obj.coords.size() * 2);
+		
+		// parallel_for hands out the batches in order, so all previous batches are already being processed
+		unique_lock<mutex> lock(spill_lock);
+		spill_cv.wait(lock, [&next_spill_batch, &job] { return (next_spill_batch == job); });
+		phase_timer index_timer(&stats, CONVERSION_PHASE::INDEX);
+		for(auto& triangle : batch_obj.vertex_indices) {
+			for(unsigned int k = 0; k < 3; k++) {
+				triangle.indices[k] += vertex_offset;
+			}
+		}
+		for(auto& triangle : batch_obj.tex_indices) {
+			for(unsigned int k = 0; k < 3; k++) {
+				triangle.indices[k] += coord_offset;
+			}
+		}
+		// v3 indices are stored little endian, v2 indices big endian
+		if(a2m_v3) {
+			index_data.put_block(batch_obj.vertex_indices.begin(), batch_obj.vertex_indices.size() * sizeof(s_index));
+			tex_index_data.put_block(batch_obj.tex_indices.begin(), batch_obj.tex_indices.size() * sizeof(s_index));
+		}
+		else {
+			index_data.put_uints((const unsigned int*)batch_obj.vertex_indices.begin(), batch_obj.vertex_indices.size() * 3);
+			tex_index_data.put_uints((const unsigned int*)batch_obj.tex_indices.begin(), batch_obj.tex_indices.size() * 3);
+		}
+		index_timer.stop();
+		if(a2m_v3) add_culling_data(batch.object, batch_obj, object_first_triangles[batch.object] + batch.first_triangle);
+		if(!reduced_vertices.append(vertex_data.data(), vertex_data.size()) ||
+		   !reduced_coords.append(coord_data.data(), coord_data.size()) ||
+		   !reduced_indices.append(index_data.data(), index_data.size()) ||
+		   !reduced_tex_indices.append(tex_index_data.data(), tex_index_data.size())) {
+			spill_failed = true;
+		}
+		vertex_offset += (unsigned int)batch_obj.vertices.size();
+		coord_offset += (unsigned int)batch_obj.coords.size();
+		next_spill_batch++;
+		spill_cv.notify_all();
+	});
+	scratch_pool.clear();
+	if(spill_failed ||
+	   !reduced_vertices.finish() || !reduced_coords.finish() ||
+	   !reduced_indices.finish() || !reduced_tex_indices.finish()) {
+		return false;
+	}
+	const unsigned int total_vertex_count = vertex_offset;
+	const unsigned int total_coord_count = coord_offset;
+	reduce_timer.stop();
+	const double reduce_time = chrono::duration<double>(chrono::high_resolution_clock::now() - reduce_start_time).count();
+	a2e_debug("reduced data in %fs (welded %u vertices, %u KB of reduced data)", reduce_time, (size_t)welded_vertex_count,
+			  (reduced_vertices.size() + reduced_coords.size() + reduced_indices.size() + reduced_tex_indices.size()) / 1024);
+	log_weld_stats();
+	
+	// the obj data isn't needed any more
+	spill_model.vertices.close();
+	spill_model.tex_coords.close();
+	spill_model.triangles.close();
+	
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	
+	// the small sections are built in memory, the large ones are written directly from the spill files
+	a2e_debug("saving a2m ...");
+	const auto save_start_time = chrono::high_resolution_clock::now();
+	phase_timer write_timer(&stats, CONVERSION_PHASE::WRITE);
+	vector<a2m_buffer> buffers;
+	vector<a2m_block> blocks;
+	if(a2m_v3) {
+		a2m_v3_builder builder;
+		builder.add_external_section(A2M_V3_SECTION::VERTICES, reduced_vertices.size(), total_vertex_count);
+		builder.add_external_section(A2M_V3_SECTION::TEX_COORDS, reduced_coords.size(), total_coord_count);
+		
+		a2m_buffer objects, strings;
+		size_t triangle_count = 0;
+		for(unsigned int i = 0; i < object_count; i++) {
+			const string& name = model.obj_names[i];
+			const a2m_v3_object object {
+				(uint32_t)strings.size(), (uint32_t)name.size(),
+				(uint32_t)triangle_count, (uint32_t)spill_model.object_triangle_counts[i]
+			};
+			objects.put_block(&object, sizeof(a2m_v3_object));
+			strings.put_terminated_block(name, 0);
+			triangle_count += spill_model.object_triangle_counts[i];
+		}
+		builder.add_section(A2M_V3_SECTION::OBJECTS, move(objects), object_count);
+		builder.add_external_section(A2M_V3_SECTION::INDICES, reduced_indices.size(), triangle_count);
+		builder.add_external_section(A2M_V3_SECTION::TEX_INDICES, reduced_tex_indices.size(), triangle_count);
+		builder.add_section(A2M_V3_SECTION::STRINGS, move(strings), object_count);
+		add_culling_sections(builder);
+		
+		if(collision_object) add_collision_sections(builder);
+		
+		vector<size_t> external_buffers;
+		buffers = builder.finish(collision_object ? A2M_V3_FLAG_COLLISION : 0x00, &external_buffers);
+		const spill_file* external_files[] { &reduced_vertices, &reduced_coords, &reduced_indices, &reduced_tex_indices };
+		size_t external_index = 0;
+		for(size_t i = 0; i < buffers.size(); i++) {
+			if(external_index < external_buffers.size() && external_buffers[external_index] == i) {
+				const spill_file* file = external_files[external_index++];
+				blocks.push_back(a2m_block { file->data(), file->size() });
+			}
+			else blocks.push_back(a2m_block { buffers[i].data(), buffers[i].size() });
+		}
+	}
+	else {
+		// see make_a2m_v2_sections: header, vertices, texture coordinates, object names, indices per object, collision model
+		buffers.resize(3 + object_count);
+		a2m_buffer& header = buffers[0];
+		header.put_block("A2EMODEL", 8);
+		header.put_uint(A2M_VERSION);
+		header.put_char(collision_object ? 0x02 : 0x00);
+		header.put_uint(total_vertex_count);
+		header.put_uint(total_coord_count);
+		
+		a2m_buffer& objects = buffers[1];
+		objects.put_uint(object_count);
+		for(const auto& name : model.obj_names) {
+			objects.put_terminated_block(name.second, 0xFF);
+		}
+		
+		blocks.push_back(a2m_block { header.data(), header.size() });
+		blocks.push_back(a2m_block { reduced_vertices.data(), reduced_vertices.size() });
+		blocks.push_back(a2m_block { reduced_coords.data(), reduced_coords.size() });
+		blocks.push_back(a2m_block { objects.data(), objects.size() });
+		size_t index_offset = 0;
+		for(unsigned int i = 0; i < object_count; i++) {
+			const size_t triangle_count = spill_model.object_triangle_counts[i];
+			a2m_buffer& index_count = buffers[3 + i];
+			index_count.put_uint((unsigned int)triangle_count);
+			blocks.push_back(a2m_block { index_count.data(), index_count.size() });
+			blocks.push_back(a2m_block { reduced_indices.data() + index_offset, triangle_count * sizeof(s_index) });
+			blocks.push_back(a2m_block { reduced_tex_indices.data() + index_offset, triangle_count * sizeof(s_index) });
+			index_offset += triangle_count * sizeof(s_index);
+		}
+		
+		if(collision_object) {
+			a2m_buffer& collision = buffers[2];
+			collision.put_uint((unsigned int)collision_model.vertices.size());
+			collision.put_vertices(collision_model.vertices.begin(), collision_model.vertices.size(), rotate_collision);
+			collision.put_uint((unsigned int)collision_model.get_triangle_count(0));
+			collision.put_uints((const unsigned int*)collision_model.get_indices(0), collision_model.get_triangle_count(0) * 3);
+			blocks.push_back(a2m_block { collision.data(), collision.size() });
+		}
+	}
+	if(!write_a2m_blocks(a2m_filename.c_str(), blocks, write_mode)) {
+		return false;
+	}
+	write_timer.stop();
+	const double save_time = chrono::duration<double>(chrono::high_resolution_clock::now() - save_start_time).count();
+	size_t a2m_size = 0;
+	for(const auto& block : blocks) {
+		a2m_size += block.size;
+	}
+	a2e_debug("saved %u KB in %fs (%f MB/s)", a2m_size / 1024, save_time, (save_time > 0.0 ? (double)a2m_size / save_time / (1024.0 * 1024.0) : 0.0));
+	
+	result.obj_vertex_count = spill_model.vertex_count;
+	result.obj_coord_count = spill_model.coord_count;
+	result.triangle_count = spill_model.triangle_count;
+	result.vertex_count = total_vertex_count;
+	result.coord_count = total_coord_count;
+	return true;
+}
+
+bool parse_conversion_args(const vector<string>& args, conversion_options& options, vector<string>& filenames) {
+	for(size_t i = 0; i < args.size(); i++) {
+		if(args[i] == "-rotate") {
+			options.rotate_obj = true;
+			options.rotate_model = true;
+			options.rotate_collision = true;
+		}
+		else if(args[i] == "-rotate_model") {
+			options.rotate_model = true;
+		}
+		else if(args[i] == "-rotate_collision") {
+			options.rotate_collision = true;
+		}
+		else if(args[i] == "-to_obj") {
+			options.to_obj = true;
+		}
+		else if(args[i] == "-collision") {
+			if(++i < args.size()) {
+				options.collision_filename = args[i];
+				options.collision_object = true;
+			}
+		}
+		else if(args[i] == "-join_mat_objects") {
+			options.join_mat_objects = true;
+		}
+		else if(args[i] == "-mat_mapping") {
+			options.mat_mapping = true;
+		}
+		else if(args[i] == "-mmap") {
+			options.mapped_obj = true;
+		}
+		else if(args[i] == "-threads") {
+			if(++i < args.size()) {
+				options.thread_count = std::max(string2uint(args[i]), 1u);
+			}
+		}
+		else if(args[i] == "-collision_bvh") {
+			// only available in the v3 format
+			options.collision_bvh = true;
+			options.a2m_v3 = true;
+		}
+		else if(args[i] == "-compact") {
+			// only available in the v3 format
+			options.compact_encoding = true;
+			options.a2m_v3 = true;
+		}
+		else if(args[i] == "-interleaved") {
+			// only available in the v3 format
+			options.interleaved = true;
+			options.a2m_v3 = true;
+		}
+		else if(args[i] == "-normals") {
+			// only available in the interleaved v3 format
+			options.normals = true;
+			options.interleaved = true;
+			options.a2m_v3 = true;
+		}
+		else if(args[i] == "-tangents") {
+			// only available in the interleaved v3 format
+			options.tangents = true;
+			options.normals = true;
+			options.interleaved = true;
+			options.a2m_v3 = true;
+		}
+		else if(args[i] == "-compress") {
+			// only available in the v3 format
+			options.compress_sections = true;
+			options.a2m_v3 = true;
+		}
+		else if(args[i] == "-optimize_cache") {
+			options.optimize_cache = true;
+		}
+		else if(args[i] == "-meshlets") {
+			// only available in the v3 format
+			options.meshlets = true;
+			options.a2m_v3 = true;
+		}
+		else if(args[i] == "-lod") {
+			// only available in the v3 format
+			if(++i < args.size()) {
+				options.lod_ratios.clear();
+				stringstream ratios(args[i]);
+				string ratio;
+				while(getline(ratios, ratio, ',')) {
+					const float value = string2float(ratio);
+					if(!(value > 0.0f && value < 1.0f) || (!options.lod_ratios.empty() && value >= options.lod_ratios.back())) {
+						a2e_error("invalid lod ratios \"%s\" (must be decreasing and between 0 and 1)!", args[i]);
+						return false;
+					}
+					options.lod_ratios.push_back(value);
+				}
+				options.a2m_v3 = true;
+			}
+		}
+		else if(args[i] == "-out_of_core") {
+			options.out_of_core = true;
+		}
+		else if(args[i] == "-memory_budget") {
+			if(++i < args.size()) {
+				options.memory_budget = std::max(string2uint(args[i]), 1u);
+				options.out_of_core = true;
+			}
+		}
+		else if(args[i] == "-incremental") {
+			options.incremental = true;
+		}
+		else if(args[i] == "-force") {
+			options.force = true;
+		}
+		else if(args[i] == "-stats" || args[i] == "--stats=text") {
+			options.stats_output = STATS_OUTPUT::TEXT;
+		}
+		else if(args[i] == "--stats=json") {
+			options.stats_output = STATS_OUTPUT::JSON;
+		}
+		else if(args[i] == "-verify") {
+			options.verify = true;
+		}
+		else if(args[i] == "-a2m_v3") {
+			options.a2m_v3 = true;
+		}
+		else if(args[i] == "-write_mode") {
+			if(++i < args.size()) {
+				if(args[i] == "buffered") options.write_mode = A2M_WRITE_MODE::BUFFERED;
+				else if(args[i] == "writev") options.write_mode = A2M_WRITE_MODE::WRITEV;
+				else if(args[i] == "mmap") options.write_mode = A2M_WRITE_MODE::MMAP;
+				else {
+					a2e_error("unknown write mode \"%s\"!", args[i]);
+					return false;
+				}
+			}
+		}
+		else filenames.push_back(args[i]);
+	}
+	return true;
+}
+
+string make_options_string(const conversion_options& options) {
+	// outputs of a different obj2a2m version are always converted again
+	stringstream str;
+	str << "v" << OBJ2A2M_MAJOR_VERSION << "." << OBJ2A2M_MINOR_VERSION << "." << OBJ2A2M_REVISION_VERSION;
+	if(options.rotate_model) str << " -rotate_model";
+	if(options.rotate_collision) str << " -rotate_collision";
+	if(options.collision_object) str << " -collision";
+	if(options.collision_bvh) str << " -collision_bvh";
+	if(options.join_mat_objects) str << " -join_mat_objects";
+	if(options.mat_mapping) str << " -mat_mapping";
+	if(options.a2m_v3) str << " -a2m_v3";
+	if(options.compact_encoding) str << " -compact";
+	if(options.interleaved) str << " -interleaved";
+	if(options.normals) str << " -normals";
+	if(options.tangents) str << " -tangents";
+	if(options.compress_sections) str << " -compress";
+	if(options.optimize_cache) str << " -optimize_cache";
+	if(options.meshlets) str << " -meshlets";
+	if(!options.lod_ratios.empty()) {
+		str << " -lod ";
+		for(size_t i = 0; i < options.lod_ratios.size(); i++) {
+			str << (i > 0 ? "," : "") << options.lod_ratios[i];
+		}
+	}
+	// the batch size depends on the memory budget (and the thread count)
+	if(options.out_of_core) str << " -out_of_core " << options.memory_budget << "/" << options.thread_count;
+	return str.str();
+}
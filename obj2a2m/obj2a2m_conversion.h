@@ -0,0 +1,229 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2010 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_CONVERSION_H__
+#define __OBJ2A2M_CONVERSION_H__
+
+#define A2M_VERSION 2
+
+// the version is part of the -incremental manifest entries (see make_options_string): bump the revision whenever the
+// output of unchanged options changes, so that outdated outputs are converted again
+#define OBJ2A2M_MAJOR_VERSION 0
+#define OBJ2A2M_MINOR_VERSION 3
+#define OBJ2A2M_REVISION_VERSION 6
+#define OBJ2A2M_BUILT_TIME __TIME__
+#define OBJ2A2M_BUILT_DATE __DATE__
+
+// out-of-core mode: default memory budget (in MB), the bounds of the size of the parsed .obj blocks
+// and the estimated amount of memory that is needed per triangle of a reduced batch
+#define OBJ2A2M_DEFAULT_MEMORY_BUDGET 1024
+#define OBJ2A2M_MIN_BLOCK_SIZE (1024u * 1024u)
+#define OBJ2A2M_MAX_BLOCK_SIZE (64u * 1024u * 1024u)
+#define OBJ2A2M_BATCH_TRIANGLE_SIZE 512u
+#define OBJ2A2M_MIN_BATCH_TRIANGLE_COUNT 4096u
+
+// -to_obj: max amount of lines that are formatted per chunk
+#define OBJ2A2M_OBJ_CHUNK_LINES 65536u
+
+#include <a2e.h>
+#include "obj_parser.h"
+#include "gz_stream.h"
+#include "parallel.h"
+#include "vertex_weld.h"
+#include "coord_dedup.h"
+#include "a2m_writer.h"
+#include "a2m_v3.h"
+#include "a2m_compact.h"
+#include "a2m_interleaved.h"
+#include "vertex_cache.h"
+#include "conversion_manifest.h"
+#include "conversion_stats.h"
+#include "a2m_reader.h"
+#include "a2m_verify.h"
+#include "obj_writer.h"
+#include "collision_bvh.h"
+#include "mesh_bounds.h"
+#include "meshlets.h"
+#include "mesh_simplify.h"
+#include "mesh_normals.h"
+#include <chrono>
+#include <iomanip>
+
+// simplified triangles of a sub-object (-lod), indexing the vertices and texture coordinates of the sub-object
+// (with -interleaved, vertex_indices are replaced by global interleaved vertex indices, see add_interleaved_sections)
+struct sub_object_lod {
+	vector<s_index> vertex_indices;
+	vector<s_index> tex_indices;
+	float error = 0.0f; // see mesh_simplifier::get_error
+};
+
+// reduced sub-object data (allocated from sub_object_arena)
+struct sub_object {
+	arena_array<float3> vertices;
+	arena_array<coord> coords;
+	// -normals: normal of each texture coordinate (coordinates are split where the normals of their corners differ,
+	// so that the texture coordinate indices determine the normals as well)
+	arena_array<float3> normals;
+	// vertex and texture coordinate indices of each triangle
+	arena_array<s_index> vertex_indices;
+	arena_array<s_index> tex_indices;
+	// -meshlets (the triangles above are in meshlet order)
+	vector<meshlet> meshlets;
+	// -lod (one entry per lod ratio)
+	vector<sub_object_lod> lods;
+};
+
+// temporary data of reduce_sub_object (reused for all sub-objects that are reduced by the same task)
+struct reduce_scratch {
+	coord_dedup_table data_table;
+	vector<float3> vertices;
+	vector<coord> coords;
+	vector<unsigned int> coord_sources; // .obj index of each coord
+	vector<unsigned int> vertex_order;
+	vector<float3> sorted_vertices;
+	vector<unsigned int> vertex_remap;
+	vector<unsigned int> sorted_remap;
+	// -normals
+	vector<float3> corner_normals;
+	vector<coord> normal_coords;
+	vector<float3> coord_normals;
+	vector<unsigned int> coord_links;
+	vector<unsigned int> normal_coord_links;
+};
+
+
+// conversion statistics output (-stats / --stats=text|json)
+enum class STATS_OUTPUT : unsigned int {
+	NONE,
+	TEXT,	// logged as a table
+	JSON,	// written to <output>.stats.json
+};
+
+// options of a single conversion (from the command line, or per file in batch mode)
+struct conversion_options {
+	bool rotate_obj = false;
+	bool rotate_model = false;
+	bool rotate_collision = false;
+	bool collision_object = false;
+	bool collision_bvh = false;
+	bool to_obj = false;
+	bool join_mat_objects = false;
+	bool mat_mapping = false;
+	bool mapped_obj = false;
+	unsigned int thread_count = default_thread_count();
+	A2M_WRITE_MODE write_mode = A2M_WRITE_MODE::BUFFERED;
+	bool a2m_v3 = false;
+	bool compact_encoding = false;
+	bool interleaved = false;
+	bool normals = false;
+	bool tangents = false;
+	bool compress_sections = false;
+	bool optimize_cache = false;
+	bool meshlets = false;
+	// -lod: decreasing target triangle ratios of the lod chain
+	vector<float> lod_ratios;
+	bool out_of_core = false;
+	unsigned int memory_budget = OBJ2A2M_DEFAULT_MEMORY_BUDGET;
+	bool incremental = false;
+	bool force = false;
+	STATS_OUTPUT stats_output = STATS_OUTPUT::NONE;
+	bool verify = false;
+	
+	string obj_filename = "";
+	string collision_filename = "";
+	string a2m_filename = "";
+};
+
+// parses the options in args (command line syntax), everything that isn't an option is added to filenames
+bool parse_conversion_args(const vector<string>& args, conversion_options& options, vector<string>& filenames);
+
+// canonical string of all options that affect the output (recorded in the manifest)
+string make_options_string(const conversion_options& options);
+
+// statistics of a finished conversion (batch mode summary)
+struct conversion_result {
+	bool success = false;
+	// output was up-to-date
+	bool skipped = false;
+	double time = 0.0;
+	size_t triangle_count = 0;
+	size_t obj_vertex_count = 0;
+	size_t obj_coord_count = 0;
+	size_t vertex_count = 0;
+	size_t coord_count = 0;
+};
+
+// converts a single .obj file (all conversion state lives here, so that multiple conversions can run concurrently)
+class obj2a2m_conversion : public conversion_options {
+public:
+	obj2a2m_conversion(const conversion_options& options) : conversion_options(options) {}
+	
+	bool convert();
+	const conversion_result& get_result() const { return result; }
+	const conversion_stats& get_stats() const { return stats; }
+	
+protected:
+	unsigned int object_count = 0;
+	string mtllib = "";
+	
+	obj_model model;
+	obj_model collision_model;
+	// -collision_bvh (the collision triangles are reordered into leaf order when it is built)
+	vector<collision_bvh_node> collision_bvh_nodes;
+	vector<sub_object> sub_objects;
+	mesh_arena sub_object_arena;
+	// v3 culling data (OBJECT_BOUNDS and MESHLETS sections), see add_culling_data
+	vector<a2m_v3_object_bounds> object_bounds;
+	vector<bool> object_has_bounds;
+	vector<a2m_v3_meshlet> object_meshlets;
+	
+	conversion_result result;
+	conversion_stats stats;
+	
+	void log_stats() const;
+	void log_weld_stats() const;
+	bool write_stats_json() const;
+	bool is_up_to_date(const conversion_manifest& manifest, conversion_manifest::entry& output_entry);
+	bool convert_in_memory();
+	bool convert_out_of_core();
+	bool load_collision_model();
+	void add_collision_sections(a2m_v3_builder& builder);
+	bool verify_output();
+	bool write_debug_obj(const string& filename);
+	bool load_obj_data(bool collision_obj, const char* filename, obj_model& model);
+	void create_mat_mapping();
+	size_t reduce_sub_object(const unsigned int object, reduce_scratch& scratch);
+	size_t reduce_triangles(const unsigned int object, const s_index* indices, const s_index* tex_indices, const size_t triangle_count,
+							const float3* vertices, const coord* tex_coords, sub_object& sub_obj, mesh_arena& arena, reduce_scratch& scratch,
+							const s_index* normal_indices = nullptr, const unsigned int* smoothing_groups = nullptr);
+	void add_sub_object_normals(const s_index* normal_indices, const unsigned int* smoothing_groups, sub_object& sub_obj,
+								mesh_arena& arena, reduce_scratch& scratch);
+	vector<a2m_buffer> make_a2m_v2_sections(const unsigned int total_vertex_count, const unsigned int total_coord_count);
+	void add_culling_data(const unsigned int object, const sub_object& sub_obj, const size_t first_triangle);
+	void add_culling_sections(a2m_v3_builder& builder);
+	void add_lod_sections(a2m_v3_builder& builder);
+	void add_interleaved_sections(a2m_v3_builder& builder);
+	void add_compact_sections(a2m_v3_builder& builder, const unsigned int total_vertex_count, const unsigned int total_coord_count);
+	vector<a2m_buffer> make_a2m_v3_sections(const unsigned int total_vertex_count, const unsigned int total_coord_count);
+	
+	obj2a2m_conversion(const obj2a2m_conversion&) = delete;
+	obj2a2m_conversion& operator=(const obj2a2m_conversion&) = delete;
+	
+};
+
+#endif
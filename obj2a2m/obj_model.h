@@ -0,0 +1,79 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_OBJ_MODEL_H__
+#define __OBJ2A2M_OBJ_MODEL_H__
+
+#include <a2e.h>
+#include "mesh_arena.h"
+
+struct s_index {
+	unsigned int indices[3];
+};
+
+// the data of a loaded .obj file, stored in contiguous arrays that are allocated from the model arena
+struct obj_model {
+	mesh_arena arena;
+	
+	arena_array<float3> vertices;
+	arena_array<coord> tex_coords;
+	
+	// triangles (vertex and texture coordinate indices) of all sub-objects, ordered by sub-object:
+	// the triangles of sub-object i are [object_offsets[i], object_offsets[i + 1])
+	arena_array<s_index> indices;
+	arena_array<s_index> tex_indices;
+	vector<size_t> object_offsets { 0 };
+	
+	// only if normals were loaded (see load_obj_data_mapped): the .obj normals, the normal indices of each triangle
+	// (~0u if a corner has none) and the smoothing group of each triangle (0 = "s off"), in the same order as indices
+	arena_array<float3> normals;
+	arena_array<s_index> normal_indices;
+	arena_array<unsigned int> smoothing_groups;
+	
+	map<unsigned int, string> obj_names;
+	map<unsigned int, string> obj_mats;
+	
+	size_t get_triangle_count(const unsigned int object) const {
+		return object_offsets[object + 1] - object_offsets[object];
+	}
+	const s_index* get_indices(const unsigned int object) const {
+		return indices.begin() + object_offsets[object];
+	}
+	const s_index* get_tex_indices(const unsigned int object) const {
+		return tex_indices.begin() + object_offsets[object];
+	}
+	const s_index* get_normal_indices(const unsigned int object) const {
+		return (normal_indices.empty() ? nullptr : normal_indices.begin() + object_offsets[object]);
+	}
+	const unsigned int* get_smoothing_groups(const unsigned int object) const {
+		return (smoothing_groups.empty() ? nullptr : smoothing_groups.begin() + object_offsets[object]);
+	}
+	
+	// allocates the triangle arrays for the given per sub-object triangle counts
+	void alloc_triangles(const vector<size_t>& object_triangle_counts) {
+		object_offsets.assign(1, 0);
+		for(const auto& count : object_triangle_counts) {
+			object_offsets.push_back(object_offsets.back() + count);
+		}
+		indices = arena_array<s_index>(arena, object_offsets.back());
+		tex_indices = arena_array<s_index>(arena, object_offsets.back());
+	}
+	
+};
+
+#endif
@@ -0,0 +1,412 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_OBJ_NUMBER_H__
+#define __OBJ2A2M_OBJ_NUMBER_H__
+
+#include <a2e.h>
+#include <cfloat>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OBJ_NUMBER_SSE2 1
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// number parsing straight from a (not 0-terminated) byte range:
+// all functions parse at cur, never read at or beyond end and advance cur behind the parsed number.
+// floats are parsed exactly (the result is always the same as the one of strtof), numbers that can't be
+// handled by the fast path (too many digits, huge exponents, inf/nan, ...) are handed to strtof.
+// the format_* functions are the counterpart used by the .obj writer: they write into a caller-provided buffer
+// and return the amount of written characters (no 0-terminator is written).
+namespace obj_number {
+	
+	inline bool is_digit(const char ch) {
+		return ((unsigned char)(ch - '0') < 10);
+	}
+
+#if defined(OBJ_NUMBER_SSE2)
+	inline unsigned int count_trailing_zeros(const unsigned int mask) {
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return (unsigned int)index;
+#else
+		return (unsigned int)__builtin_ctz(mask);
+#endif
+	}
+	
+	// converts 8 ascii digits into their value (little endian swar)
+	inline uint32_t parse_eight_digits(const char* digits) {
+		uint64_t val;
+		memcpy(&val, digits, sizeof(uint64_t));
+		val -= 0x3030303030303030ULL;
+		val = (val * 10) + (val >> 8);
+		val = (((val & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+			   (((val >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+		return (uint32_t)val;
+	}
+#endif
+	
+	// returns the amount of consecutive digits at cur (16 characters are classified at once if possible)
+	inline size_t digit_run(const char* cur, const char* end) {
+		const char* start = cur;
+#if defined(OBJ_NUMBER_SSE2)
+		const __m128i zero_chars = _mm_set1_epi8('0');
+		const __m128i nine = _mm_set1_epi8(9);
+		while(end - cur >= 16) {
+			const __m128i chars = _mm_sub_epi8(_mm_loadu_si128((const __m128i*)cur), zero_chars);
+			// (unsigned) ch - '0' <= 9
+			const unsigned int digit_mask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(chars, nine), chars));
+			if(digit_mask != 0xFFFF) {
+				return (size_t)(cur - start) + count_trailing_zeros(~digit_mask);
+			}
+			cur += 16;
+		}
+#endif
+		while(cur < end && is_digit(*cur)) cur++;
+		return (size_t)(cur - start);
+	}
+	
+	// appends count digits to value (the caller must make sure this doesn't overflow)
+	inline uint64_t accumulate_digits(uint64_t value, const char* digits, size_t count) {
+#if defined(OBJ_NUMBER_SSE2)
+		for(; count >= 8; count -= 8, digits += 8) {
+			value = value * 100000000ULL + parse_eight_digits(digits);
+		}
+#endif
+		for(; count > 0; count--, digits++) {
+			value = value * 10 + (uint64_t)(*digits - '0');
+		}
+		return value;
+	}
+	
+	// parses a (signed) decimal integer, returns false if there is no number at cur
+	inline bool parse_int(const char*& cur, const char* end, int& value) {
+		const char* ptr = cur;
+		bool negative = false;
+		if(ptr < end && (*ptr == '-' || *ptr == '+')) {
+			negative = (*ptr == '-');
+			ptr++;
+		}
+		const size_t digit_count = digit_run(ptr, end);
+		if(digit_count == 0) return false;
+		
+		// clamp anything that doesn't fit into an int (no valid .obj index is this large anyway)
+		const uint64_t abs_value = (digit_count <= 10 ? accumulate_digits(0, ptr, digit_count) : 0x7FFFFFFFULL);
+		value = (int)(abs_value < 0x7FFFFFFFULL ? abs_value : 0x7FFFFFFFULL);
+		if(negative) value = -value;
+		cur = ptr + digit_count;
+		return true;
+	}
+	
+	// strtof on a copy of the whole number token (up to the next whitespace), used for everything the fast path can't
+	// handle exactly. short tokens are copied to the stack, longer ones (e.g. many leading zeros) to a string
+	inline bool parse_float_fallback(const char*& cur, const char* end, float& value) {
+		const char* token_end = cur;
+		while(token_end < end && !isspace((unsigned char)*token_end)) token_end++;
+		const size_t len = (size_t)(token_end - cur);
+		if(len == 0) return false;
+		
+		char num_buffer[64];
+		string long_num;
+		char* num_str = num_buffer;
+		if(len < sizeof(num_buffer)) {
+			memcpy(num_buffer, cur, len);
+			num_buffer[len] = 0;
+		}
+		else {
+			long_num.assign(cur, len);
+			num_str = &long_num[0];
+		}
+		char* num_end = nullptr;
+		value = strtof(num_str, &num_end);
+		if(num_end == num_str) return false;
+		cur += (num_end - num_str);
+		return true;
+	}
+	
+	// true if the double lies exactly in the middle of two adjacent (normal) floats,
+	// this is the only case in which rounding the correctly rounded double to float can differ from rounding the exact value
+	inline bool is_float_midpoint(const double val) {
+		uint64_t bits;
+		memcpy(&bits, &val, sizeof(uint64_t));
+		return ((bits & 0x1FFFFFFFULL) == 0x10000000ULL);
+	}
+	
+	// parses a decimal float ("-1", "0.25", ".5", "1.5e-3", ...), returns false if there is no number at cur
+	inline bool parse_float(const char*& cur, const char* end, float& value) {
+		static const double pow10[] {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+		};
+		
+		const char* ptr = cur;
+		bool negative = false;
+		if(ptr < end && (*ptr == '-' || *ptr == '+')) {
+			negative = (*ptr == '-');
+			ptr++;
+		}
+		
+		// integer part
+		const size_t int_digit_count = digit_run(ptr, end);
+		const char* digits = ptr;
+		size_t digit_count = int_digit_count;
+		while(digit_count > 0 && *digits == '0') {
+			digits++;
+			digit_count--;
+		}
+		// at most 19 significant digits fit into the 64-bit mantissa
+		if(digit_count > 19) return parse_float_fallback(cur, end, value);
+		uint64_t mantissa = accumulate_digits(0, digits, digit_count);
+		size_t significant_digits = digit_count;
+		int exponent = 0;
+		ptr += int_digit_count;
+		
+		// fractional part
+		size_t frac_digit_count = 0;
+		if(ptr < end && *ptr == '.') {
+			ptr++;
+			frac_digit_count = digit_run(ptr, end);
+			digits = ptr;
+			digit_count = frac_digit_count;
+			// trailing zeros don't change the value, leading zeros don't need to be accumulated
+			while(digit_count > 0 && digits[digit_count - 1] == '0') digit_count--;
+			if(mantissa == 0) {
+				while(digit_count > 0 && *digits == '0') {
+					digits++;
+					digit_count--;
+				}
+			}
+			significant_digits += digit_count;
+			if(significant_digits > 19) return parse_float_fallback(cur, end, value);
+			mantissa = accumulate_digits(mantissa, digits, digit_count);
+			exponent = -(int)((digits + digit_count) - ptr);
+			ptr += frac_digit_count;
+		}
+		
+		// no digits at all: "inf", "nan" or no number
+		if(int_digit_count == 0 && frac_digit_count == 0) return parse_float_fallback(cur, end, value);
+		
+		// exponent (only if it is followed by digits, as in strtof)
+		if(ptr < end && (*ptr == 'e' || *ptr == 'E')) {
+			const char* exp_ptr = ptr + 1;
+			bool negative_exp = false;
+			if(exp_ptr < end && (*exp_ptr == '-' || *exp_ptr == '+')) {
+				negative_exp = (*exp_ptr == '-');
+				exp_ptr++;
+			}
+			const size_t exp_digit_count = digit_run(exp_ptr, end);
+			if(exp_digit_count > 0) {
+				if(exp_digit_count > 4) return parse_float_fallback(cur, end, value);
+				const int exp_value = (int)accumulate_digits(0, exp_ptr, exp_digit_count);
+				exponent += (negative_exp ? -exp_value : exp_value);
+				ptr = exp_ptr + exp_digit_count;
+			}
+		}
+		
+		if(mantissa == 0) {
+			// build the (signed) zero bitwise, -ffast-math doesn't know about signed zeros
+			const uint32_t zero_bits = (negative ? 0x80000000u : 0u);
+			memcpy(&value, &zero_bits, sizeof(float));
+			cur = ptr;
+			return true;
+		}
+		
+		// exact fast path: mantissa and power of ten are exactly representable as doubles,
+		// so a single multiplication/division is correctly rounded
+		if(mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+			double dbl_value = (double)mantissa;
+			if(exponent < 0) dbl_value /= pow10[-exponent];
+			else dbl_value *= pow10[exponent];
+			
+			if(dbl_value >= (double)FLT_MIN && dbl_value <= (double)FLT_MAX && !is_float_midpoint(dbl_value)) {
+				value = (float)(negative ? -dbl_value : dbl_value);
+				cur = ptr;
+				return true;
+			}
+		}
+		return parse_float_fallback(cur, end, value);
+	}
+	
+	// parses a "v", "v/vt", "v//vn" or "v/vt/vn" face corner, unspecified indices are set to 0 (which is never a valid .obj index)
+	inline bool parse_face_corner(const char*& cur, const char* end, int& vertex_index, int& coord_index, int& normal_index) {
+		const char* ptr = cur;
+		if(!parse_int(ptr, end, vertex_index)) return false;
+		
+		coord_index = 0;
+		normal_index = 0;
+		if(ptr < end && *ptr == '/') {
+			ptr++;
+			if(!parse_int(ptr, end, coord_index)) coord_index = 0;
+			if(ptr < end && *ptr == '/') {
+				ptr++;
+				if(!parse_int(ptr, end, normal_index)) normal_index = 0;
+			}
+		}
+		cur = ptr;
+		return true;
+	}
+	
+	// max amount of characters written by format_uint/format_float
+	static constexpr size_t max_formatted_uint_length = 10;
+	static constexpr size_t max_formatted_float_length = 24;
+	
+	inline size_t format_uint(char* dst, uint32_t value) {
+		char digits[max_formatted_uint_length];
+		size_t count = 0;
+		do {
+			digits[count++] = (char)('0' + (value % 10));
+			value /= 10;
+		} while(value != 0);
+		for(size_t i = 0; i < count; i++) {
+			dst[i] = digits[count - 1 - i];
+		}
+		return count;
+	}
+	
+	// 10^exponent as a double, exact up to 10^22
+	inline double pow10_double(int exponent) {
+		static const double pow10[] {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+		};
+		double val = 1.0;
+		for(; exponent > 22; exponent -= 22) {
+			val *= pow10[22];
+		}
+		return val * pow10[exponent];
+	}
+	
+	// writes "digits * 10^exponent" (digit_count significant digits, the first one being non-zero) in "%g" style:
+	// positional notation for exponents in [-4, 9), exponential notation otherwise
+	inline size_t format_decimal(char* dst, const bool negative, const char* digits, const size_t digit_count, const int exponent) {
+		char* out = dst;
+		if(negative) *out++ = '-';
+		if(exponent >= 9 || exponent < -4) {
+			*out++ = digits[0];
+			if(digit_count > 1) {
+				*out++ = '.';
+				memcpy(out, digits + 1, digit_count - 1);
+				out += digit_count - 1;
+			}
+			*out++ = 'e';
+			*out++ = (exponent < 0 ? '-' : '+');
+			const unsigned int abs_exponent = (unsigned int)(exponent < 0 ? -exponent : exponent);
+			if(abs_exponent < 10) *out++ = '0';
+			out += format_uint(out, abs_exponent);
+		}
+		else if(exponent >= 0) {
+			const size_t int_digit_count = (size_t)exponent + 1;
+			for(size_t i = 0; i < int_digit_count; i++) {
+				*out++ = (i < digit_count ? digits[i] : '0');
+			}
+			if(digit_count > int_digit_count) {
+				*out++ = '.';
+				memcpy(out, digits + int_digit_count, digit_count - int_digit_count);
+				out += digit_count - int_digit_count;
+			}
+		}
+		else {
+			*out++ = '0';
+			*out++ = '.';
+			for(int i = -1; i > exponent; i--) {
+				*out++ = '0';
+			}
+			memcpy(out, digits, digit_count);
+			out += digit_count;
+		}
+		return (size_t)(out - dst);
+	}
+	
+	// writes the shortest decimal representation (with 6 to 9 significant digits) that parse_float reads back as exactly
+	// the same float, so that writing and re-reading a model is lossless. zeros keep their sign, inf/nan are written as
+	// "inf"/"-inf"/"nan" (dst must have room for max_formatted_float_length characters)
+	inline size_t format_float(char* dst, const float value) {
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(uint32_t));
+		const bool negative = ((bits & 0x80000000u) != 0);
+		const uint32_t abs_bits = (bits & 0x7FFFFFFFu);
+		// special values are handled bitwise, -ffast-math doesn't know about them
+		if(abs_bits >= 0x7F800000u) {
+			if(abs_bits > 0x7F800000u) {
+				memcpy(dst, "nan", 3);
+				return 3;
+			}
+			if(negative) {
+				memcpy(dst, "-inf", 4);
+				return 4;
+			}
+			memcpy(dst, "inf", 3);
+			return 3;
+		}
+		if(abs_bits == 0) {
+			if(negative) {
+				memcpy(dst, "-0", 2);
+				return 2;
+			}
+			dst[0] = '0';
+			return 1;
+		}
+		
+		// the double is built from the float bits (denormals would be flushed to zero by a float -> double conversion with -ffast-math)
+		const uint32_t biased_exponent = (abs_bits >> 23);
+		const uint32_t float_mantissa = (abs_bits & 0x7FFFFFu);
+		const double dbl_value = (biased_exponent == 0 ?
+								  ldexp((double)float_mantissa, -149) :
+								  ldexp((double)(float_mantissa | 0x800000u), (int)biased_exponent - 150));
+		int exponent = (int)floor(log10(dbl_value));
+		for(size_t precision = 6; precision <= 9; precision++) {
+			// round to precision significant digits (log10 may be off by one at powers of ten -> adjust the exponent)
+			uint64_t mantissa = 0;
+			for(unsigned int attempt = 0; attempt < 3; attempt++) {
+				const int scale = (int)precision - 1 - exponent;
+				const double scaled = (scale >= 0 ? dbl_value * pow10_double(scale) : dbl_value / pow10_double(-scale));
+				mantissa = (uint64_t)(scaled + 0.5);
+				if(mantissa >= (uint64_t)pow10_double((int)precision)) exponent++;
+				else if(mantissa < (uint64_t)pow10_double((int)precision - 1)) exponent--;
+				else break;
+			}
+			
+			char digits[16];
+			size_t digit_count = format_uint(digits, (uint32_t)mantissa);
+			if(digit_count != precision) continue;
+			while(digit_count > 1 && digits[digit_count - 1] == '0') digit_count--;
+			
+			const size_t length = format_decimal(dst, negative, digits, digit_count, exponent);
+			const char* cur = dst;
+			float parsed_value;
+			if(parse_float(cur, dst + length, parsed_value) && cur == dst + length) {
+				uint32_t parsed_bits;
+				memcpy(&parsed_bits, &parsed_value, sizeof(uint32_t));
+				if(parsed_bits == bits) return length;
+			}
+		}
+		
+		// 9 significant digits always suffice, this is only reached if the scaling above was inexact
+		char num_buffer[32];
+		const int length = snprintf(num_buffer, sizeof(num_buffer), "%.9g", (negative ? -dbl_value : dbl_value));
+		memcpy(dst, num_buffer, (size_t)length);
+		return (size_t)length;
+	}
+	
+}
+
+#endif
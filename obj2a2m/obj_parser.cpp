@@ -0,0 +1,765 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "obj_parser.h"
+#include "parallel.h"
+#include "obj_number.h"
+#include "gz_stream.h"
+
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// mapped_file
+
+mapped_file::mapped_file(const char* filename) {
+#ifdef WIN32
+	file_handle = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if(file_handle == INVALID_HANDLE_VALUE) return;
+	
+	LARGE_INTEGER file_size;
+	if(!GetFileSizeEx(file_handle, &file_size)) return;
+	size = (size_t)file_size.QuadPart;
+	if(size == 0) {
+		// nothing to map
+		opened = true;
+		return;
+	}
+	
+	mapping_handle = CreateFileMappingA(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if(mapping_handle == NULL) return;
+	data = (const char*)MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+	opened = (data != nullptr);
+#else
+	fd = open(filename, O_RDONLY);
+	if(fd < 0) return;
+	
+	struct stat file_stat;
+	if(fstat(fd, &file_stat) != 0) return;
+	size = (size_t)file_stat.st_size;
+	if(size == 0) {
+		// nothing to map
+		opened = true;
+		return;
+	}
+	
+	void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if(mapping == MAP_FAILED) return;
+	// the file is read front to back
+	madvise(mapping, size, MADV_SEQUENTIAL);
+	data = (const char*)mapping;
+	opened = true;
+#endif
+}
+
+mapped_file::~mapped_file() {
+#ifdef WIN32
+	if(data != nullptr) UnmapViewOfFile(data);
+	if(mapping_handle != NULL) CloseHandle(mapping_handle);
+	if(file_handle != INVALID_HANDLE_VALUE) CloseHandle(file_handle);
+#else
+	if(data != nullptr) munmap((void*)data, size);
+	if(fd >= 0) close(fd);
+#endif
+}
+
+void mapped_file::release(const size_t offset, const size_t release_size) {
+#ifndef WIN32
+	if(data == nullptr) return;
+	
+	// only whole pages inside the range can be released (the mapping itself starts at a page boundary)
+	static const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+	const size_t begin = (offset + page_size - 1) / page_size * page_size;
+	const size_t end = std::min(offset + release_size, size) / page_size * page_size;
+	if(begin < end) madvise((void*)(data + begin), end - begin, MADV_DONTNEED);
+#else
+	(void)offset;
+	(void)release_size;
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// in-place line/token scanner
+
+static inline bool is_obj_space(const char ch) {
+	return (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\v' || ch == '\f');
+}
+
+// returns the next whitespace separated token in [cur, line_end) and advances cur behind it
+static inline bool next_token(const char*& cur, const char* line_end, const char*& token, size_t& token_len) {
+	while(cur < line_end && is_obj_space(*cur)) cur++;
+	if(cur >= line_end) return false;
+	token = cur;
+	while(cur < line_end && !is_obj_space(*cur)) cur++;
+	token_len = (size_t)(cur - token);
+	return true;
+}
+
+static inline bool token_equals(const char* token, const size_t token_len, const char* str, const size_t str_len) {
+	return (token_len == str_len && memcmp(token, str, str_len) == 0);
+}
+
+static inline void skip_spaces(const char*& cur, const char* line_end) {
+	while(cur < line_end && is_obj_space(*cur)) cur++;
+}
+
+// parses the next float of the current line (0 if there is none),
+// numbers are parsed in place and may look ahead up to the chunk end (a number never continues beyond its line)
+static inline float next_float(const char*& cur, const char* line_end, const char* chunk_end) {
+	skip_spaces(cur, line_end);
+	float value = 0.0f;
+	if(cur >= line_end || !obj_number::parse_float(cur, chunk_end, value)) {
+		// skip whatever this is
+		while(cur < line_end && !is_obj_space(*cur)) cur++;
+		return 0.0f;
+	}
+	return value;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// chunk parser
+
+// parse result of one line-aligned part of the .obj file
+struct obj_chunk {
+	vector<float3> vertices;
+	vector<coord> tex_coords;
+	// all triangles of this chunk in file order
+	vector<s_index> indices;
+	vector<s_index> tex_indices;
+	
+	// relative (negative) .obj indices can only be resolved once the vertex/coord count of all previous chunks is known,
+	// these are stored relative to the chunk start and their flat position (triangle * 3 + corner) is recorded here
+	vector<size_t> relative_indices;
+	vector<size_t> relative_tex_indices;
+	
+	// only parsed if normals are loaded: normals, the normal indices of all triangles (~0u if a corner has none)
+	// and the flat positions of the relative normal indices
+	vector<float3> normals;
+	vector<s_index> normal_indices;
+	vector<size_t> relative_normal_indices;
+	
+	// "g", "usemtl", "mtllib" and "s" (only if normals are loaded) statements, the sub-object state is only known after all previous chunks have been merged
+	enum class STATEMENT : unsigned int {
+		GROUP,
+		USEMTL,
+		MTLLIB,
+		SMOOTH,
+	};
+	struct statement {
+		STATEMENT type;
+		string name;
+		size_t triangle; // index of the first triangle following this statement
+	};
+	vector<statement> statements;
+	
+	bool missing_coords = false;
+	
+	// statistics (see conversion_stats)
+	size_t token_count = 0;
+	size_t face_count = 0;
+	size_t quad_count = 0;
+};
+
+// adds the statistics of all chunks to stats (if not nullptr)
+static void add_chunk_stats(const vector<obj_chunk>& chunks, conversion_stats* stats) {
+	if(stats == nullptr) return;
+	for(const auto& chunk : chunks) {
+		stats->token_count += chunk.token_count;
+		stats->face_count += chunk.face_count;
+		stats->quad_count += chunk.quad_count;
+	}
+}
+
+// decompression and parsing overlap when reading a compressed file: the time of the stream thread is added to READ,
+// the remaining wall clock time since start_time is added to PARSE
+static void add_stream_times(conversion_stats* stats, const double decompress_time, const chrono::high_resolution_clock::time_point& start_time) {
+	if(stats == nullptr) return;
+	const double total_time = chrono::duration<double>(chrono::high_resolution_clock::now() - start_time).count();
+	stats->add_time(CONVERSION_PHASE::READ, decompress_time);
+	stats->add_time(CONVERSION_PHASE::PARSE, std::max(total_time - decompress_time, 0.0));
+}
+
+static void parse_obj_chunk(const char* chunk_begin, const char* chunk_end, const bool load_normals, obj_chunk& chunk) {
+	const char* token;
+	size_t token_len;
+	int corner_vertex[4], corner_coord[4], corner_normal[4];
+	
+	const char* line_end = chunk_begin;
+	for(const char* line = chunk_begin; line < chunk_end; line = line_end + 1) {
+		line_end = (const char*)memchr(line, '\n', (size_t)(chunk_end - line));
+		if(line_end == nullptr) line_end = chunk_end;
+		
+		const char* cur = line;
+		if(!next_token(cur, line_end, token, token_len)) continue; // empty line
+		chunk.token_count++;
+		
+		switch(token[0]) {
+			case 'v':
+				// vertex
+				if(token_len == 1) {
+					const float x = next_float(cur, line_end, chunk_end);
+					const float y = next_float(cur, line_end, chunk_end);
+					const float z = next_float(cur, line_end, chunk_end);
+					chunk.vertices.emplace_back(x, y, z);
+					chunk.token_count += 3;
+				}
+				// texture coordinate (a possible w component is ignored)
+				else if(token_len == 2 && token[1] == 't') {
+					chunk.tex_coords.emplace_back();
+					chunk.tex_coords.back().u = next_float(cur, line_end, chunk_end);
+					chunk.tex_coords.back().v = next_float(cur, line_end, chunk_end);
+					chunk.token_count += (next_token(cur, line_end, token, token_len) ? 3 : 2);
+				}
+				// normal (ignored unless normals are loaded)
+				else if(token_len == 2 && token[1] == 'n' && load_normals) {
+					const float x = next_float(cur, line_end, chunk_end);
+					const float y = next_float(cur, line_end, chunk_end);
+					const float z = next_float(cur, line_end, chunk_end);
+					chunk.normals.emplace_back(x, y, z);
+					chunk.token_count += 3;
+				}
+				break;
+			case 'f': {
+				// face / triangle
+				if(token_len != 1) break;
+				
+				// since the .obj format allows mixed triangle and quad faces, count the corners of each face
+				unsigned int corner_count = 0;
+				while(corner_count < 4) {
+					skip_spaces(cur, line_end);
+					if(cur >= line_end) break;
+					if(!obj_number::parse_face_corner(cur, chunk_end, corner_vertex[corner_count], corner_coord[corner_count], corner_normal[corner_count])) break;
+					
+					// as in get_face_indices: if no texture coordinate index is specified, "1" is used
+					if(corner_coord[corner_count] == 0) {
+						corner_coord[corner_count] = 1;
+						if(corner_normal[corner_count] == 0) chunk.missing_coords = true;
+					}
+					corner_count++;
+				}
+				if(corner_count < 3) {
+					a2e_error("invalid face with only %u indices - ignoring it!", corner_count);
+					break;
+				}
+				chunk.token_count += corner_count;
+				chunk.face_count++;
+				if(corner_count == 4) chunk.quad_count++;
+				
+				// convert to 0-based indices, relative ones are converted to chunk-relative indices (may wrap around)
+				unsigned int vertex_idx[4], coord_idx[4], normal_idx[4];
+				bool relative_vertex[4], relative_coord[4], relative_normal[4];
+				for(unsigned int i = 0; i < corner_count; i++) {
+					relative_vertex[i] = (corner_vertex[i] < 0);
+					vertex_idx[i] = (relative_vertex[i] ?
+									 (unsigned int)((int)chunk.vertices.size() + corner_vertex[i]) :
+									 (unsigned int)(corner_vertex[i] - 1));
+					relative_coord[i] = (corner_coord[i] < 0);
+					coord_idx[i] = (relative_coord[i] ?
+									(unsigned int)((int)chunk.tex_coords.size() + corner_coord[i]) :
+									(unsigned int)(corner_coord[i] - 1));
+					relative_normal[i] = (corner_normal[i] < 0);
+					normal_idx[i] = (corner_normal[i] == 0 ? ~0u : (relative_normal[i] ?
+																	 (unsigned int)((int)chunk.normals.size() + corner_normal[i]) :
+																	 (unsigned int)(corner_normal[i] - 1)));
+				}
+				
+				// first triangle, and another one if we have quad faces
+				static const unsigned int triangle_corners[2][3] { { 0, 1, 2 }, { 0, 2, 3 } };
+				for(unsigned int t = 0; t < corner_count - 2; t++) {
+					const size_t flat_index = chunk.indices.size() * 3;
+					chunk.indices.push_back(s_index {{
+						vertex_idx[triangle_corners[t][0]],
+						vertex_idx[triangle_corners[t][1]],
+						vertex_idx[triangle_corners[t][2]]
+					}});
+					chunk.tex_indices.push_back(s_index {{
+						coord_idx[triangle_corners[t][0]],
+						coord_idx[triangle_corners[t][1]],
+						coord_idx[triangle_corners[t][2]]
+					}});
+					for(unsigned int k = 0; k < 3; k++) {
+						if(relative_vertex[triangle_corners[t][k]]) chunk.relative_indices.push_back(flat_index + k);
+						if(relative_coord[triangle_corners[t][k]]) chunk.relative_tex_indices.push_back(flat_index + k);
+					}
+					if(load_normals) {
+						chunk.normal_indices.push_back(s_index {{
+							normal_idx[triangle_corners[t][0]],
+							normal_idx[triangle_corners[t][1]],
+							normal_idx[triangle_corners[t][2]]
+						}});
+						for(unsigned int k = 0; k < 3; k++) {
+							if(relative_normal[triangle_corners[t][k]]) chunk.relative_normal_indices.push_back(flat_index + k);
+						}
+					}
+				}
+			}
+			break;
+			case 'g':
+				// sub-object
+				if(token_len != 1) break;
+				if(next_token(cur, line_end, token, token_len) && token[0] != '#') {
+					chunk.statements.push_back(obj_chunk::statement { obj_chunk::STATEMENT::GROUP, string(token, token_len), chunk.indices.size() });
+					chunk.token_count++;
+				}
+				break;
+			case 'u':
+				// usemtl
+				if(!token_equals(token, token_len, "usemtl", 6)) break;
+				if(next_token(cur, line_end, token, token_len)) {
+					chunk.statements.push_back(obj_chunk::statement { obj_chunk::STATEMENT::USEMTL, string(token, token_len), chunk.indices.size() });
+					chunk.token_count++;
+				}
+				break;
+			case 'm':
+				// mtllib
+				if(!token_equals(token, token_len, "mtllib", 6)) break;
+				if(next_token(cur, line_end, token, token_len)) {
+					chunk.statements.push_back(obj_chunk::statement { obj_chunk::STATEMENT::MTLLIB, string(token, token_len), chunk.indices.size() });
+					chunk.token_count++;
+				}
+				break;
+			case 's':
+				// smoothing group (ignored unless normals are loaded)
+				if(token_len != 1 || !load_normals) break;
+				if(next_token(cur, line_end, token, token_len)) {
+					chunk.statements.push_back(obj_chunk::statement { obj_chunk::STATEMENT::SMOOTH, string(token, token_len), chunk.indices.size() });
+					chunk.token_count++;
+				}
+				break;
+			// comments and everything else - ignore
+			default: break;
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// parser
+
+// replays the sub-object statements of the parsed chunks in file order
+class obj_statement_replay {
+public:
+	obj_statement_replay(bool collision_obj_, bool join_mat_objects_, string& mtllib_,
+						 map<unsigned int, string>& obj_names_, map<unsigned int, string>& obj_mats_) :
+	collision_obj(collision_obj_), join_mat_objects(join_mat_objects_), mtllib(mtllib_), obj_names(obj_names_), obj_mats(obj_mats_) {}
+	
+	// calls add_triangles(first_triangle, triangle_count, sub_object) for each run of consecutive chunk triangles
+	// that belong to the same sub-object, returns false if the .obj is invalid
+	template <typename add_func> bool replay(const obj_chunk& chunk, const add_func& add_triangles) {
+		size_t triangle = 0;
+		auto statement = chunk.statements.cbegin();
+		while(triangle < chunk.indices.size() || statement != chunk.statements.cend()) {
+			// add all triangles up to the next statement to the current sub-object
+			const size_t next_statement_triangle = (statement != chunk.statements.cend() ? statement->triangle : chunk.indices.size());
+			if(triangle < next_statement_triangle) {
+				if(cur_subobj < 0) {
+					a2e_error("invalid obj-format - no sub-object specified!");
+					return false;
+				}
+				add_triangles(triangle, next_statement_triangle - triangle, (unsigned int)cur_subobj);
+				triangle = next_statement_triangle;
+			}
+			if(statement == chunk.statements.cend()) break;
+			
+			switch(statement->type) {
+				case obj_chunk::STATEMENT::GROUP:
+					if(!collision_obj && statement->name == "collision") {
+						a2e_error("old obj-format - no sub-object with the name \"collision\" allowed!");
+						return false;
+					}
+					
+					if(!join_mat_objects) {
+						cur_subobj = obj_names.size();
+						obj_names[cur_subobj] = statement->name;
+						obj_mats[cur_subobj] = "";
+					}
+					break;
+				case obj_chunk::STATEMENT::USEMTL:
+					if(join_mat_objects) {
+						const auto mat_iter = object_mats.find(statement->name);
+						if(mat_iter == object_mats.end()) {
+							cur_subobj = obj_names.size();
+							object_mats[statement->name] = cur_subobj;
+							obj_names[cur_subobj] = statement->name;
+							obj_mats[cur_subobj] = statement->name;
+						}
+						else {
+							// if join_mat_objects is specified, reuse to sub-object id, thus merging all data for one material
+							cur_subobj = mat_iter->second;
+						}
+					}
+					else if(cur_subobj >= 0) {
+						obj_mats[cur_subobj] = statement->name;
+					}
+					break;
+				case obj_chunk::STATEMENT::MTLLIB:
+					mtllib = statement->name;
+					break;
+				case obj_chunk::STATEMENT::SMOOTH:
+					// handled by merge_obj_chunks
+					break;
+			}
+			statement++;
+		}
+		return true;
+	}
+	
+protected:
+	const bool collision_obj;
+	const bool join_mat_objects;
+	string& mtllib;
+	map<unsigned int, string>& obj_names;
+	map<unsigned int, string>& obj_mats;
+	
+	int cur_subobj = -1;
+	map<string, size_t> object_mats;
+	
+};
+
+// merges the parsed chunks (in file order) into the model
+static bool merge_obj_chunks(bool collision_obj, bool join_mat_objects, const bool load_normals, vector<obj_chunk>& chunks, string& mtllib, obj_model& model) {
+	// the vertex, texture coordinate and triangle counts are known now -> allocate the model arrays
+	size_t vertex_count = 0, coord_count = 0, normal_count = 0, triangle_count = 0;
+	for(const auto& chunk : chunks) {
+		vertex_count += chunk.vertices.size();
+		coord_count += chunk.tex_coords.size();
+		normal_count += chunk.normals.size();
+		triangle_count += chunk.indices.size();
+	}
+	model.vertices = arena_array<float3>(model.arena, vertex_count);
+	model.tex_coords = arena_array<coord>(model.arena, std::max(coord_count, (size_t)1));
+	if(load_normals) model.normals = arena_array<float3>(model.arena, normal_count);
+	
+	// merge all chunks in file order: replay the sub-object state changes and offset all chunk-local indices
+	obj_statement_replay replay(collision_obj, join_mat_objects, mtllib, model.obj_names, model.obj_mats);
+	bool missing_coords = false;
+	vector<unsigned int> triangle_objects; // sub-object of each triangle
+	vector<size_t> object_triangle_counts;
+	triangle_objects.reserve(triangle_count);
+	unsigned int vertex_offset = 0, coord_offset = 0, normal_offset = 0;
+	for(auto& chunk : chunks) {
+		copy(chunk.vertices.cbegin(), chunk.vertices.cend(), model.vertices.begin() + vertex_offset);
+		copy(chunk.tex_coords.cbegin(), chunk.tex_coords.cend(), model.tex_coords.begin() + coord_offset);
+		if(load_normals) {
+			copy(chunk.normals.cbegin(), chunk.normals.cend(), model.normals.begin() + normal_offset);
+			for(const auto& flat_index : chunk.relative_normal_indices) {
+				chunk.normal_indices[flat_index / 3].indices[flat_index % 3] += normal_offset;
+			}
+			normal_offset += (unsigned int)chunk.normals.size();
+			chunk.normals = vector<float3>();
+		}
+		
+		for(const auto& flat_index : chunk.relative_indices) {
+			chunk.indices[flat_index / 3].indices[flat_index % 3] += vertex_offset;
+		}
+		for(const auto& flat_index : chunk.relative_tex_indices) {
+			chunk.tex_indices[flat_index / 3].indices[flat_index % 3] += coord_offset;
+		}
+		missing_coords |= chunk.missing_coords;
+		vertex_offset += (unsigned int)chunk.vertices.size();
+		coord_offset += (unsigned int)chunk.tex_coords.size();
+		
+		// free the vertex data as early as possible
+		chunk.vertices = vector<float3>();
+		chunk.tex_coords = vector<coord>();
+		
+		const bool replayed = replay.replay(chunk, [&triangle_objects, &object_triangle_counts](const size_t, const size_t count, const unsigned int object) {
+			if(object >= object_triangle_counts.size()) object_triangle_counts.resize(object + 1, 0);
+			triangle_objects.insert(triangle_objects.end(), count, object);
+			object_triangle_counts[object] += count;
+		});
+		if(!replayed) return false;
+	}
+	object_triangle_counts.resize(model.obj_names.size(), 0);
+	
+	// sort the triangles by sub-object (keeping the file order inside each sub-object)
+	model.alloc_triangles(object_triangle_counts);
+	if(load_normals) {
+		model.normal_indices = arena_array<s_index>(model.arena, model.object_offsets.back());
+		model.smoothing_groups = arena_array<unsigned int>(model.arena, model.object_offsets.back());
+	}
+	vector<size_t> object_positions(model.object_offsets.cbegin(), model.object_offsets.cend() - 1);
+	auto triangle_object = triangle_objects.cbegin();
+	// triangles in front of the first "s" statement are smoothed
+	unsigned int smoothing_group = 1;
+	for(auto& chunk : chunks) {
+		auto statement = chunk.statements.cbegin();
+		for(size_t triangle = 0; triangle < chunk.indices.size(); triangle++) {
+			const size_t position = object_positions[*triangle_object++]++;
+			model.indices[position] = chunk.indices[triangle];
+			model.tex_indices[position] = chunk.tex_indices[triangle];
+			if(load_normals) {
+				for(; statement != chunk.statements.cend() && statement->triangle <= triangle; statement++) {
+					if(statement->type != obj_chunk::STATEMENT::SMOOTH) continue;
+					smoothing_group = (statement->name == "off" ? 0 : string2uint(statement->name));
+				}
+				model.normal_indices[position] = chunk.normal_indices[triangle];
+				model.smoothing_groups[position] = smoothing_group;
+			}
+		}
+		for(; load_normals && statement != chunk.statements.cend(); statement++) {
+			if(statement->type == obj_chunk::STATEMENT::SMOOTH) {
+				smoothing_group = (statement->name == "off" ? 0 : string2uint(statement->name));
+			}
+		}
+		
+		// free the chunk data as early as possible
+		chunk = obj_chunk();
+	}
+	
+	if(missing_coords) {
+		a2e_error("face contains no texture coordinate index - using \"1\"!");
+	}
+	
+	if(coord_count == 0) {
+		a2e_error("obj doesn't contain texture coordinates - using dummy coordinates!");
+		model.tex_coords[0].u = 0.0f;
+		model.tex_coords[0].v = 0.0f;
+	}
+	
+	return true;
+}
+
+bool load_obj_data_mapped(bool collision_obj, bool join_mat_objects, bool load_normals, unsigned int thread_count, const char* filename,
+						  string& mtllib, obj_model& model, conversion_stats* stats) {
+	// note that the file is mostly read through page faults while it is being parsed
+	phase_timer read_timer(stats, CONVERSION_PHASE::READ);
+	mapped_file file(filename);
+	read_timer.stop();
+	phase_timer parse_timer(stats, CONVERSION_PHASE::PARSE);
+	if(!file.is_open()) {
+		a2e_error("couldn't open obj file \"%s\"!", filename);
+		return false;
+	}
+	
+	// split the file into line-aligned chunks (small files aren't worth splitting)
+	static const size_t min_chunk_size = 1024 * 1024;
+	const char* data = file.get_data();
+	const char* data_end = data + file.get_size();
+	const size_t chunk_count = std::max(std::min((size_t)std::max(thread_count, 1u), file.get_size() / min_chunk_size), (size_t)1);
+	vector<const char*> chunk_bounds { data };
+	for(size_t i = 1; i < chunk_count; i++) {
+		const char* split = std::max(data + (file.get_size() / chunk_count) * i, chunk_bounds.back());
+		const char* line_end = (const char*)memchr(split, '\n', (size_t)(data_end - split));
+		if(line_end == nullptr) break;
+		chunk_bounds.push_back(line_end + 1);
+	}
+	chunk_bounds.push_back(data_end);
+	
+	vector<obj_chunk> chunks(chunk_bounds.size() - 1);
+	parallel_for(chunks.size(), thread_count, [&chunks, &chunk_bounds, load_normals](const size_t i) {
+		parse_obj_chunk(chunk_bounds[i], chunk_bounds[i + 1], load_normals, chunks[i]);
+	});
+	add_chunk_stats(chunks, stats);
+	
+	return merge_obj_chunks(collision_obj, join_mat_objects, load_normals, chunks, mtllib, model);
+}
+
+bool load_obj_data_gz(bool collision_obj, bool join_mat_objects, bool load_normals, unsigned int thread_count, const char* filename,
+					  string& mtllib, obj_model& model, conversion_stats* stats) {
+	const auto start_time = chrono::high_resolution_clock::now();
+	
+	// the file is decompressed on its own thread, while up to thread_count tasks parse the decompressed blocks
+	static const size_t block_size = 4 * 1024 * 1024;
+	const size_t worker_count = std::max(thread_count, 1u);
+	gz_line_stream stream(filename, block_size, worker_count * 2);
+	if(!stream.is_open()) {
+		a2e_error("couldn't open obj file \"%s\"!", filename);
+		return false;
+	}
+	
+	vector<obj_chunk> chunks;
+	mutex chunks_lock;
+	parallel_for(worker_count, (unsigned int)worker_count, [&stream, &chunks, &chunks_lock, load_normals](const size_t) {
+		vector<char> block;
+		size_t block_index;
+		while(stream.next_block(block, block_index)) {
+			obj_chunk chunk;
+			parse_obj_chunk(block.data(), block.data() + block.size(), load_normals, chunk);
+			
+			lock_guard<mutex> lock(chunks_lock);
+			if(chunks.size() <= block_index) chunks.resize(block_index + 1);
+			chunks[block_index] = move(chunk);
+		}
+	});
+	if(stream.has_failed()) {
+		a2e_error("failed to decompress obj file \"%s\" (corrupt or truncated)!", filename);
+		return false;
+	}
+	add_chunk_stats(chunks, stats);
+	
+	const bool merged = merge_obj_chunks(collision_obj, join_mat_objects, load_normals, chunks, mtllib, model);
+	add_stream_times(stats, stream.get_decompress_time(), start_time);
+	return merged;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// out-of-core parser
+
+bool obj_spill_model::open(const string& filename_prefix) {
+	return (vertices.open(filename_prefix + ".vertices") &&
+			tex_coords.open(filename_prefix + ".tex_coords") &&
+			triangles.open(filename_prefix + ".triangles"));
+}
+
+void obj_spill_model::get_triangles(const unsigned int object, const size_t first, const size_t count, s_index* indices, s_index* tex_indices) const {
+	const obj_spill_triangle* spilled_triangles = (const obj_spill_triangle*)triangles.data();
+	size_t cur_triangle = first, remaining = count;
+	size_t range_first = 0; // position of the current range inside the sub-object
+	for(const auto& range : object_ranges[object]) {
+		if(remaining == 0) break;
+		if(cur_triangle < range_first + range.count) {
+			const size_t offset = cur_triangle - range_first;
+			const size_t range_count = std::min(remaining, range.count - offset);
+			const obj_spill_triangle* src = spilled_triangles + range.first + offset;
+			for(size_t i = 0; i < range_count; i++) {
+				indices[i] = src[i].indices;
+				tex_indices[i] = src[i].tex_indices;
+			}
+			indices += range_count;
+			tex_indices += range_count;
+			cur_triangle += range_count;
+			remaining -= range_count;
+		}
+		range_first += range.count;
+	}
+}
+
+bool load_obj_data_streamed(bool collision_obj, bool join_mat_objects, unsigned int thread_count, const size_t block_size,
+							const char* filename, string& mtllib, obj_spill_model& model, conversion_stats* stats) {
+	const auto start_time = chrono::high_resolution_clock::now();
+	
+	// compressed files are decompressed on their own thread (see load_obj_data_gz), all other files are mapped
+	const size_t worker_count = std::max(thread_count, 1u);
+	const bool compressed = gz_line_stream::is_compressed(filename);
+	unique_ptr<gz_line_stream> stream;
+	unique_ptr<mapped_file> file;
+	if(compressed) stream.reset(new gz_line_stream(filename, block_size, worker_count));
+	else file.reset(new mapped_file(filename));
+	if(compressed ? !stream->is_open() : !file->is_open()) {
+		a2e_error("couldn't open obj file \"%s\"!", filename);
+		return false;
+	}
+	
+	obj_statement_replay replay(collision_obj, join_mat_objects, mtllib, model.obj_names, model.obj_mats);
+	bool missing_coords = false;
+	vector<vector<char>> blocks(worker_count);
+	vector<pair<const char*, const char*>> chunk_bounds;
+	vector<obj_chunk> chunks;
+	vector<obj_spill_triangle> chunk_triangles;
+	size_t file_offset = 0;
+	for(;;) {
+		// get the blocks of the next round
+		const size_t round_offset = file_offset;
+		chunk_bounds.clear();
+		if(compressed) {
+			size_t block_index;
+			for(size_t i = 0; i < worker_count && stream->next_block(blocks[i], block_index); i++) {
+				chunk_bounds.emplace_back(blocks[i].data(), blocks[i].data() + blocks[i].size());
+			}
+		}
+		else {
+			const char* data = file->get_data();
+			const size_t size = file->get_size();
+			while(chunk_bounds.size() < worker_count && file_offset < size) {
+				size_t block_end = std::min(file_offset + block_size, size);
+				const char* line_end = (const char*)memchr(data + block_end - 1, '\n', size - block_end + 1);
+				block_end = (line_end != nullptr ? (size_t)(line_end - data) + 1 : size);
+				chunk_bounds.emplace_back(data + file_offset, data + block_end);
+				file_offset = block_end;
+			}
+		}
+		if(chunk_bounds.empty()) break;
+		
+		chunks.clear();
+		chunks.resize(chunk_bounds.size());
+		parallel_for(chunks.size(), thread_count, [&chunks, &chunk_bounds](const size_t i) {
+			parse_obj_chunk(chunk_bounds[i].first, chunk_bounds[i].second, false, chunks[i]);
+		});
+		add_chunk_stats(chunks, stats);
+		
+		// append the chunks to the spill files in file order
+		for(auto& chunk : chunks) {
+			for(const auto& flat_index : chunk.relative_indices) {
+				chunk.indices[flat_index / 3].indices[flat_index % 3] += (unsigned int)model.vertex_count;
+			}
+			for(const auto& flat_index : chunk.relative_tex_indices) {
+				chunk.tex_indices[flat_index / 3].indices[flat_index % 3] += (unsigned int)model.coord_count;
+			}
+			missing_coords |= chunk.missing_coords;
+			
+			chunk_triangles.resize(chunk.indices.size());
+			for(size_t i = 0; i < chunk.indices.size(); i++) {
+				chunk_triangles[i] = obj_spill_triangle { chunk.indices[i], chunk.tex_indices[i] };
+			}
+			if(!model.vertices.append(chunk.vertices.data(), chunk.vertices.size() * sizeof(float3)) ||
+			   !model.tex_coords.append(chunk.tex_coords.data(), chunk.tex_coords.size() * sizeof(coord)) ||
+			   !model.triangles.append(chunk_triangles.data(), chunk_triangles.size() * sizeof(obj_spill_triangle))) {
+				return false;
+			}
+			model.vertex_count += chunk.vertices.size();
+			model.coord_count += chunk.tex_coords.size();
+			
+			const size_t triangle_offset = model.triangle_count;
+			const bool replayed = replay.replay(chunk, [&model, triangle_offset](const size_t first, const size_t count, const unsigned int object) {
+				if(object >= model.object_ranges.size()) {
+					model.object_ranges.resize(object + 1);
+					model.object_triangle_counts.resize(object + 1, 0);
+				}
+				// continue the last range of the sub-object if the triangles directly follow it
+				auto& ranges = model.object_ranges[object];
+				if(!ranges.empty() && ranges.back().first + ranges.back().count == triangle_offset + first) {
+					ranges.back().count += count;
+				}
+				else ranges.push_back(obj_spill_model::triangle_range { triangle_offset + first, count });
+				model.object_triangle_counts[object] += count;
+			});
+			if(!replayed) return false;
+			model.triangle_count += chunk.indices.size();
+		}
+		
+		// the text of this round won't be read again
+		if(!compressed) file->release(round_offset, file_offset - round_offset);
+	}
+	if(compressed && stream->has_failed()) {
+		a2e_error("failed to decompress obj file \"%s\" (corrupt or truncated)!", filename);
+		return false;
+	}
+	model.object_ranges.resize(model.obj_names.size());
+	model.object_triangle_counts.resize(model.obj_names.size(), 0);
+	
+	if(missing_coords) {
+		a2e_error("face contains no texture coordinate index - using \"1\"!");
+	}
+	
+	if(model.coord_count == 0) {
+		a2e_error("obj doesn't contain texture coordinates - using dummy coordinates!");
+		coord dummy_coord;
+		dummy_coord.u = 0.0f;
+		dummy_coord.v = 0.0f;
+		if(!model.tex_coords.append(&dummy_coord, sizeof(coord))) return false;
+		model.coord_count = 1;
+	}
+	
+	const bool finished = (model.vertices.finish() && model.tex_coords.finish() && model.triangles.finish());
+	add_stream_times(stats, (compressed ? stream->get_decompress_time() : 0.0), start_time);
+	return finished;
+}
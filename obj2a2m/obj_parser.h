@@ -0,0 +1,109 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_OBJ_PARSER_H__
+#define __OBJ2A2M_OBJ_PARSER_H__
+
+#include <a2e.h>
+#include "obj_model.h"
+#include "spill_file.h"
+#include "conversion_stats.h"
+
+// read-only memory mapping of a whole file (the file contents are not copied)
+class mapped_file {
+public:
+	mapped_file(const char* filename);
+	~mapped_file();
+	
+	bool is_open() const { return opened; }
+	const char* get_data() const { return data; }
+	size_t get_size() const { return size; }
+	
+	// tells the os that [offset, offset + size) won't be read again, so that its pages can be dropped (posix only)
+	void release(const size_t offset, const size_t size);
+
+protected:
+	bool opened = false;
+	const char* data = nullptr;
+	size_t size = 0;
+
+#ifdef WIN32
+	HANDLE file_handle = INVALID_HANDLE_VALUE;
+	HANDLE mapping_handle = NULL;
+#else
+	int fd = -1;
+#endif
+	
+	mapped_file(const mapped_file&) = delete;
+	mapped_file& operator=(const mapped_file&) = delete;
+
+};
+
+// memory-maps the .obj file and scans it in place (no intermediate buffer and no per-token strings),
+// the output is the same as the one of the stream based load_obj_data.
+// the file is split into line-aligned chunks which are parsed in parallel by up to thread_count tasks.
+// if stats isn't nullptr, the READ/PARSE times and the token/face/quad counts are added to it (same for all loaders).
+// normals ("vn", the normal indices of the faces and the "s" smoothing groups) are only loaded if load_normals is set
+bool load_obj_data_mapped(bool collision_obj, bool join_mat_objects, bool load_normals, unsigned int thread_count, const char* filename,
+						  string& mtllib, obj_model& model, conversion_stats* stats = nullptr);
+
+// reads a gzip or zlib compressed .obj file (see gz_line_stream::is_compressed): the file is decompressed in blocks
+// on its own thread while the blocks are parsed by up to thread_count tasks (same output as load_obj_data_mapped)
+bool load_obj_data_gz(bool collision_obj, bool join_mat_objects, bool load_normals, unsigned int thread_count, const char* filename,
+					  string& mtllib, obj_model& model, conversion_stats* stats = nullptr);
+
+// per triangle record of obj_spill_model::triangles
+struct obj_spill_triangle {
+	s_index indices;
+	s_index tex_indices;
+};
+
+// the data of a .obj file that was loaded by load_obj_data_streamed: vertices, texture coordinates and triangles
+// are stored in spill files (in file order), only the sub-object structure is kept in memory
+struct obj_spill_model {
+	spill_file vertices; // float3
+	spill_file tex_coords; // coord
+	spill_file triangles; // obj_spill_triangle
+	size_t vertex_count = 0;
+	size_t coord_count = 0;
+	size_t triangle_count = 0;
+	
+	// the triangles of each sub-object, as ranges of the triangles file
+	struct triangle_range {
+		size_t first;
+		size_t count;
+	};
+	vector<vector<triangle_range>> object_ranges;
+	vector<size_t> object_triangle_counts;
+	
+	map<unsigned int, string> obj_names;
+	map<unsigned int, string> obj_mats;
+	
+	// creates the spill files (filename_prefix + ".vertices" etc.)
+	bool open(const string& filename_prefix);
+	// copies triangles [first, first + count) of the sub-object (can only be called once the spill files are finished)
+	void get_triangles(const unsigned int object, const size_t first, const size_t count, s_index* indices, s_index* tex_indices) const;
+};
+
+// out-of-core variant of load_obj_data_mapped/load_obj_data_gz: the file is read in rounds of thread_count line-aligned
+// blocks of block_size bytes, each round is parsed in parallel and then appended to the spill files of the model,
+// so that only one round has to be in memory at once (normals are never loaded)
+bool load_obj_data_streamed(bool collision_obj, bool join_mat_objects, unsigned int thread_count, const size_t block_size,
+							const char* filename, string& mtllib, obj_spill_model& model, conversion_stats* stats = nullptr);
+
+#endif
@@ -0,0 +1,56 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "obj_writer.h"
+#include "parallel.h"
+
+bool write_text_chunks(const string& filename, const size_t job_count, const unsigned int thread_count,
+					   const function<void(const size_t job, obj_text_chunk& chunk)>& format_job) {
+	FILE* file = fopen(filename.c_str(), "wb");
+	if(file == nullptr) {
+		a2e_error("couldn't open/write obj file \"%s\"!", filename);
+		return false;
+	}
+	
+	// the chunks are written in order, each one once all previous chunks have been written
+	mutex write_lock;
+	condition_variable write_cv;
+	size_t next_write_job = 0;
+	bool write_failed = false;
+	parallel_for(job_count, thread_count, [&](const size_t job) {
+		obj_text_chunk chunk;
+		format_job(job, chunk);
+		
+		// parallel_for hands out the jobs in order, so all previous jobs are already being processed
+		unique_lock<mutex> lock(write_lock);
+		write_cv.wait(lock, [&next_write_job, &job] { return (next_write_job == job); });
+		const string& text = chunk.get_text();
+		if(!write_failed && fwrite(text.data(), 1, text.size(), file) != text.size()) {
+			write_failed = true;
+		}
+		next_write_job++;
+		write_cv.notify_all();
+	});
+	
+	if(fclose(file) != 0) write_failed = true;
+	if(write_failed) {
+		a2e_error("couldn't write obj file \"%s\" (disk full?)!", filename);
+		return false;
+	}
+	return true;
+}
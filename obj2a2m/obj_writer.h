@@ -0,0 +1,57 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_OBJ_WRITER_H__
+#define __OBJ2A2M_OBJ_WRITER_H__
+
+#include <a2e.h>
+#include <functional>
+#include "obj_number.h"
+
+// text chunk of the .obj writer (with fast number formatting)
+class obj_text_chunk {
+public:
+	obj_text_chunk() {}
+	
+	void reserve(const size_t size) { text.reserve(size); }
+	void clear() { text.clear(); }
+	const string& get_text() const { return text; }
+	
+	void put(const char* str) { text.append(str); }
+	void put(const string& str) { text.append(str); }
+	void put(const char ch) { text.push_back(ch); }
+	void put_uint(const uint32_t value) {
+		char buffer[obj_number::max_formatted_uint_length];
+		text.append(buffer, obj_number::format_uint(buffer, value));
+	}
+	void put_float(const float value) {
+		char buffer[obj_number::max_formatted_float_length];
+		text.append(buffer, obj_number::format_float(buffer, value));
+	}
+	
+protected:
+	string text;
+	
+};
+
+// writes job_count text chunks to filename: the chunks are formatted by format_job(job, chunk) on up to
+// thread_count tasks and written in job order, so that only about thread_count chunks are in memory at once
+bool write_text_chunks(const string& filename, const size_t job_count, const unsigned int thread_count,
+					   const function<void(const size_t job, obj_text_chunk& chunk)>& format_job);
+
+#endif
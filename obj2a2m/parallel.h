@@ -0,0 +1,63 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_PARALLEL_H__
+#define __OBJ2A2M_PARALLEL_H__
+
+#include <a2e.h>
+#include <threading/task.h>
+#include <mutex>
+#include <condition_variable>
+
+// number of worker tasks to use if nothing else was specified
+inline unsigned int default_thread_count() {
+	const unsigned int hw_threads = thread::hardware_concurrency();
+	return (hw_threads == 0 ? 1 : hw_threads);
+}
+
+// runs job(0) ... job(count - 1) on (at most) worker_count tasks and waits until all jobs have finished
+template <typename job_type> void parallel_for(const size_t count, const unsigned int worker_count, const job_type& job) {
+	if(count == 0) return;
+	const size_t task_count = std::min(count, (size_t)std::max(worker_count, 1u));
+	if(task_count == 1) {
+		for(size_t i = 0; i < count; i++) {
+			job(i);
+		}
+		return;
+	}
+	
+	atomic<size_t> next_job { 0 };
+	size_t running_tasks = task_count;
+	mutex done_lock;
+	condition_variable done_cv;
+	for(size_t t = 0; t < task_count; t++) {
+		task::spawn([&]() {
+			for(size_t i = next_job++; i < count; i = next_job++) {
+				job(i);
+			}
+			
+			lock_guard<mutex> lock(done_lock);
+			if(--running_tasks == 0) done_cv.notify_one();
+		});
+	}
+	
+	unique_lock<mutex> lock(done_lock);
+	done_cv.wait(lock, [&running_tasks] { return (running_tasks == 0); });
+}
+
+#endif
@@ -0,0 +1,83 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "spill_file.h"
+#include "obj_parser.h"
+
+// data is appended in large blocks, a big stdio buffer avoids small writes in between
+#define SPILL_FILE_BUFFER_SIZE (1024u * 1024u)
+
+spill_file::~spill_file() {
+	close();
+}
+
+void spill_file::close() {
+	mapping.reset();
+	if(file != nullptr) {
+		fclose(file);
+		file = nullptr;
+	}
+	if(filename != "") {
+		remove(filename.c_str());
+		filename = "";
+	}
+	file_size = 0;
+}
+
+bool spill_file::open(const string& filename_) {
+	filename = filename_;
+	file = fopen(filename.c_str(), "wb");
+	if(file == nullptr) {
+		a2e_error("couldn't create spill file \"%s\"!", filename);
+		filename = "";
+		return false;
+	}
+	setvbuf(file, nullptr, _IOFBF, SPILL_FILE_BUFFER_SIZE);
+	return true;
+}
+
+bool spill_file::append(const void* data, const size_t size) {
+	if(size == 0) return true;
+	if(file == nullptr || fwrite(data, 1, size, file) != size) {
+		a2e_error("couldn't write spill file \"%s\" (disk full?)!", filename);
+		return false;
+	}
+	file_size += size;
+	return true;
+}
+
+bool spill_file::finish() {
+	if(file == nullptr) return false;
+	const bool flushed = (fclose(file) == 0);
+	file = nullptr;
+	if(!flushed) {
+		a2e_error("couldn't write spill file \"%s\" (disk full?)!", filename);
+		return false;
+	}
+	
+	mapping.reset(new mapped_file(filename.c_str()));
+	if(!mapping->is_open() || mapping->get_size() != file_size) {
+		a2e_error("couldn't map spill file \"%s\"!", filename);
+		return false;
+	}
+	return true;
+}
+
+const unsigned char* spill_file::data() const {
+	return (mapping != nullptr ? (const unsigned char*)mapping->get_data() : nullptr);
+}
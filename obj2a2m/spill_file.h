@@ -0,0 +1,57 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_SPILL_FILE_H__
+#define __OBJ2A2M_SPILL_FILE_H__
+
+#include <a2e.h>
+
+class mapped_file;
+
+// temporary file for the out-of-core conversion: data is appended sequentially and the file is
+// memory-mapped for reading once it is complete (the file is deleted when the spill_file is destroyed)
+class spill_file {
+public:
+	spill_file() {}
+	~spill_file();
+	
+	// creates (or truncates) the file
+	bool open(const string& filename);
+	bool append(const void* data, const size_t size);
+	// flushes and maps the file, no more data can be appended afterwards
+	bool finish();
+	
+	// unmaps and deletes the file (also done by the destructor)
+	void close();
+	
+	// only valid after finish()
+	const unsigned char* data() const;
+	size_t size() const { return file_size; }
+	
+protected:
+	string filename = "";
+	FILE* file = nullptr;
+	size_t file_size = 0;
+	unique_ptr<mapped_file> mapping;
+	
+	spill_file(const spill_file&) = delete;
+	spill_file& operator=(const spill_file&) = delete;
+	
+};
+
+#endif
@@ -0,0 +1,206 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "vertex_cache.h"
+
+vertex_cache_stats measure_vertex_cache(const s_index* indices, const size_t triangle_count, const size_t vertex_count) {
+	// fifo cache: a vertex is cached if it was transformed less than VERTEX_CACHE_SIZE transforms ago
+	vector<size_t> transform_time(vertex_count, 0);
+	size_t transforms = 0;
+	for(size_t i = 0; i < triangle_count; i++) {
+		for(unsigned int k = 0; k < 3; k++) {
+			size_t& time = transform_time[indices[i].indices[k]];
+			if(time == 0 || transforms - time >= VERTEX_CACHE_SIZE) {
+				transforms++;
+				time = transforms;
+			}
+		}
+	}
+	return vertex_cache_stats {
+		(triangle_count > 0 ? (float)transforms / (float)triangle_count : 0.0f),
+		(vertex_count > 0 ? (float)transforms / (float)vertex_count : 0.0f),
+	};
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// forsyth vertex cache optimization
+
+// scoring constants of the original paper
+static constexpr float cache_decay_power = 1.5f;
+static constexpr float last_triangle_score = 0.75f;
+static constexpr float valence_boost_scale = 2.0f;
+static constexpr float valence_boost_power = 0.5f;
+static constexpr unsigned int max_valence = 64;
+
+class forsyth_scores {
+public:
+	forsyth_scores() {
+		for(unsigned int pos = 0; pos < VERTEX_CACHE_SIZE; pos++) {
+			if(pos < 3) {
+				// the vertices of the last triangle get a fixed score (discourages using the same triangle edge twice)
+				cache_scores[pos] = last_triangle_score;
+			}
+			else {
+				const float scaler = 1.0f / (float)(VERTEX_CACHE_SIZE - 3);
+				cache_scores[pos] = powf(1.0f - (float)(pos - 3) * scaler, cache_decay_power);
+			}
+		}
+		valence_scores[0] = 0.0f;
+		for(unsigned int valence = 1; valence < max_valence; valence++) {
+			// bonus for vertices with only a few remaining triangles (gets rid of lone vertices)
+			valence_scores[valence] = valence_boost_scale * powf((float)valence, -valence_boost_power);
+		}
+	}
+	
+	float vertex_score(const int cache_pos, const unsigned int remaining_triangles) const {
+		// no triangles left that use this vertex
+		if(remaining_triangles == 0) return -1.0f;
+		
+		const float cache_score = (cache_pos < 0 ? 0.0f : cache_scores[cache_pos]);
+		const float valence_score = (remaining_triangles < max_valence ?
+									 valence_scores[remaining_triangles] :
+									 valence_boost_scale * powf((float)remaining_triangles, -valence_boost_power));
+		return cache_score + valence_score;
+	}
+	
+protected:
+	float cache_scores[VERTEX_CACHE_SIZE];
+	float valence_scores[max_valence];
+	
+};
+
+void optimize_vertex_cache(s_index* indices, s_index* tex_indices, const size_t triangle_count, const size_t vertex_count) {
+	if(triangle_count == 0) return;
+	static const forsyth_scores scores;
+	
+	// vertex -> triangle adjacency (the triangles of vertex v are [adjacency_offsets[v], adjacency_offsets[v] + remaining[v]))
+	vector<unsigned int> remaining(vertex_count, 0);
+	for(size_t i = 0; i < triangle_count; i++) {
+		for(unsigned int k = 0; k < 3; k++) {
+			remaining[indices[i].indices[k]]++;
+		}
+	}
+	vector<size_t> adjacency_offsets(vertex_count + 1, 0);
+	for(size_t v = 0; v < vertex_count; v++) {
+		adjacency_offsets[v + 1] = adjacency_offsets[v] + remaining[v];
+	}
+	vector<unsigned int> adjacency(adjacency_offsets[vertex_count]);
+	{
+		vector<size_t> fill(adjacency_offsets.cbegin(), adjacency_offsets.cend() - 1);
+		for(size_t i = 0; i < triangle_count; i++) {
+			for(unsigned int k = 0; k < 3; k++) {
+				adjacency[fill[indices[i].indices[k]]++] = (unsigned int)i;
+			}
+		}
+	}
+	
+	vector<int> cache_pos(vertex_count, -1);
+	vector<float> vertex_scores(vertex_count);
+	for(size_t v = 0; v < vertex_count; v++) {
+		vertex_scores[v] = scores.vertex_score(-1, remaining[v]);
+	}
+	vector<float> triangle_scores(triangle_count);
+	vector<bool> emitted(triangle_count, false);
+	for(size_t i = 0; i < triangle_count; i++) {
+		triangle_scores[i] = (vertex_scores[indices[i].indices[0]] +
+							  vertex_scores[indices[i].indices[1]] +
+							  vertex_scores[indices[i].indices[2]]);
+	}
+	
+	// lru cache (+ room for the 3 vertices of the new triangle)
+	unsigned int cache[VERTEX_CACHE_SIZE + 3];
+	unsigned int cache_size = 0;
+	
+	vector<unsigned int> order;
+	order.reserve(triangle_count);
+	size_t best_triangle = 0;
+	size_t input_cursor = 0;
+	while(order.size() < triangle_count) {
+		// emit the best triangle and remove it from the adjacency of its vertices
+		order.push_back((unsigned int)best_triangle);
+		emitted[best_triangle] = true;
+		
+		unsigned int new_cache[VERTEX_CACHE_SIZE + 3];
+		unsigned int new_cache_size = 0;
+		for(unsigned int k = 0; k < 3; k++) {
+			const unsigned int v = indices[best_triangle].indices[k];
+			unsigned int* triangles = &adjacency[adjacency_offsets[v]];
+			for(unsigned int j = 0; j < remaining[v]; j++) {
+				if(triangles[j] == best_triangle) {
+					triangles[j] = triangles[remaining[v] - 1];
+					remaining[v]--;
+					break;
+				}
+			}
+			// degenerate triangles can contain a vertex more than once
+			if(find(new_cache, new_cache + new_cache_size, v) == new_cache + new_cache_size) {
+				new_cache[new_cache_size++] = v;
+			}
+		}
+		for(unsigned int i = 0; i < cache_size; i++) {
+			if(find(new_cache, new_cache + new_cache_size, cache[i]) == new_cache + new_cache_size) {
+				new_cache[new_cache_size++] = cache[i];
+			}
+		}
+		
+		// update the vertex scores (vertices that fell out of the cache are reset)
+		for(unsigned int i = 0; i < new_cache_size; i++) {
+			const unsigned int v = new_cache[i];
+			cache_pos[v] = (i < VERTEX_CACHE_SIZE ? (int)i : -1);
+			vertex_scores[v] = scores.vertex_score(cache_pos[v], remaining[v]);
+		}
+		cache_size = std::min(new_cache_size, (unsigned int)VERTEX_CACHE_SIZE);
+		copy(new_cache, new_cache + cache_size, cache);
+		
+		// update the scores of all triangles that use cached (or just evicted) vertices and find the best one
+		float best_score = -1.0f;
+		for(unsigned int i = 0; i < new_cache_size; i++) {
+			const unsigned int v = new_cache[i];
+			const unsigned int* triangles = &adjacency[adjacency_offsets[v]];
+			for(unsigned int j = 0; j < remaining[v]; j++) {
+				const unsigned int t = triangles[j];
+				triangle_scores[t] = (vertex_scores[indices[t].indices[0]] +
+									  vertex_scores[indices[t].indices[1]] +
+									  vertex_scores[indices[t].indices[2]]);
+				if(triangle_scores[t] > best_score) {
+					best_score = triangle_scores[t];
+					best_triangle = t;
+				}
+			}
+		}
+		
+		// nothing adjacent to the cache left: continue with the next triangle in input order
+		if(best_score < 0.0f) {
+			while(input_cursor < triangle_count && emitted[input_cursor]) input_cursor++;
+			best_triangle = input_cursor;
+		}
+	}
+	
+	// apply the new triangle order
+	vector<s_index> reordered(triangle_count);
+	for(size_t i = 0; i < triangle_count; i++) {
+		reordered[i] = indices[order[i]];
+	}
+	copy(reordered.cbegin(), reordered.cend(), indices);
+	if(tex_indices != nullptr) {
+		for(size_t i = 0; i < triangle_count; i++) {
+			reordered[i] = tex_indices[order[i]];
+		}
+		copy(reordered.cbegin(), reordered.cend(), tex_indices);
+	}
+}
@@ -0,0 +1,62 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_VERTEX_CACHE_H__
+#define __OBJ2A2M_VERTEX_CACHE_H__
+
+#include <a2e.h>
+#include "obj_model.h"
+
+// size of the simulated post-transform vertex cache
+#define VERTEX_CACHE_SIZE 32
+
+struct vertex_cache_stats {
+	float acmr; // average cache miss ratio: transformed vertices per triangle
+	float atvr; // average transform to vertex ratio: transformed vertices per vertex (1.0 is optimal)
+};
+
+// simulates a fifo post-transform cache of VERTEX_CACHE_SIZE entries for the given triangles
+vertex_cache_stats measure_vertex_cache(const s_index* indices, const size_t triangle_count, const size_t vertex_count);
+
+// reorders the triangles for post-transform vertex cache reuse (tom forsyth's "linear-speed vertex cache optimisation"),
+// tex_indices (if not nullptr) are reordered along with the vertex indices
+void optimize_vertex_cache(s_index* indices, s_index* tex_indices, const size_t triangle_count, const size_t vertex_count);
+
+// renumbers the elements (vertices or texture coordinates) in the order they are first used by the triangles and
+// reorders the elements accordingly, unused elements are moved to the end
+template <typename T> void reorder_first_use(s_index* indices, const size_t triangle_count, T* elements, const size_t element_count) {
+	static const unsigned int unused = ~0u;
+	vector<unsigned int> remap(element_count, unused);
+	unsigned int next_index = 0;
+	for(size_t i = 0; i < triangle_count; i++) {
+		for(unsigned int k = 0; k < 3; k++) {
+			unsigned int& index = indices[i].indices[k];
+			if(remap[index] == unused) remap[index] = next_index++;
+			index = remap[index];
+		}
+	}
+	
+	vector<T> reordered(element_count);
+	for(size_t i = 0; i < element_count; i++) {
+		if(remap[i] == unused) remap[i] = next_index++;
+		reordered[remap[i]] = elements[i];
+	}
+	copy(reordered.cbegin(), reordered.cend(), elements);
+}
+
+#endif
@@ -0,0 +1,114 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "vertex_weld.h"
+#include "hash_mix.h"
+
+// hash grid of vertices: the cells are twice the weld epsilon in size (this leaves enough room for the float rounding
+// of equal_vertex), so a vertex can only be equal to the vertices in its own or one of the 26 adjacent cells
+class vertex_weld_grid {
+public:
+	// the vertices must be added in index order (0, 1, 2, ...), vertices behind the last added one may still change
+	vertex_weld_grid(const vector<float3>& vertices) : vertices(vertices) {
+		cells.reserve(vertices.size());
+		next.reserve(vertices.size());
+	}
+	
+	static constexpr unsigned int invalid_index = ~0u;
+	
+	// returns the index of the first added vertex that is equal to the given one (or invalid_index if there is none)
+	unsigned int find(const float3& vertex) const {
+		int64_t cx, cy, cz;
+		cell_coords(vertex, cx, cy, cz);
+		
+		unsigned int found = invalid_index;
+		for(int64_t x = cx - 1; x <= cx + 1; x++) {
+			for(int64_t y = cy - 1; y <= cy + 1; y++) {
+				for(int64_t z = cz - 1; z <= cz + 1; z++) {
+					const auto cell = cells.find(cell_key(x, y, z));
+					if(cell == cells.end()) continue;
+					for(unsigned int idx = cell->second; idx != invalid_index; idx = next[idx]) {
+						if(idx < found && equal_vertex(vertices[idx], vertex)) found = idx;
+					}
+				}
+			}
+		}
+		return found;
+	}
+	
+	void add(const unsigned int index) {
+		int64_t cx, cy, cz;
+		cell_coords(vertices[index], cx, cy, cz);
+		
+		// prepend to the cell list
+		const auto cell = cells.insert(make_pair(cell_key(cx, cy, cz), index));
+		next.push_back(cell.second ? invalid_index : cell.first->second);
+		cell.first->second = index;
+	}
+	
+protected:
+	static constexpr double inv_cell_size = 1.0 / (2.0 * (double)VERTEX_WELD_EPSILON);
+	
+	struct cell_key_hash {
+		size_t operator()(const uint64_t key) const {
+			return (size_t)hash_mix64(key);
+		}
+	};
+	
+	// cell -> last added vertex in this cell, the other ones are linked through next
+	unordered_map<uint64_t, unsigned int, cell_key_hash> cells;
+	vector<unsigned int> next;
+	const vector<float3>& vertices;
+	
+	static void cell_coords(const float3& vertex, int64_t& cx, int64_t& cy, int64_t& cz) {
+		cx = (int64_t)floor((double)vertex.x * inv_cell_size);
+		cy = (int64_t)floor((double)vertex.y * inv_cell_size);
+		cz = (int64_t)floor((double)vertex.z * inv_cell_size);
+	}
+	
+	// 21 bits per axis, wrapping cells only lead to additional (rejected) candidates
+	static uint64_t cell_key(const int64_t cx, const int64_t cy, const int64_t cz) {
+		return ((((uint64_t)cx & 0x1FFFFFULL) << 42) | (((uint64_t)cy & 0x1FFFFFULL) << 21) | ((uint64_t)cz & 0x1FFFFFULL));
+	}
+	
+};
+constexpr unsigned int vertex_weld_grid::invalid_index;
+
+size_t weld_vertices(vector<float3>& vertices, vector<unsigned int>& remap) {
+	vertex_weld_grid grid(vertices);
+	remap.resize(vertices.size());
+	unsigned int kept_count = 0;
+	for(size_t i = 0; i < vertices.size(); i++) {
+		const float3 vertex = vertices[i];
+		// with sorted vertices, the previously kept vertex is the most likely match, otherwise look it up in the grid
+		const unsigned int equal_index = ((kept_count > 0 && equal_vertex(vertices[kept_count - 1], vertex)) ?
+										  kept_count - 1 : grid.find(vertex));
+		if(equal_index != vertex_weld_grid::invalid_index) {
+			remap[i] = equal_index;
+			continue;
+		}
+		
+		vertices[kept_count] = vertex;
+		grid.add(kept_count);
+		remap[i] = kept_count++;
+	}
+	
+	const size_t welded_count = vertices.size() - kept_count;
+	vertices.resize(kept_count);
+	return welded_count;
+}
@@ -0,0 +1,46 @@
+/*
+ *  obj2a2m - Alias Wavefront .obj -> A2E .a2m Converter
+ *  Copyright (C) 2004 - 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_VERTEX_WELD_H__
+#define __OBJ2A2M_VERTEX_WELD_H__
+
+#include <a2e.h>
+
+#define VERTEX_WELD_EPSILON 0.001f
+
+inline bool equal_vertex(const float3& v1, const float3& v2) {
+	const static float epsilon = VERTEX_WELD_EPSILON;
+	if(((v1.x - epsilon) < v2.x) && (v2.x < (v1.x + epsilon))) {
+		if(((v1.y - epsilon) < v2.y) && (v2.y < (v1.y + epsilon))) {
+			if(((v1.z - epsilon) < v2.z) && (v2.z < (v1.z + epsilon))) {
+				return true;
+			}
+			else return false;
+		}
+		else return false;
+	}
+	return false;
+}
+
+// welds all vertices that are equal (see equal_vertex) to a previous vertex in the given order:
+// the welded vertices are removed from vertices and remap is set to the new index of each former vertex.
+// candidates are looked up in a hash grid of epsilon sized cells, so each vertex is resolved in O(1).
+// returns the amount of welded vertices.
+size_t weld_vertices(vector<float3>& vertices, vector<unsigned int>& remap);
+
+#endif
@@ -0,0 +1,1144 @@
+/*
+ *  obj2a2m_bench - obj2a2m benchmarks
+ *  Copyright (C) 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "obj2a2m_bench.h"
+#include <random>
+
+/*!
+ * \mainpage
+ *
+ * \author flo
+ *
+ * \date December 2012
+ *
+ * Albion 2 Engine Tool - obj2a2m benchmarks
+ */
+
+static unsigned int thread_count = default_thread_count();
+
+static bool same_float(const float f1, const float f2) {
+	return (memcmp(&f1, &f2, sizeof(float)) == 0);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// number parsing
+
+// creates count space separated floats in the formats that are usually found in .obj files
+static string make_float_text(const size_t count) {
+	mt19937 gen(0x0B12A2);
+	uniform_real_distribution<float> coord_dist(-1000.0f, 1000.0f);
+	uniform_real_distribution<float> unit_dist(0.0f, 1.0f);
+	string text;
+	text.reserve(count * 14);
+	char num_str[64];
+	for(size_t i = 0; i < count; i++) {
+		switch(i % 5) {
+			case 0: snprintf(num_str, sizeof(num_str), "%.6f ", coord_dist(gen)); break;
+			case 1: snprintf(num_str, sizeof(num_str), "%.6f ", unit_dist(gen)); break;
+			case 2: snprintf(num_str, sizeof(num_str), "%g ", coord_dist(gen)); break;
+			case 3: snprintf(num_str, sizeof(num_str), "%.9g ", unit_dist(gen) * 0.001f); break;
+			case 4: snprintf(num_str, sizeof(num_str), "%e ", coord_dist(gen)); break;
+		}
+		text += num_str;
+	}
+	return text;
+}
+
+// creates count space separated "v/vt/vn" face corners
+static string make_corner_text(const size_t count) {
+	mt19937 gen(0xFACE);
+	uniform_int_distribution<unsigned int> index_dist(1, 5000000);
+	string text;
+	text.reserve(count * 24);
+	char corner_str[64];
+	for(size_t i = 0; i < count; i++) {
+		snprintf(corner_str, sizeof(corner_str), "%u/%u/%u ", index_dist(gen), index_dist(gen), index_dist(gen));
+		text += corner_str;
+	}
+	return text;
+}
+
+// returns the number of values that didn't parse or round-trip exactly
+static size_t bench_numbers(const size_t count) {
+	a2e_log("number parsing and formatting (%u values):", count);
+	
+	// floats
+	const string float_text = make_float_text(count);
+	const char* text_begin = float_text.c_str();
+	const char* text_end = text_begin + float_text.size();
+	
+	vector<float> reference, values;
+	reference.reserve(count);
+	values.reserve(count);
+	for(const char* cur = text_begin; cur < text_end; cur++) {
+		char* num_end;
+		reference.push_back(strtof(cur, &num_end));
+		cur = num_end;
+	}
+	
+	const double strtof_time = bench_time([&]() {
+		values.clear();
+		for(const char* cur = text_begin; cur < text_end; cur++) {
+			char* num_end;
+			values.push_back(strtof(cur, &num_end));
+			cur = num_end;
+		}
+	});
+	const double string2float_time = bench_time([&]() {
+		// the way load_obj_data converts values: a token string per value
+		values.clear();
+		string token;
+		token.reserve(64);
+		for(const char* cur = text_begin; cur < text_end; cur++) {
+			const char* token_end = (const char*)memchr(cur, ' ', (size_t)(text_end - cur));
+			token.assign(cur, token_end);
+			values.push_back(string2float(token));
+			cur = token_end;
+		}
+	});
+	const double obj_number_time = bench_time([&]() {
+		values.clear();
+		float value;
+		for(const char* cur = text_begin; cur < text_end; cur++) {
+			if(!obj_number::parse_float(cur, text_end, value)) break;
+			values.push_back(value);
+		}
+	});
+	
+	size_t mismatches = (values.size() != reference.size() ? count : 0);
+	for(size_t i = 0; i < std::min(values.size(), reference.size()); i++) {
+		if(!same_float(values[i], reference[i])) mismatches++;
+	}
+	if(mismatches > 0) a2e_error("obj_number::parse_float: %u values differ from strtof!", mismatches);
+	size_t failures = mismatches;
+	
+	// numbers that are longer than the stack buffer of the fallback must still be parsed as one value
+	const string long_text = "0." + string(70, '0') + "1 1 " + string(80, '1') + ".5 2 -1." + string(100, '9') + "e-3 3 ";
+	vector<float> long_reference, long_values;
+	for(const char* cur = long_text.c_str(); *cur != 0; cur++) {
+		char* num_end;
+		long_reference.push_back(strtof(cur, &num_end));
+		cur = num_end;
+	}
+	for(const char* cur = long_text.c_str(); cur < long_text.c_str() + long_text.size(); cur++) {
+		float value;
+		if(!obj_number::parse_float(cur, long_text.c_str() + long_text.size(), value)) break;
+		long_values.push_back(value);
+	}
+	if(long_values.size() != long_reference.size() ||
+	   !equal(long_values.begin(), long_values.end(), long_reference.begin(), same_float)) {
+		a2e_error("obj_number::parse_float: long numbers differ from strtof!");
+		failures++;
+	}
+	
+	a2e_log("\tfloat: string2float: %f Mvalues/s, strtof: %f Mvalues/s, obj_number: %f Mvalues/s",
+			(double)count / string2float_time / 1.0e6, (double)count / strtof_time / 1.0e6, (double)count / obj_number_time / 1.0e6);
+	
+	// face corners
+	const string corner_text = make_corner_text(count);
+	text_begin = corner_text.c_str();
+	text_end = text_begin + corner_text.size();
+	
+	vector<int> corner_reference, corner_values;
+	corner_reference.reserve(count * 3);
+	corner_values.reserve(count * 3);
+	for(const char* cur = text_begin; cur < text_end; cur++) {
+		char* num_end;
+		for(unsigned int i = 0; i < 3; i++) {
+			corner_reference.push_back((int)strtol(cur, &num_end, 10));
+			cur = num_end + (i < 2 ? 1 : 0);
+		}
+	}
+	
+	const double strtol_time = bench_time([&]() {
+		corner_values.clear();
+		for(const char* cur = text_begin; cur < text_end; cur++) {
+			char* num_end;
+			for(unsigned int i = 0; i < 3; i++) {
+				corner_values.push_back((int)strtol(cur, &num_end, 10));
+				cur = num_end + (i < 2 ? 1 : 0);
+			}
+		}
+	});
+	const double corner_time = bench_time([&]() {
+		corner_values.clear();
+		int vertex_index, coord_index, normal_index;
+		for(const char* cur = text_begin; cur < text_end; cur++) {
+			if(!obj_number::parse_face_corner(cur, text_end, vertex_index, coord_index, normal_index)) break;
+			corner_values.push_back(vertex_index);
+			corner_values.push_back(coord_index);
+			corner_values.push_back(normal_index);
+		}
+	});
+	if(corner_values != corner_reference) {
+		a2e_error("obj_number::parse_face_corner: indices differ from strtol!");
+		failures++;
+	}
+	
+	a2e_log("\tface corner: strtol: %f Mcorners/s, obj_number: %f Mcorners/s",
+			(double)count / strtol_time / 1.0e6, (double)count / corner_time / 1.0e6);
+	
+	// float formatting (-to_obj writer)
+	string format_text;
+	format_text.reserve(count * obj_number::max_formatted_float_length);
+	const double ostream_time = bench_time([&]() {
+		// the way the -to_obj writer used to write values
+		stringstream buffer;
+		for(const auto& value : reference) {
+			buffer << value << " ";
+		}
+		format_text = buffer.str();
+	});
+	const double snprintf_time = bench_time([&]() {
+		format_text.clear();
+		char num_buffer[32];
+		for(const auto& value : reference) {
+			const int len = snprintf(num_buffer, sizeof(num_buffer), "%.9g ", (double)value);
+			format_text.append(num_buffer, (size_t)len);
+		}
+	});
+	const double format_time = bench_time([&]() {
+		format_text.clear();
+		char num_buffer[obj_number::max_formatted_float_length + 1];
+		for(const auto& value : reference) {
+			const size_t len = obj_number::format_float(num_buffer, value);
+			num_buffer[len] = ' ';
+			format_text.append(num_buffer, len + 1);
+		}
+	});
+	
+	// formatted values must be read back exactly
+	values.clear();
+	text_begin = format_text.c_str();
+	text_end = text_begin + format_text.size();
+	float value;
+	for(const char* cur = text_begin; cur < text_end; cur++) {
+		if(!obj_number::parse_float(cur, text_end, value)) break;
+		values.push_back(value);
+	}
+	mismatches = (values.size() != reference.size() ? count : 0);
+	for(size_t i = 0; i < std::min(values.size(), reference.size()); i++) {
+		if(!same_float(values[i], reference[i])) mismatches++;
+	}
+	if(mismatches > 0) a2e_error("obj_number::format_float: %u values don't round-trip!", mismatches);
+	failures += mismatches;
+	
+	a2e_log("\tfloat formatting: ostream: %f Mvalues/s, snprintf (%%.9g): %f Mvalues/s, obj_number: %f Mvalues/s",
+			(double)count / ostream_time / 1.0e6, (double)count / snprintf_time / 1.0e6, (double)count / format_time / 1.0e6);
+	return failures;
+}
+
+// round-trips every finite float through its shortest exact ("%.9g") and fixed ("%.6f") representation
+// and compares obj_number::parse_float against strtof (and the original value), returns the number of failures
+static size_t verify_floats() {
+	a2e_log("verifying obj_number::parse_float against strtof for all 2^32 bit patterns ...");
+	
+	static const size_t job_count = 4096;
+	atomic<unsigned long long int> mismatches { 0 }, round_trip_errors { 0 }, finished_jobs { 0 };
+	parallel_for(job_count, thread_count, [&](const size_t job) {
+		const uint64_t first = (0x100000000ULL / job_count) * job;
+		const uint64_t last = first + (0x100000000ULL / job_count);
+		char num_str[64];
+		for(uint64_t bits = first; bits < last; bits++) {
+			const uint32_t float_bits = (uint32_t)bits;
+			float org_value;
+			memcpy(&org_value, &float_bits, sizeof(float));
+			if(!std::isfinite(org_value)) continue;
+			
+			for(unsigned int fmt = 0; fmt < 2; fmt++) {
+				// fixed notation is only interesting for the usual .obj range
+				if(fmt == 1 && fabsf(org_value) > 1.0e7f) continue;
+				const int len = snprintf(num_str, sizeof(num_str), (fmt == 0 ? "%.9g" : "%.6f"), (double)org_value);
+				
+				const float ref_value = strtof(num_str, nullptr);
+				const char* cur = num_str;
+				float value = 0.0f;
+				if(!obj_number::parse_float(cur, num_str + len, value) || !same_float(value, ref_value) || cur != num_str + len) {
+					if(mismatches++ < 16) a2e_error("mismatch for \"%s\": %f != %f", num_str, value, ref_value);
+				}
+				if(fmt == 0 && !same_float(value, org_value)) round_trip_errors++;
+			}
+		}
+		const unsigned long long int done = ++finished_jobs;
+		if((done % (job_count / 16)) == 0) a2e_log("\t%u%% ...", (unsigned int)((done * 100) / job_count));
+	});
+	
+	if(mismatches == 0 && round_trip_errors == 0) a2e_log("all values parsed exactly!");
+	else a2e_error("%u mismatches, %u round-trip errors!", (unsigned long long int)mismatches, (unsigned long long int)round_trip_errors);
+	return (size_t)(mismatches + round_trip_errors);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// a2m writing
+
+// writes the a2m data of a synthetic single sub-object model (vertex_count vertices and coords, 2 * vertex_count triangles)
+// with per-value file_io calls (the way obj2a2m used to write a2m files) and with all a2m_buffer write modes
+static void bench_a2m_write(const size_t vertex_count) {
+	a2e_log("a2m writing (%u vertices, %u triangles):", vertex_count, vertex_count * 2);
+	
+	mt19937 gen(0xA2E);
+	uniform_real_distribution<float> coord_dist(-1000.0f, 1000.0f);
+	uniform_int_distribution<unsigned int> index_dist(0, (unsigned int)vertex_count - 1);
+	vector<float3> vertices(vertex_count);
+	vector<coord> coords(vertex_count);
+	vector<unsigned int> indices(vertex_count * 6), tex_indices(vertex_count * 6);
+	for(auto& vertex : vertices) {
+		vertex.x = coord_dist(gen);
+		vertex.y = coord_dist(gen);
+		vertex.z = coord_dist(gen);
+	}
+	for(auto& tex_coord : coords) {
+		tex_coord.u = coord_dist(gen);
+		tex_coord.v = coord_dist(gen);
+	}
+	for(auto& index : indices) index = index_dist(gen);
+	for(auto& index : tex_indices) index = index_dist(gen);
+	
+	static const char* filename = "obj2a2m_bench_write.a2m";
+	const bool rotate = true;
+	const string obj_name = "object";
+	
+	const double file_io_time = bench_time([&]() {
+		file_io f;
+		if(!f.open(filename, file_io::OPEN_TYPE::WRITE_BINARY)) return;
+		f.write_block("A2EMODEL", 8);
+		f.write_uint(2);
+		f.write_char(0x00);
+		f.write_uint((unsigned int)vertex_count);
+		f.write_uint((unsigned int)vertex_count);
+		for(const auto& vertex : vertices) {
+			f.write_float(vertex.x);
+			f.write_float(rotate ? vertex.z : vertex.y);
+			f.write_float(rotate ? -vertex.y : vertex.z);
+		}
+		for(const auto& tex_coord : coords) {
+			f.write_float(tex_coord.u);
+			f.write_float(tex_coord.v);
+		}
+		f.write_uint(1);
+		f.write_terminated_block(obj_name, (char)0xFF);
+		f.write_uint((unsigned int)indices.size() / 3);
+		for(const auto& index : indices) f.write_uint(index);
+		for(const auto& index : tex_indices) f.write_uint(index);
+		f.close();
+	});
+	
+	size_t file_size = 0;
+	auto buffered_write = [&](const A2M_WRITE_MODE mode) {
+		vector<a2m_buffer> sections(3);
+		sections[0].put_block("A2EMODEL", 8);
+		sections[0].put_uint(2);
+		sections[0].put_char(0x00);
+		sections[0].put_uint((unsigned int)vertex_count);
+		sections[0].put_uint((unsigned int)vertex_count);
+		sections[1].reserve(vertex_count * (sizeof(float3) + sizeof(coord)));
+		sections[1].put_vertices(vertices.data(), vertex_count, rotate);
+		sections[1].put_floats((const float*)coords.data(), vertex_count * 2);
+		sections[2].reserve(sizeof(unsigned int) * (2 + indices.size() * 2) + obj_name.size() + 1);
+		sections[2].put_uint(1);
+		sections[2].put_terminated_block(obj_name, (char)0xFF);
+		sections[2].put_uint((unsigned int)indices.size() / 3);
+		sections[2].put_uints(indices.data(), indices.size());
+		sections[2].put_uints(tex_indices.data(), tex_indices.size());
+		write_a2m_buffers(filename, sections, mode);
+		file_size = sections[0].size() + sections[1].size() + sections[2].size();
+	};
+	const double buffered_time = bench_time([&]() { buffered_write(A2M_WRITE_MODE::BUFFERED); });
+	const double writev_time = bench_time([&]() { buffered_write(A2M_WRITE_MODE::WRITEV); });
+	const double mmap_time = bench_time([&]() { buffered_write(A2M_WRITE_MODE::MMAP); });
+	remove(filename);
+	
+	const double mb_size = (double)file_size / (1024.0 * 1024.0);
+	a2e_log("	file_io (per value): %f MB/s, buffered: %f MB/s, writev: %f MB/s, mmap: %f MB/s",
+			mb_size / file_io_time, mb_size / buffered_time, mb_size / writev_time, mb_size / mmap_time);
+	
+	// swizzle kernels
+	vector<float3> rotated(vertices);
+	const double scalar_rotate_time = bench_time([&]() {
+		for(auto& vertex : rotated) {
+			const float y = vertex.y;
+			vertex.y = vertex.z;
+			vertex.z = -y;
+		}
+	});
+	const double rotate_time = bench_time([&]() {
+		rotate_vertices((float*)rotated.data(), rotated.size());
+	});
+	vector<unsigned int> swapped(indices.size());
+	const double scalar_swap_time = bench_time([&]() {
+		unsigned char* dst = (unsigned char*)swapped.data();
+		for(const auto& index : indices) {
+			*dst++ = (unsigned char)((index >> 24) & 0xFF);
+			*dst++ = (unsigned char)((index >> 16) & 0xFF);
+			*dst++ = (unsigned char)((index >> 8) & 0xFF);
+			*dst++ = (unsigned char)(index & 0xFF);
+		}
+	});
+	const double swap_time = bench_time([&]() {
+		store_uints_big_endian((unsigned char*)swapped.data(), indices.data(), indices.size());
+	});
+	a2e_log("	rotate: scalar: %f Mvertices/s, rotate_vertices: %f Mvertices/s",
+			(double)vertex_count / scalar_rotate_time / 1.0e6, (double)vertex_count / rotate_time / 1.0e6);
+	a2e_log("	big endian uints: scalar: %f Muints/s, store_uints_big_endian: %f Muints/s",
+			(double)indices.size() / scalar_swap_time / 1.0e6, (double)indices.size() / swap_time / 1.0e6);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// a2m v3 section compression
+
+struct bench_a2m_v3_section {
+	uint32_t type;
+	uint32_t flags;
+	const unsigned char* data;
+	uint64_t size;
+	uint64_t count;
+};
+
+// returns the sections of the a2m v3 file data (or nothing if this isn't a valid a2m v3 file)
+static vector<bench_a2m_v3_section> get_a2m_v3_sections(const vector<unsigned char>& file_data) {
+	vector<bench_a2m_v3_section> sections;
+	if(file_data.size() < A2M_V3_HEADER_SIZE || memcmp(file_data.data(), "A2EMODEL", 8) != 0) return sections;
+	uint32_t version, section_count;
+	uint64_t table_offset;
+	memcpy(&version, &file_data[8], 4);
+	memcpy(&section_count, &file_data[20], 4);
+	memcpy(&table_offset, &file_data[24], 8);
+	if(version != A2M_V3_VERSION || table_offset + section_count * A2M_V3_SECTION_ENTRY_SIZE > file_data.size()) return sections;
+	
+	for(uint32_t i = 0; i < section_count; i++) {
+		const unsigned char* entry = &file_data[table_offset + i * A2M_V3_SECTION_ENTRY_SIZE];
+		bench_a2m_v3_section section;
+		uint64_t offset;
+		memcpy(&section.type, entry, 4);
+		memcpy(&section.flags, entry + 4, 4);
+		memcpy(&offset, entry + 8, 8);
+		memcpy(&section.size, entry + 16, 8);
+		memcpy(&section.count, entry + 24, 8);
+		if(offset + section.size > file_data.size()) return vector<bench_a2m_v3_section>();
+		section.data = &file_data[offset];
+		sections.push_back(section);
+	}
+	return sections;
+}
+
+// compresses the sections of the given a2m v3 files with different zlib levels and measures the compressed size,
+// the compression time and the decompression time (single threaded and with thread_count threads)
+static void bench_a2m_compress(const vector<string>& filenames) {
+	a2e_log("a2m v3 section compression (%u threads):", thread_count);
+	
+	static const int levels[] { 1, A2M_V3_DEFAULT_COMPRESSION_LEVEL, 9 };
+	for(const auto& filename : filenames) {
+		file_io f;
+		if(!f.open(filename, file_io::OPEN_TYPE::READ_BINARY)) continue;
+		vector<unsigned char> file_data((size_t)f.get_filesize());
+		f.get_block((char*)file_data.data(), file_data.size());
+		f.close();
+		
+		const vector<bench_a2m_v3_section> sections = get_a2m_v3_sections(file_data);
+		if(sections.empty()) {
+			a2e_error("\"%s\" is not an a2m v3 file!", filename);
+			continue;
+		}
+		
+		// uncompressed section data
+		vector<vector<unsigned char>> raw_sections(sections.size());
+		size_t raw_size = 0;
+		for(size_t i = 0; i < sections.size(); i++) {
+			if((sections[i].flags & A2M_V3_SECTION_FLAG_ZLIB) != 0) {
+				if(!a2m_v3_decompress_section(sections[i].data, sections[i].size, raw_sections[i], thread_count)) {
+					a2e_error("failed to decompress section #%u of \"%s\"!", i, filename);
+					return;
+				}
+			}
+			else raw_sections[i].assign(sections[i].data, sections[i].data + sections[i].size);
+			raw_size += raw_sections[i].size();
+		}
+		const double raw_mb = (double)raw_size / (1024.0 * 1024.0);
+		a2e_log("	%s: %u sections, %u KB of section data", filename, sections.size(), raw_size / 1024);
+		
+		for(const int level : levels) {
+			vector<unsigned char> compressed_file;
+			const double compress_time = bench_time([&]() {
+				a2m_v3_builder builder;
+				for(size_t i = 0; i < sections.size(); i++) {
+					a2m_buffer data;
+					data.put_block(raw_sections[i].data(), raw_sections[i].size());
+					builder.add_section((A2M_V3_SECTION)sections[i].type, move(data), sections[i].count);
+				}
+				builder.compress(level, thread_count);
+				compressed_file.clear();
+				for(const auto& buffer : builder.finish(0)) {
+					compressed_file.insert(compressed_file.end(), buffer.data(), buffer.data() + buffer.size());
+				}
+			});
+			
+			const vector<bench_a2m_v3_section> compressed_sections = get_a2m_v3_sections(compressed_file);
+			size_t compressed_size = 0;
+			for(const auto& section : compressed_sections) {
+				compressed_size += section.size;
+			}
+			vector<unsigned char> decompressed;
+			auto decompress = [&](const unsigned int decompress_thread_count) {
+				for(const auto& section : compressed_sections) {
+					if((section.flags & A2M_V3_SECTION_FLAG_ZLIB) != 0) {
+						a2m_v3_decompress_section(section.data, section.size, decompressed, decompress_thread_count);
+					}
+				}
+			};
+			const double decompress_time = bench_time([&]() { decompress(1); });
+			const double parallel_decompress_time = bench_time([&]() { decompress(thread_count); });
+			
+			// loading the compressed file is faster if the storage is slower than this
+			const double break_even = (double)(raw_size - std::min(compressed_size, raw_size)) / (1024.0 * 1024.0) / parallel_decompress_time;
+			a2e_log("		zlib level %i: %u KB (%f%%), compress: %f MB/s, decompress: %f MB/s (1 thread), %f MB/s (%u threads), break-even storage bandwidth: %f MB/s",
+					level, compressed_size / 1024, (double)compressed_size * 100.0 / (double)raw_size,
+					raw_mb / compress_time, raw_mb / decompress_time, raw_mb / parallel_decompress_time, thread_count, break_even);
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// a2m loading
+
+// decodes damaged copies of uncompressed a2m v3 file data, all of them must be rejected (without crashing or allocating
+// huge arrays): the file truncated to half its size and to its header, and the first OBJECTS entry inflated and
+// overflowing (first_triangle + triangle_count). returns the number of damaged copies that weren't rejected
+static size_t check_malformed_a2m(const vector<unsigned char>& file_data) {
+	size_t failures = 0;
+	const auto check = [&failures](const vector<unsigned char>& data, const char* damage) {
+		a2m_model model;
+		try {
+			if(!decode_a2m(data.data(), data.size(), model, thread_count)) return;
+			a2e_error("a2m data with %s was accepted!", damage);
+		}
+		catch(const exception& exc) {
+			a2e_error("decoding a2m data with %s failed with an exception: %s", damage, exc.what());
+		}
+		failures++;
+	};
+	
+	check(vector<unsigned char>(file_data.begin(), file_data.begin() + (ptrdiff_t)(file_data.size() / 2)), "half of the file");
+	check(vector<unsigned char>(file_data.begin(), file_data.begin() + A2M_V3_HEADER_SIZE), "only the header");
+	
+	for(const auto& section : get_a2m_v3_sections(file_data)) {
+		if(section.type != (uint32_t)A2M_V3_SECTION::OBJECTS || section.count == 0 || section.size < sizeof(a2m_v3_object)) continue;
+		const size_t object_offset = (size_t)(section.data - file_data.data());
+		const uint32_t damaged_ranges[][2] { { 0, 0x7FFFFFFFu }, { 0xFFFFFFFFu, 0xFFFFFFFFu } };
+		for(const auto& range : damaged_ranges) {
+			vector<unsigned char> damaged_data(file_data);
+			a2m_v3_object object;
+			memcpy(&object, &damaged_data[object_offset], sizeof(a2m_v3_object));
+			object.first_triangle = range[0];
+			object.triangle_count = range[1];
+			memcpy(&damaged_data[object_offset], &object, sizeof(a2m_v3_object));
+			check(damaged_data, (range[0] == 0 ? "an inflated sub-object" : "an overflowing sub-object"));
+		}
+	}
+	return failures;
+}
+
+// converts each .obj file into every a2m layout and measures how long read_a2m takes to load it (with a bulk read
+// and with a mapping, the file is in the page cache), every loaded model is verified against the .obj. for the plain v3
+// layout, the time it would take to unify its separate indices into interleaved vertices and to generate the normals
+// and tangents at load time is measured as well. uncompressed v3 layouts must also reject damaged copies (see
+// check_malformed_a2m). returns the number of failed conversions and checks
+static size_t bench_a2m_load(const vector<string>& filenames) {
+	a2e_log("a2m loading (%u threads):", thread_count);
+	
+	static const char* a2m_filename = "obj2a2m_bench_load.a2m";
+	struct bench_layout {
+		const char* name;
+		bool a2m_v3;
+		bool compact_encoding;
+		bool compress_sections;
+		bool interleaved;
+		bool tangents;
+	};
+	static const bench_layout layouts[] {
+		{ "v2", false, false, false, false, false },
+		{ "v3", true, false, false, false, false },
+		{ "v3 compressed", true, false, true, false, false },
+		{ "v3 compact", true, true, false, false, false },
+		{ "v3 compact compressed", true, true, true, false, false },
+		{ "v3 interleaved", true, false, false, true, false },
+		{ "v3 interleaved compressed", true, false, true, true, false },
+		{ "v3 interleaved tangents", true, false, false, true, true },
+	};
+	size_t failures = 0;
+	for(const auto& filename : filenames) {
+		obj_model model;
+		string mtllib;
+		const bool loaded = (gz_line_stream::is_compressed(filename.c_str()) ?
+							 load_obj_data_gz(false, false, false, thread_count, filename.c_str(), mtllib, model) :
+							 load_obj_data_mapped(false, false, false, thread_count, filename.c_str(), mtllib, model));
+		if(!loaded) {
+			failures++;
+			continue;
+		}
+		const double mtris = (double)model.indices.size() / 1.0e6;
+		a2e_log("\t%s (%u triangles):", filename, model.indices.size());
+		
+		for(const auto& layout : layouts) {
+			conversion_options options;
+			options.thread_count = thread_count;
+			options.a2m_v3 = layout.a2m_v3;
+			options.compact_encoding = layout.compact_encoding;
+			options.compress_sections = layout.compress_sections;
+			options.interleaved = layout.interleaved;
+			options.normals = layout.tangents;
+			options.tangents = layout.tangents;
+			options.obj_filename = filename;
+			options.a2m_filename = a2m_filename;
+			obj2a2m_conversion conversion(options);
+			uint64_t file_size = 0;
+			if(!conversion.convert() || !get_file_size(a2m_filename, file_size)) {
+				a2e_error("failed to convert \"%s\"!", filename);
+				failures++;
+				continue;
+			}
+			
+			a2m_model a2m;
+			const double buffered_time = bench_time([&a2m]() { read_a2m(a2m_filename, a2m, A2M_READ_MODE::BUFFERED, thread_count); });
+			const double mmap_time = bench_time([&a2m]() { read_a2m(a2m_filename, a2m, A2M_READ_MODE::MMAP, thread_count); });
+			const bool verified = verify_a2m_model(a2m, model, nullptr, false, false);
+			
+			const double file_mb = (double)file_size / (1024.0 * 1024.0);
+			a2e_log("\t\t%s: %u KB, buffered: %fms (%f MB/s, %f Mtris/s), mmap: %fms (%f MB/s, %f Mtris/s)%s",
+					layout.name, file_size / 1024,
+					buffered_time * 1000.0, file_mb / buffered_time, mtris / buffered_time,
+					mmap_time * 1000.0, file_mb / mmap_time, mtris / mmap_time,
+					(verified ? "" : " - VERIFICATION FAILED"));
+			if(!verified) failures++;
+			
+			if(layout.a2m_v3 && !layout.compress_sections) {
+				file_io f;
+				if(!f.open(a2m_filename, file_io::OPEN_TYPE::READ_BINARY)) {
+					failures++;
+					continue;
+				}
+				vector<unsigned char> file_data((size_t)f.get_filesize());
+				f.get_block((char*)file_data.data(), file_data.size());
+				f.close();
+				failures += check_malformed_a2m(file_data);
+			}
+			
+			if(layout.a2m_v3 && !layout.compact_encoding && !layout.compress_sections && !layout.interleaved) {
+				vector<s_index> unified_indices(a2m.indices.size());
+				vector<interleaved_vertex> unified_vertices;
+				const double unify_time = bench_time([&a2m, &unified_indices, &unified_vertices]() {
+					interleaved_builder interleaver(a2m.vertices.data(), a2m.vertices.size(), 0, a2m.tex_coords.data(), nullptr, 0, false);
+					interleaver.add_triangles(a2m.indices.data(), a2m.tex_indices.data(), a2m.indices.size(), unified_indices.data());
+					unified_vertices.swap(interleaver.get_vertices());
+				});
+				a2e_log("\t\t\tload time unification: %fms (%u interleaved vertices), mmap + unification: %fms (%f Mtris/s)",
+						unify_time * 1000.0, unified_vertices.size(), (mmap_time + unify_time) * 1000.0, mtris / (mmap_time + unify_time));
+				
+				// smooth normals (no smoothing groups are stored) and tangents of the unified vertices
+				vector<float3> corner_normals;
+				vector<float> positions, tex_coords, normals;
+				vector<vertex_tangent> tangents;
+				const double tangent_time = bench_time([&]() {
+					compute_corner_normals(a2m.vertices.data(), a2m.vertices.size(), a2m.indices.data(), a2m.indices.size(),
+										   nullptr, 0, nullptr, nullptr, corner_normals);
+					const size_t unified_count = unified_vertices.size();
+					positions.resize(unified_count * 3);
+					tex_coords.resize(unified_count * 2);
+					normals.resize(unified_count * 3);
+					for(size_t i = 0; i < unified_count; i++) {
+						memcpy(&positions[i * 3], unified_vertices[i].position, sizeof(float) * 3);
+						memcpy(&tex_coords[i * 2], unified_vertices[i].tex_coord, sizeof(float) * 2);
+					}
+					for(size_t i = 0; i < unified_indices.size(); i++) {
+						const unsigned int* corners = unified_indices[i].indices;
+						for(size_t j = 0; j < 3; j++) {
+							memcpy(&normals[corners[j] * 3], &corner_normals[i * 3 + j], sizeof(float) * 3);
+						}
+					}
+					compute_tangents(positions.data(), tex_coords.data(), normals.data(), unified_count,
+									 unified_indices.data(), unified_indices.size(), tangents);
+				});
+				a2e_log("\t\t\tload time normals + tangents: %fms, mmap + unification + normals + tangents: %fms (%f Mtris/s)",
+						tangent_time * 1000.0, (mmap_time + unify_time + tangent_time) * 1000.0,
+						mtris / (mmap_time + unify_time + tangent_time));
+			}
+		}
+		remove(a2m_filename);
+	}
+	return failures;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// collision bvh
+
+// converts each .obj file (used as model and collision model, it must only have one sub-object) to v3 with and without
+// a precomputed collision bvh and compares loading the stored bvh against building it at load time. then runs random
+// ray and box queries against the bvh and (a subset of them) against all triangles, the results must match.
+// returns the number of failed conversions and mismatching queries
+static size_t bench_collision_bvh(const vector<string>& filenames, const size_t query_count) {
+	a2e_log("collision bvh (%u queries):", query_count);
+	
+	static const char* a2m_filename = "obj2a2m_bench_collision.a2m";
+	static const char* bvh_a2m_filename = "obj2a2m_bench_collision_bvh.a2m";
+	size_t failures = 0;
+	for(const auto& filename : filenames) {
+		bool converted = true;
+		for(const bool collision_bvh : { false, true }) {
+			conversion_options options;
+			options.thread_count = thread_count;
+			options.a2m_v3 = true;
+			options.collision_object = true;
+			options.collision_bvh = collision_bvh;
+			options.obj_filename = filename;
+			options.collision_filename = filename;
+			options.a2m_filename = (collision_bvh ? bvh_a2m_filename : a2m_filename);
+			obj2a2m_conversion conversion(options);
+			if(!conversion.convert()) converted = false;
+		}
+		a2m_model a2m, bvh_a2m;
+		if(!converted || !read_a2m(a2m_filename, a2m) || !read_a2m(bvh_a2m_filename, bvh_a2m)) {
+			a2e_error("failed to convert \"%s\"!", filename);
+			failures++;
+			continue;
+		}
+		const size_t triangle_count = bvh_a2m.collision_indices.size();
+		if(bvh_a2m.collision_bvh.empty()) {
+			a2e_error("\"%s\" has no collision triangles!", filename);
+			failures++;
+			continue;
+		}
+		a2e_log("\t%s (%u collision triangles, %u bvh nodes):", filename, triangle_count, bvh_a2m.collision_bvh.size());
+		
+		// load time: reading the raw collision data and building the bvh vs reading the stored bvh (includes its validation)
+		const double read_time = bench_time([&a2m]() { read_a2m(a2m_filename, a2m); });
+		const double bvh_read_time = bench_time([&bvh_a2m]() { read_a2m(bvh_a2m_filename, bvh_a2m); });
+		vector<collision_bvh_node> built_nodes;
+		const double build_time = bench_time([&a2m, &built_nodes]() {
+			vector<s_index> triangles(a2m.collision_indices);
+			build_collision_bvh(a2m.collision_vertices.data(), triangles, built_nodes);
+		});
+		a2e_log("\t\tload: read + build: %fms (build: %fms, %f Mtris/s), read stored bvh: %fms (%fx)",
+				(read_time + build_time) * 1000.0, build_time * 1000.0, (double)triangle_count / build_time / 1.0e6,
+				bvh_read_time * 1000.0, (read_time + build_time) / bvh_read_time);
+		
+		// random queries inside the (slightly enlarged) bounds of the collision model
+		const collision_bvh_node* nodes = bvh_a2m.collision_bvh.data();
+		const size_t node_count = bvh_a2m.collision_bvh.size();
+		const float3* vertices = bvh_a2m.collision_vertices.data();
+		const s_index* triangles = bvh_a2m.collision_indices.data();
+		const float3 bounds_min(nodes[0].bounds_min[0], nodes[0].bounds_min[1], nodes[0].bounds_min[2]);
+		const float3 bounds_max(nodes[0].bounds_max[0], nodes[0].bounds_max[1], nodes[0].bounds_max[2]);
+		const float3 extent = bounds_max - bounds_min;
+		mt19937 gen(0xB0B);
+		uniform_real_distribution<float> dist(-0.1f, 1.1f);
+		const auto random_point = [&]() {
+			return float3(bounds_min.x + dist(gen) * extent.x, bounds_min.y + dist(gen) * extent.y, bounds_min.z + dist(gen) * extent.z);
+		};
+		vector<float3> ray_origins(query_count), ray_directions(query_count), box_mins(query_count), box_maxs(query_count);
+		const float3 box_half_extent = extent * 0.01f;
+		for(size_t i = 0; i < query_count; i++) {
+			ray_origins[i] = random_point();
+			ray_directions[i] = (random_point() - ray_origins[i]).normalized();
+			const float3 center = random_point();
+			box_mins[i] = center - box_half_extent;
+			box_maxs[i] = center + box_half_extent;
+		}
+		
+		// brute force queries are only run on a subset (they test every triangle)
+		const size_t brute_force_count = std::min(query_count, std::max((size_t)16, (size_t)(20000000 / std::max(triangle_count, (size_t)1))));
+		vector<collision_ray_hit> hits(query_count), brute_force_hits(brute_force_count);
+		vector<bool> hit_found(query_count), brute_force_hit_found(brute_force_count);
+		const double ray_time = bench_time([&]() {
+			for(size_t i = 0; i < query_count; i++) {
+				hit_found[i] = raycast_collision_bvh(nodes, node_count, vertices, triangles, ray_origins[i], ray_directions[i], 1.0e30f, hits[i]);
+			}
+		});
+		const double brute_force_ray_time = bench_time([&]() {
+			for(size_t i = 0; i < brute_force_count; i++) {
+				brute_force_hits[i].t = 1.0e30f;
+				brute_force_hit_found[i] = false;
+				for(size_t j = 0; j < triangle_count; j++) {
+					float t;
+					if(intersect_ray_triangle(ray_origins[i], ray_directions[i], vertices[triangles[j].indices[0]], vertices[triangles[j].indices[1]],
+											  vertices[triangles[j].indices[2]], t) && t <= brute_force_hits[i].t) {
+						brute_force_hits[i].t = t;
+						brute_force_hits[i].triangle = (uint32_t)j;
+						brute_force_hit_found[i] = true;
+					}
+				}
+			}
+		});
+		size_t ray_mismatches = 0, ray_hits = 0;
+		for(size_t i = 0; i < query_count; i++) {
+			if(hit_found[i]) ray_hits++;
+			// (equally distant hits may be on different triangles)
+			if(i < brute_force_count && (hit_found[i] != brute_force_hit_found[i] || (hit_found[i] && hits[i].t != brute_force_hits[i].t))) {
+				ray_mismatches++;
+			}
+		}
+		
+		vector<uint32_t> box_results, brute_force_box_results;
+		size_t box_triangle_count = 0;
+		const double box_time = bench_time([&]() {
+			box_triangle_count = 0;
+			for(size_t i = 0; i < query_count; i++) {
+				box_results.clear();
+				query_collision_bvh_box(nodes, node_count, vertices, triangles, box_mins[i], box_maxs[i], box_results);
+				box_triangle_count += box_results.size();
+			}
+		});
+		const double brute_force_box_time = bench_time([&]() {
+			for(size_t i = 0; i < brute_force_count; i++) {
+				brute_force_box_results.clear();
+				for(size_t j = 0; j < triangle_count; j++) {
+					if(overlaps_triangle_bounds(box_mins[i], box_maxs[i], vertices[triangles[j].indices[0]], vertices[triangles[j].indices[1]],
+												vertices[triangles[j].indices[2]])) {
+						brute_force_box_results.push_back((uint32_t)j);
+					}
+				}
+			}
+		});
+		size_t box_mismatches = 0;
+		for(size_t i = 0; i < brute_force_count; i++) {
+			box_results.clear();
+			brute_force_box_results.clear();
+			query_collision_bvh_box(nodes, node_count, vertices, triangles, box_mins[i], box_maxs[i], box_results);
+			for(size_t j = 0; j < triangle_count; j++) {
+				if(overlaps_triangle_bounds(box_mins[i], box_maxs[i], vertices[triangles[j].indices[0]], vertices[triangles[j].indices[1]],
+											vertices[triangles[j].indices[2]])) {
+					brute_force_box_results.push_back((uint32_t)j);
+				}
+			}
+			sort(box_results.begin(), box_results.end());
+			if(box_results != brute_force_box_results) box_mismatches++;
+		}
+		
+		const double rays_per_second = (double)query_count / ray_time;
+		const double brute_force_rays_per_second = (double)brute_force_count / brute_force_ray_time;
+		const double boxes_per_second = (double)query_count / box_time;
+		const double brute_force_boxes_per_second = (double)brute_force_count / brute_force_box_time;
+		a2e_log("\t\trays: bvh: %f Mrays/s (%u%% hit), brute force: %f Mrays/s (%fx)",
+				rays_per_second / 1.0e6, (unsigned int)((ray_hits * 100) / std::max(query_count, (size_t)1)),
+				brute_force_rays_per_second / 1.0e6, rays_per_second / brute_force_rays_per_second);
+		a2e_log("\t\tboxes: bvh: %f Mqueries/s (%f triangles per query), brute force: %f Mqueries/s (%fx)",
+				boxes_per_second / 1.0e6, (double)box_triangle_count / (double)std::max(query_count, (size_t)1),
+				brute_force_boxes_per_second / 1.0e6, boxes_per_second / brute_force_boxes_per_second);
+		if(ray_mismatches > 0 || box_mismatches > 0) {
+			a2e_error("%u ray and %u box query results differ from the brute force results!", ray_mismatches, box_mismatches);
+			failures += ray_mismatches + box_mismatches;
+		}
+	}
+	remove(a2m_filename);
+	remove(bvh_a2m_filename);
+	return failures;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// conversion
+
+// runs the full conversion of each .obj file (best of runs) with the stream parser, the mapped parser and in out-of-core mode
+// and reports the time and throughput of each phase (see conversion_stats)
+static void bench_conversion(const vector<string>& filenames, const unsigned int runs) {
+	a2e_log("conversion (%u threads, best of %u runs):", thread_count, runs);
+	
+	static const char* a2m_filename = "obj2a2m_bench_convert.a2m";
+	struct bench_config {
+		const char* name;
+		bool mapped_obj;
+		bool out_of_core;
+	};
+	static const bench_config configs[] {
+		{ "stream", false, false },
+		{ "mmap", true, false },
+		{ "out_of_core", false, true },
+	};
+	for(const auto& filename : filenames) {
+		uint64_t obj_size = 0;
+		if(!get_file_size(filename, obj_size)) {
+			a2e_error("couldn't open obj file \"%s\"!", filename);
+			continue;
+		}
+		const double obj_mb = (double)obj_size / (1024.0 * 1024.0);
+		
+		for(const auto& config : configs) {
+			conversion_options options;
+			options.thread_count = thread_count;
+			options.mapped_obj = config.mapped_obj;
+			options.out_of_core = config.out_of_core;
+			options.obj_filename = filename;
+			options.a2m_filename = a2m_filename;
+			
+			// the phase times of the fastest run
+			conversion_result best_result;
+			double best_times[(size_t)CONVERSION_PHASE::__MAX_CONVERSION_PHASE] {};
+			for(unsigned int run = 0; run < std::max(runs, 1u); run++) {
+				obj2a2m_conversion conversion(options);
+				if(!conversion.convert()) {
+					a2e_error("failed to convert \"%s\"!", filename);
+					break;
+				}
+				if(run == 0 || conversion.get_result().time < best_result.time) {
+					best_result = conversion.get_result();
+					for(unsigned int i = 0; i < (unsigned int)CONVERSION_PHASE::__MAX_CONVERSION_PHASE; i++) {
+						best_times[i] = conversion.get_stats().get_time((CONVERSION_PHASE)i);
+					}
+				}
+			}
+			remove(a2m_filename);
+			if(!best_result.success) continue;
+			
+			const double mtris = (double)best_result.triangle_count / 1.0e6;
+			stringstream table;
+			table << fixed << setprecision(3);
+			table << "\t" << filename << " (" << obj_mb << " MB, " << best_result.triangle_count << " triangles), " << config.name << ":" << endl;
+			// (throughput of phases below 1ms is meaningless)
+			auto add_row = [&table, &obj_mb, &mtris](const char* name, const double time) {
+				table << "\t\t" << left << setw(12) << name << right << setw(10) << time << "s";
+				if(time >= 0.001) table << setw(12) << obj_mb / time << " MB/s" << setw(12) << mtris / time << " Mtris/s";
+				table << endl;
+			};
+			for(unsigned int i = 0; i < (unsigned int)CONVERSION_PHASE::__MAX_CONVERSION_PHASE; i++) {
+				add_row(conversion_stats::get_phase_name((CONVERSION_PHASE)i), best_times[i]);
+			}
+			add_row("total", best_result.time);
+			string table_str = table.str();
+			table_str.pop_back();
+			a2e_log("%s", table_str);
+		}
+	}
+}
+
+// generates a set of synthetic .obj files with ~triangle_count triangles each (grid, uv-seamed sphere, quad/triangle mix
+// with uvw texture coordinates, many groups), converts them with bench_conversion and removes them again
+static void bench_synthetic_conversion(const size_t triangle_count, const unsigned int runs) {
+	struct synthetic_obj {
+		const char* filename;
+		OBJ_SHAPE shape;
+		unsigned int group_count;
+		bool quads;
+		bool uvw;
+	};
+	static const synthetic_obj synthetic_objs[] {
+		{ "obj2a2m_bench_grid.obj", OBJ_SHAPE::GRID, 1, true, false },
+		{ "obj2a2m_bench_sphere.obj", OBJ_SHAPE::SPHERE, 1, true, false },
+		{ "obj2a2m_bench_mixed.obj", OBJ_SHAPE::MIXED, 1, true, true },
+		{ "obj2a2m_bench_groups.obj", OBJ_SHAPE::GRID, 256, false, false },
+	};
+	
+	a2e_log("generating synthetic obj files (%u triangles):", triangle_count);
+	vector<string> filenames;
+	for(const auto& synthetic : synthetic_objs) {
+		obj_generator_options options;
+		options.shape = synthetic.shape;
+		options.triangle_count = triangle_count;
+		options.group_count = synthetic.group_count;
+		options.quads = synthetic.quads;
+		options.uvw = synthetic.uvw;
+		obj_generator_result result;
+		bench_timer timer;
+		if(!generate_obj(synthetic.filename, options, &result)) continue;
+		const double time = timer.elapsed();
+		a2e_log("\t%s: %u KB, %u vertices, %u texture coordinates, %u faces, %u triangles (%f MB/s)",
+				synthetic.filename, result.file_size / 1024, result.vertex_count, result.coord_count, result.face_count, result.triangle_count,
+				(double)result.file_size / (1024.0 * 1024.0) / time);
+		filenames.push_back(synthetic.filename);
+	}
+	
+	bench_conversion(filenames, runs);
+	for(const auto& filename : filenames) {
+		remove(filename.c_str());
+	}
+}
+
+// converts synthetic .obj files with "vn" face normals and smoothing groups (see OBJ_NORMALS) with -normals -tangents -verify
+// (in obj order, and rotated with -optimize_cache), so that verify_a2m_normals checks the a2m normals against the obj.
+// returns the amount of failed conversions
+static size_t verify_synthetic_normals(const size_t triangle_count) {
+	static const char* obj_filename = "obj2a2m_bench_normals.obj";
+	static const char* a2m_filename = "obj2a2m_bench_normals.a2m";
+	static const OBJ_SHAPE shapes[] { OBJ_SHAPE::MIXED, OBJ_SHAPE::SPHERE };
+	static const OBJ_NORMALS obj_normals[] { OBJ_NORMALS::FACE, OBJ_NORMALS::SMOOTHING_GROUPS, OBJ_NORMALS::MIXED };
+	
+	a2e_log("verifying the normals of synthetic obj files (%u triangles):", triangle_count);
+	size_t failures = 0;
+	for(const auto& shape : shapes) {
+		for(const auto& normals : obj_normals) {
+			obj_generator_options gen_options;
+			gen_options.shape = shape;
+			gen_options.triangle_count = triangle_count;
+			gen_options.normals = normals;
+			if(!generate_obj(obj_filename, gen_options)) {
+				failures++;
+				continue;
+			}
+			
+			for(unsigned int reorder = 0; reorder < 2; reorder++) {
+				conversion_options options;
+				options.thread_count = thread_count;
+				options.a2m_v3 = true;
+				options.interleaved = true;
+				options.normals = true;
+				options.tangents = true;
+				options.optimize_cache = (reorder != 0);
+				options.rotate_model = (reorder != 0);
+				options.verify = true;
+				options.obj_filename = obj_filename;
+				options.a2m_filename = a2m_filename;
+				obj2a2m_conversion conversion(options);
+				const bool verified = conversion.convert();
+				a2e_log("\t%s, %s normals%s: %s", get_obj_shape_name(shape), get_obj_normals_name(normals),
+						(reorder != 0 ? " (-optimize_cache -rotate_model)" : ""), (verified ? "ok" : "FAILED"));
+				if(!verified) failures++;
+			}
+		}
+	}
+	remove(obj_filename);
+	remove(a2m_filename);
+	return failures;
+}
+
+int main(int argc, char *argv[]) {
+	logger::init();
+	
+	a2e_log("obj2a2m_bench v%u.%u.%u - %s %s", OBJ2A2M_BENCH_MAJOR_VERSION, OBJ2A2M_BENCH_MINOR_VERSION, OBJ2A2M_BENCH_REVISION_VERSION, OBJ2A2M_BENCH_BUILT_DATE, OBJ2A2M_BENCH_BUILT_TIME);
+	
+	string usage = "usage: obj2a2m_bench [-threads count] [-numbers count] [-verify_floats] [-a2m_write vertex_count] [-a2m_compress model.a2m] [-a2m_load model.obj[.gz]]"
+	" [-convert model.obj[.gz]] [-convert_synthetic triangle_count] [-runs count]"
+	" [-gen_obj grid|sphere|mixed triangle_count model.obj] [-groups count] [-triangles_only] [-uvw] [-normals none|face|groups|mixed]"
+	" [-verify_normals triangle_count]"
+	" [-collision_bvh collision.obj] [-queries count]";
+	size_t number_count = 0;
+	size_t write_vertex_count = 0;
+	bool run_verify_floats = false;
+	vector<string> compress_filenames;
+	vector<string> load_filenames;
+	vector<string> convert_filenames;
+	vector<string> collision_filenames;
+	size_t query_count = 100000;
+	size_t synthetic_triangle_count = 0;
+	unsigned int conversion_runs = 3;
+	size_t normals_triangle_count = 0;
+	// -gen_obj files (the -groups, -triangles_only, -uvw and -normals options apply to all of them)
+	vector<pair<string, obj_generator_options>> generate_objs;
+	unsigned int group_count = 1;
+	bool quads = true;
+	bool uvw = false;
+	OBJ_NORMALS obj_normals = OBJ_NORMALS::NONE;
+	for(int i = 1; i < argc; i++) {
+		if(strcmp(argv[i], "-threads") == 0 && i + 1 < argc) {
+			thread_count = std::max(string2uint(argv[++i]), 1u);
+		}
+		else if(strcmp(argv[i], "-numbers") == 0 && i + 1 < argc) {
+			number_count = string2uint(argv[++i]);
+		}
+		else if(strcmp(argv[i], "-verify_floats") == 0) {
+			run_verify_floats = true;
+		}
+		else if(strcmp(argv[i], "-a2m_write") == 0 && i + 1 < argc) {
+			write_vertex_count = string2uint(argv[++i]);
+		}
+		else if(strcmp(argv[i], "-a2m_compress") == 0 && i + 1 < argc) {
+			compress_filenames.push_back(argv[++i]);
+		}
+		else if(strcmp(argv[i], "-a2m_load") == 0 && i + 1 < argc) {
+			load_filenames.push_back(argv[++i]);
+		}
+		else if(strcmp(argv[i], "-convert") == 0 && i + 1 < argc) {
+			convert_filenames.push_back(argv[++i]);
+		}
+		else if(strcmp(argv[i], "-convert_synthetic") == 0 && i + 1 < argc) {
+			synthetic_triangle_count = string2uint(argv[++i]);
+		}
+		else if(strcmp(argv[i], "-collision_bvh") == 0 && i + 1 < argc) {
+			collision_filenames.push_back(argv[++i]);
+		}
+		else if(strcmp(argv[i], "-queries") == 0 && i + 1 < argc) {
+			query_count = std::max(string2uint(argv[++i]), 1u);
+		}
+		else if(strcmp(argv[i], "-runs") == 0 && i + 1 < argc) {
+			conversion_runs = std::max(string2uint(argv[++i]), 1u);
+		}
+		else if(strcmp(argv[i], "-gen_obj") == 0 && i + 3 < argc) {
+			obj_generator_options options;
+			if(!get_obj_shape(argv[i + 1], options.shape)) {
+				a2e_error("unknown shape \"%s\"!\n%s", argv[i + 1], usage.c_str());
+				return -1;
+			}
+			options.triangle_count = string2uint(argv[i + 2]);
+			generate_objs.emplace_back(argv[i + 3], options);
+			i += 3;
+		}
+		else if(strcmp(argv[i], "-groups") == 0 && i + 1 < argc) {
+			group_count = std::max(string2uint(argv[++i]), 1u);
+		}
+		else if(strcmp(argv[i], "-triangles_only") == 0) {
+			quads = false;
+		}
+		else if(strcmp(argv[i], "-uvw") == 0) {
+			uvw = true;
+		}
+		else if(strcmp(argv[i], "-normals") == 0 && i + 1 < argc) {
+			if(!get_obj_normals(argv[++i], obj_normals)) {
+				a2e_error("unknown normals \"%s\"!\n%s", argv[i], usage.c_str());
+				return -1;
+			}
+		}
+		else if(strcmp(argv[i], "-verify_normals") == 0 && i + 1 < argc) {
+			normals_triangle_count = string2uint(argv[++i]);
+		}
+		else {
+			a2e_error("unknown argument \"%s\"!\n%s", argv[i], usage.c_str());
+			return -1;
+		}
+	}
+	
+	// run the number and a2m write benchmarks by default
+	if(number_count == 0 && write_vertex_count == 0 && !run_verify_floats && compress_filenames.empty() && load_filenames.empty() &&
+	   convert_filenames.empty() && synthetic_triangle_count == 0 && generate_objs.empty() && collision_filenames.empty() &&
+	   normals_triangle_count == 0) {
+		number_count = 2000000;
+		write_vertex_count = 1000000;
+	}
+	
+	// failed checks (mismatching numbers, ...) make the bench exit with an error
+	size_t failures = 0;
+	if(number_count > 0) failures += bench_numbers(number_count);
+	if(write_vertex_count > 0) bench_a2m_write(write_vertex_count);
+	if(!compress_filenames.empty()) bench_a2m_compress(compress_filenames);
+	if(!load_filenames.empty()) failures += bench_a2m_load(load_filenames);
+	for(auto& generate : generate_objs) {
+		generate.second.group_count = group_count;
+		generate.second.quads = quads;
+		generate.second.uvw = uvw;
+		generate.second.normals = obj_normals;
+		obj_generator_result result;
+		if(generate_obj(generate.first, generate.second, &result)) {
+			a2e_log("generated \"%s\": %u KB, %u vertices, %u texture coordinates, %u normals, %u faces, %u triangles", generate.first,
+					result.file_size / 1024, result.vertex_count, result.coord_count, result.normal_count, result.face_count,
+					result.triangle_count);
+		}
+	}
+	if(!convert_filenames.empty()) bench_conversion(convert_filenames, conversion_runs);
+	if(synthetic_triangle_count > 0) bench_synthetic_conversion(synthetic_triangle_count, conversion_runs);
+	if(!collision_filenames.empty()) failures += bench_collision_bvh(collision_filenames, query_count);
+	if(normals_triangle_count > 0) failures += verify_synthetic_normals(normals_triangle_count);
+	if(run_verify_floats) failures += verify_floats();
+	
+	if(failures > 0) a2e_error("%u checks failed!", failures);
+	logger::destroy();
+	return (failures > 0 ? 1 : 0);
+}
@@ -0,0 +1,64 @@
+/*
+ *  obj2a2m_bench - obj2a2m benchmarks
+ *  Copyright (C) 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_BENCH_H__
+#define __OBJ2A2M_BENCH_H__
+
+#define OBJ2A2M_BENCH_MAJOR_VERSION 0
+#define OBJ2A2M_BENCH_MINOR_VERSION 1
+#define OBJ2A2M_BENCH_REVISION_VERSION 0
+#define OBJ2A2M_BENCH_BUILT_TIME __TIME__
+#define OBJ2A2M_BENCH_BUILT_DATE __DATE__
+
+#include <a2e.h>
+#include <chrono>
+#include "obj_number.h"
+#include "parallel.h"
+#include "a2m_writer.h"
+#include "a2m_v3.h"
+#include "obj2a2m_conversion.h"
+#include "obj_generator.h"
+
+// wall clock timer (in seconds)
+class bench_timer {
+public:
+	bench_timer() : start(chrono::high_resolution_clock::now()) {}
+	
+	double elapsed() const {
+		return chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+	}
+
+protected:
+	const chrono::high_resolution_clock::time_point start;
+	
+};
+
+// runs the op (at least once) until min_time has passed and returns the time per run
+template <typename op_type> double bench_time(const op_type& op, const double min_time = 0.5) {
+	bench_timer timer;
+	size_t runs = 0;
+	double elapsed = 0.0;
+	do {
+		op();
+		runs++;
+		elapsed = timer.elapsed();
+	} while(elapsed < min_time);
+	return elapsed / (double)runs;
+}
+
+#endif
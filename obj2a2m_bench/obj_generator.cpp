@@ -0,0 +1,285 @@
+/*
+ *  obj2a2m_bench - obj2a2m benchmarks
+ *  Copyright (C) 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "obj_generator.h"
+#include <random>
+
+bool get_obj_shape(const string& name, OBJ_SHAPE& shape) {
+	if(name == "grid") shape = OBJ_SHAPE::GRID;
+	else if(name == "sphere") shape = OBJ_SHAPE::SPHERE;
+	else if(name == "mixed") shape = OBJ_SHAPE::MIXED;
+	else return false;
+	return true;
+}
+
+const char* get_obj_shape_name(const OBJ_SHAPE shape) {
+	switch(shape) {
+		case OBJ_SHAPE::GRID: return "grid";
+		case OBJ_SHAPE::SPHERE: return "sphere";
+		case OBJ_SHAPE::MIXED: return "mixed";
+	}
+	return "";
+}
+
+bool get_obj_normals(const string& name, OBJ_NORMALS& normals) {
+	if(name == "none") normals = OBJ_NORMALS::NONE;
+	else if(name == "face") normals = OBJ_NORMALS::FACE;
+	else if(name == "groups") normals = OBJ_NORMALS::SMOOTHING_GROUPS;
+	else if(name == "mixed") normals = OBJ_NORMALS::MIXED;
+	else return false;
+	return true;
+}
+
+const char* get_obj_normals_name(const OBJ_NORMALS normals) {
+	switch(normals) {
+		case OBJ_NORMALS::NONE: return "none";
+		case OBJ_NORMALS::FACE: return "face";
+		case OBJ_NORMALS::SMOOTHING_GROUPS: return "groups";
+		case OBJ_NORMALS::MIXED: return "mixed";
+	}
+	return "";
+}
+
+// buffered .obj text output
+class obj_text_writer {
+public:
+	obj_text_writer(const string& filename) : file(fopen(filename.c_str(), "wb")) {
+		buffer.reserve(flush_size + 256);
+	}
+	~obj_text_writer() { close(); }
+	
+	bool is_open() const { return (file != nullptr); }
+	
+	template <typename... Args> void print(const char* format, Args... args) {
+		char line[256];
+		const int len = snprintf(line, sizeof(line), format, args...);
+		if(len > 0) buffer.append(line, std::min((size_t)len, sizeof(line) - 1));
+		if(buffer.size() >= flush_size) flush();
+	}
+	
+	bool close() {
+		if(file == nullptr) return false;
+		flush();
+		const bool closed = (fclose(file) == 0 && !failed);
+		file = nullptr;
+		return closed;
+	}
+	
+	size_t get_size() const { return size; }
+	
+protected:
+	static constexpr size_t flush_size = 4 * 1024 * 1024;
+	FILE* file;
+	string buffer;
+	size_t size = 0;
+	bool failed = false;
+	
+	void flush() {
+		if(buffer.empty()) return;
+		if(fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) failed = true;
+		size += buffer.size();
+		buffer.clear();
+	}
+	
+};
+
+bool generate_obj(const string& filename, const obj_generator_options& options, obj_generator_result* result) {
+	obj_text_writer writer(filename);
+	if(!writer.is_open()) {
+		a2e_error("couldn't open/write obj file \"%s\"!", filename);
+		return false;
+	}
+	
+	mt19937 gen(options.seed);
+	uniform_real_distribution<float> jitter_dist(-0.25f, 0.25f);
+	uniform_int_distribution<unsigned int> face_dist(0, 2);
+	obj_generator_result stats;
+	
+	writer.print("# obj2a2m_bench synthetic %s model (%u triangles)\n", get_obj_shape_name(options.shape), options.triangle_count);
+	
+	// (the positions are only kept to compute the face normals)
+	vector<float3> positions;
+	auto add_vertex = [&writer, &stats, &options, &positions](const float x, const float y, const float z) {
+		writer.print("v %.6f %.6f %.6f\n", (double)x, (double)y, (double)z);
+		if(options.normals != OBJ_NORMALS::NONE) positions.emplace_back(x, y, z);
+		stats.vertex_count++;
+	};
+	auto add_coord = [&writer, &stats, &options](const float u, const float v) {
+		if(options.uvw) writer.print("vt %.6f %.6f 0.000000\n", (double)u, (double)v);
+		else writer.print("vt %.6f %.6f\n", (double)u, (double)v);
+		stats.coord_count++;
+	};
+	// writes the "vn" or "s" line of the next face (see OBJ_NORMALS), returns its 1-based normal index (0 if it has none)
+	unsigned int smoothing_group = ~0u;
+	auto add_face_normal = [&writer, &stats, &options, &positions, &smoothing_group](const size_t i0, const size_t i1, const size_t i2) -> size_t {
+		if(options.normals == OBJ_NORMALS::NONE) return 0;
+		if(options.normals == OBJ_NORMALS::FACE || (options.normals == OBJ_NORMALS::MIXED && stats.face_count % 2 == 0)) {
+			const float3& v0 = positions[i0 - 1];
+			const float3 e1 = positions[i1 - 1] - v0, e2 = positions[i2 - 1] - v0;
+			float3 normal(e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x);
+			const float length = sqrtf(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+			normal = (length > 0.0f ? normal * (1.0f / length) : float3(0.0f, 1.0f, 0.0f));
+			writer.print("vn %.6f %.6f %.6f\n", (double)normal.x, (double)normal.y, (double)normal.z);
+			return ++stats.normal_count;
+		}
+		const unsigned int group = (unsigned int)((stats.face_count / 2) % 5);
+		if(group != smoothing_group) {
+			if(group == 0) writer.print("s off\n");
+			else writer.print("s %u\n", group);
+			smoothing_group = group;
+		}
+		return 0;
+	};
+	// corners are 1-based "vertex/coord" index pairs
+	auto add_triangle = [&writer, &stats, &add_face_normal](const size_t (&c0)[2], const size_t (&c1)[2], const size_t (&c2)[2]) {
+		const size_t n = add_face_normal(c0[0], c1[0], c2[0]);
+		if(n == 0) writer.print("f %zu/%zu %zu/%zu %zu/%zu\n", c0[0], c0[1], c1[0], c1[1], c2[0], c2[1]);
+		else writer.print("f %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\n", c0[0], c0[1], n, c1[0], c1[1], n, c2[0], c2[1], n);
+		stats.face_count++;
+		stats.triangle_count++;
+	};
+	auto add_quad = [&writer, &stats, &options, &add_triangle, &add_face_normal](const size_t (&c0)[2], const size_t (&c1)[2],
+																				 const size_t (&c2)[2], const size_t (&c3)[2]) {
+		if(!options.quads) {
+			add_triangle(c0, c1, c2);
+			add_triangle(c0, c2, c3);
+			return;
+		}
+		const size_t n = add_face_normal(c0[0], c1[0], c2[0]);
+		if(n == 0) writer.print("f %zu/%zu %zu/%zu %zu/%zu %zu/%zu\n", c0[0], c0[1], c1[0], c1[1], c2[0], c2[1], c3[0], c3[1]);
+		else {
+			writer.print("f %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\n", c0[0], c0[1], n, c1[0], c1[1], n, c2[0], c2[1], n,
+						 c3[0], c3[1], n);
+		}
+		stats.face_count++;
+		stats.triangle_count += 2;
+	};
+	
+	// starts a new group at the cells cell_count * i / group_count
+	const unsigned int group_count = std::max(options.group_count, 1u);
+	const unsigned int material_count = std::max(options.material_count, 1u);
+	unsigned int next_group = 0;
+	auto start_cell = [&](const size_t cell, const size_t cell_count) {
+		while(next_group < group_count && cell >= (cell_count * next_group) / group_count) {
+			writer.print("g group_%u\n", next_group);
+			writer.print("usemtl material_%u\n", next_group % material_count);
+			next_group++;
+		}
+	};
+	
+	switch(options.shape) {
+		case OBJ_SHAPE::GRID:
+		case OBJ_SHAPE::MIXED: {
+			// (n - 1)^2 cells with two triangles each
+			const size_t cells = std::max((size_t)sqrt((double)options.triangle_count / 2.0), (size_t)1);
+			const size_t n = cells + 1;
+			const bool mixed = (options.shape == OBJ_SHAPE::MIXED);
+			const float scale = 100.0f / (float)cells;
+			for(size_t z = 0; z < n; z++) {
+				for(size_t x = 0; x < n; x++) {
+					add_vertex((float)x * scale - 50.0f, (mixed ? jitter_dist(gen) : 0.0f), (float)z * scale - 50.0f);
+				}
+			}
+			for(size_t z = 0; z < n; z++) {
+				for(size_t x = 0; x < n; x++) {
+					add_coord((float)x / (float)cells, (float)z / (float)cells);
+				}
+			}
+			for(size_t z = 0; z < cells; z++) {
+				for(size_t x = 0; x < cells; x++) {
+					start_cell(z * cells + x, cells * cells);
+					const size_t i0 = z * n + x + 1, i1 = i0 + 1, i2 = i0 + n + 1, i3 = i0 + n;
+					const size_t c0[2] { i0, i0 }, c1[2] { i1, i1 }, c2[2] { i2, i2 }, c3[2] { i3, i3 };
+					switch(mixed ? face_dist(gen) : 0) {
+						case 0: add_quad(c0, c1, c2, c3); break;
+						case 1:
+							add_triangle(c0, c1, c2);
+							add_triangle(c0, c2, c3);
+							break;
+						default:
+							add_triangle(c0, c1, c3);
+							add_triangle(c1, c2, c3);
+							break;
+					}
+				}
+			}
+		}
+		break;
+		case OBJ_SHAPE::SPHERE: {
+			// segments * rings cells: triangles at the poles, quads everywhere else (~ segments^2 triangles)
+			const size_t segments = std::max((size_t)sqrt((double)options.triangle_count), (size_t)4);
+			const size_t rings = std::max(segments / 2, (size_t)2);
+			const float radius = 50.0f;
+			const float pi = 3.14159265358979f;
+			
+			// positions: north pole, (rings - 1) rings of segments vertices, south pole
+			add_vertex(0.0f, radius, 0.0f);
+			for(size_t r = 1; r < rings; r++) {
+				const float theta = (float)r * pi / (float)rings;
+				for(size_t s = 0; s < segments; s++) {
+					const float phi = (float)s * 2.0f * pi / (float)segments;
+					add_vertex(radius * sinf(theta) * cosf(phi), radius * cosf(theta), radius * sinf(theta) * sinf(phi));
+				}
+			}
+			add_vertex(0.0f, -radius, 0.0f);
+			const size_t south_pole = 2 + (rings - 1) * segments;
+			auto position = [&segments](const size_t r, const size_t s) -> size_t {
+				return 2 + (r - 1) * segments + (s % segments);
+			};
+			
+			// texture coordinates: (rings + 1) * (segments + 1), so that the seam and the poles get their own coordinates
+			for(size_t r = 0; r <= rings; r++) {
+				for(size_t s = 0; s <= segments; s++) {
+					add_coord((float)s / (float)segments, 1.0f - (float)r / (float)rings);
+				}
+			}
+			auto tex_coord = [&segments](const size_t r, const size_t s) -> size_t {
+				return r * (segments + 1) + s + 1;
+			};
+			
+			for(size_t r = 0; r < rings; r++) {
+				for(size_t s = 0; s < segments; s++) {
+					start_cell(r * segments + s, rings * segments);
+					if(r == 0) {
+						const size_t c0[2] { 1, tex_coord(0, s) }, c1[2] { position(1, s + 1), tex_coord(1, s + 1) }, c2[2] { position(1, s), tex_coord(1, s) };
+						add_triangle(c0, c1, c2);
+					}
+					else if(r == rings - 1) {
+						const size_t c0[2] { position(r, s), tex_coord(r, s) }, c1[2] { position(r, s + 1), tex_coord(r, s + 1) };
+						const size_t c2[2] { south_pole, tex_coord(rings, s) };
+						add_triangle(c0, c1, c2);
+					}
+					else {
+						const size_t c0[2] { position(r, s), tex_coord(r, s) }, c1[2] { position(r, s + 1), tex_coord(r, s + 1) };
+						const size_t c2[2] { position(r + 1, s + 1), tex_coord(r + 1, s + 1) }, c3[2] { position(r + 1, s), tex_coord(r + 1, s) };
+						add_quad(c0, c1, c2, c3);
+					}
+				}
+			}
+		}
+		break;
+	}
+	
+	if(!writer.close()) {
+		a2e_error("failed to write obj file \"%s\"!", filename);
+		return false;
+	}
+	stats.file_size = writer.get_size();
+	if(result != nullptr) *result = stats;
+	return true;
+}
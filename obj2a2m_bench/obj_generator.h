@@ -0,0 +1,75 @@
+/*
+ *  obj2a2m_bench - obj2a2m benchmarks
+ *  Copyright (C) 2012 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __OBJ2A2M_BENCH_OBJ_GENERATOR_H__
+#define __OBJ2A2M_BENCH_OBJ_GENERATOR_H__
+
+#include <a2e.h>
+
+// shape of a synthetic .obj model
+enum class OBJ_SHAPE : unsigned int {
+	GRID,	// flat n * n vertex grid with one texture coordinate per vertex
+	SPHERE,	// uv sphere, the texture coordinates of the seam and the poles are duplicated (shared positions, different vt)
+	MIXED,	// jittered grid with randomly mixed quad and triangle faces
+};
+
+// normals of a synthetic .obj model
+enum class OBJ_NORMALS : unsigned int {
+	NONE,				// no "vn" or "s" lines
+	FACE,				// one "vn" face normal per face (hard edges: the faces still share their positions and texture coordinates)
+	SMOOTHING_GROUPS,	// no "vn", the faces switch between 4 smoothing groups ("s 1" - "s 4") and "s off" every 2 faces
+	MIXED,				// alternating FACE and SMOOTHING_GROUPS faces
+};
+
+struct obj_generator_options {
+	OBJ_SHAPE shape = OBJ_SHAPE::GRID;
+	// approximate amount of triangles (after splitting the quads)
+	size_t triangle_count = 1000000;
+	// the faces are split into this many "g" groups, each one using one of material_count materials ("usemtl")
+	unsigned int group_count = 1;
+	unsigned int material_count = 8;
+	// write quad faces where the shape has quads (otherwise two triangles)
+	bool quads = true;
+	// write "vt u v w" instead of "vt u v"
+	bool uvw = false;
+	OBJ_NORMALS normals = OBJ_NORMALS::NONE;
+	unsigned int seed = 0x0B1;
+};
+
+// what was written by generate_obj
+struct obj_generator_result {
+	size_t file_size = 0;
+	size_t vertex_count = 0;
+	size_t coord_count = 0;
+	size_t normal_count = 0;
+	size_t face_count = 0;
+	size_t triangle_count = 0;
+};
+
+// parses a shape name ("grid", "sphere" or "mixed"), returns false if it is unknown
+bool get_obj_shape(const string& name, OBJ_SHAPE& shape);
+const char* get_obj_shape_name(const OBJ_SHAPE shape);
+
+// parses a normals name ("none", "face", "groups" or "mixed"), returns false if it is unknown
+bool get_obj_normals(const string& name, OBJ_NORMALS& normals);
+const char* get_obj_normals_name(const OBJ_NORMALS normals);
+
+// writes a synthetic .obj file, returns false if it couldn't be written
+bool generate_obj(const string& filename, const obj_generator_options& options, obj_generator_result* result = nullptr);
+
+#endif
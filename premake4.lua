@@ -197,12 +197,17 @@ project "obj2a2m"
 	
 	-- the same for all
 	includedirs { "obj2a2m/" }
+	-- peak memory statistics
+	if(os.is("windows")) then
+		links { "psapi" }
+	end
 	
 	-- configs
 	configuration "Debug"
 		targetname "obj2a2md"
 		defines { "DEBUG", "A2E_DEBUG" }
 		flags { "Symbols" }
+		links { "z" }
 		if(not os.is("windows") or win_unixenv) then
 			buildoptions { " -gdwarf-2" }
 		end
@@ -211,6 +216,7 @@ project "obj2a2m"
 		targetname "obj2a2m"
 		defines { "NDEBUG" }
 		flags { "Optimize" }
+		links { "z" }
 		if(not os.is("windows") or win_unixenv) then
 			buildoptions { "-ffast-math -Os" }
 		end
@@ -240,6 +246,40 @@ project "kernelcacher"
 		defines { "NDEBUG", "A2E_CUDA_CL" }
 		flags { "Optimize" }
 		links { "z", "SDL2" }
+		if(not os.is("windows") or win_unixenv) then
+			buildoptions { "-ffast-math -Os" }
+		end
+
+project "obj2a2m_bench"
+	targetname "obj2a2m_bench"
+	kind "ConsoleApp"
+	language "C++"
+	files { "obj2a2m_bench/**.h", "obj2a2m_bench/**.cpp", "obj2a2m/**.h", "obj2a2m/**.cpp" }
+	excludes { "obj2a2m/obj2a2m.cpp" }
+	targetdir "bin"
+	
+	-- the same for all
+	includedirs { "obj2a2m_bench/", "obj2a2m/" }
+	-- peak memory statistics
+	if(os.is("windows")) then
+		links { "psapi" }
+	end
+	
+	-- configs
+	configuration "Debug"
+		targetname "obj2a2m_benchd"
+		defines { "DEBUG", "A2E_DEBUG" }
+		flags { "Symbols" }
+		links { "z" }
+		if(not os.is("windows") or win_unixenv) then
+			buildoptions { " -gdwarf-2" }
+		end
+
+	configuration "Release"
+		targetname "obj2a2m_bench"
+		defines { "NDEBUG" }
+		flags { "Optimize" }
+		links { "z" }
 		if(not os.is("windows") or win_unixenv) then
 			buildoptions { "-ffast-math -Os" }
 		end
\ No newline at end of file